@@ -1,17 +1,59 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
 layout(location = 0) in vec3 inPos;
 layout(location = 1) in vec3 inColor;
 
 layout(location = 0) out vec3 vColor;
 
+// Row-major 3x4 affine model matrix; matches InstanceData in vk_mvp.cpp.
+struct Instance
+{
+    vec4 model_rows[3];
+};
+
+// Matches MaterialData in vk_mvp.cpp.
+struct Material
+{
+    vec4 tint;
+};
+
+// The bindless heap's storage buffers (BindlessHeap::k_buffer_binding), viewed as each type this
+// shader reads; the push constants say which slot holds what.
+layout(std430, set = 0, binding = 0) readonly buffer Instances
+{
+    Instance instances[];
+} instance_buffers[];
+
+// Instance indices that survived cull.comp, compacted; only read when pc.culled is set.
+layout(std430, set = 0, binding = 0) readonly buffer Visible
+{
+    uint visible[];
+} visible_buffers[];
+
+layout(std430, set = 0, binding = 0) readonly buffer Materials
+{
+    Material materials[];
+} material_buffers[];
+
 layout(push_constant) uniform Push
 {
-    mat4 mvp;
+    mat4 view_proj;
+    uint culled;
+    uint instance_slot;
+    uint visible_slot;
+    uint material_slot;
+    uint material_count; // instance i uses material i % material_count
 } pc;
 
 void main()
 {
-    vColor = inColor;
-    gl_Position = pc.mvp * vec4(inPos, 1.0);
+    const uint index = (pc.culled != 0u) ? visible_buffers[pc.visible_slot].visible[gl_InstanceIndex]
+                                         : uint(gl_InstanceIndex);
+    const Instance inst = instance_buffers[pc.instance_slot].instances[index];
+    const vec4 p = vec4(inPos, 1.0);
+    const vec3 world = vec3(dot(inst.model_rows[0], p), dot(inst.model_rows[1], p), dot(inst.model_rows[2], p));
+
+    vColor = inColor * material_buffers[pc.material_slot].materials[index % pc.material_count].tint.rgb;
+    gl_Position = pc.view_proj * vec4(world, 1.0);
 }
@@ -0,0 +1,63 @@
+# Generates a header with every compiled shader as a constexpr uint32_t array.
+#
+#   cmake -DSPIRV_FILES="a.spv|b.spv" -DOUTPUT=embedded_spirv.hpp -P embed_spirv.cmake
+#
+# SPIRV_FILES is '|' separated because ';' does not survive add_custom_command arguments.
+
+string(REPLACE "|" ";" SPIRV_FILES "${SPIRV_FILES}")
+
+set(ARRAYS "")
+set(ENTRIES "")
+foreach(SPV IN LISTS SPIRV_FILES)
+  get_filename_component(SPV_NAME ${SPV} NAME)
+  string(REGEX REPLACE "\\.spv$" "" SPV_ID "${SPV_NAME}")
+  string(MAKE_C_IDENTIFIER "${SPV_ID}" SPV_ID)
+
+  file(READ ${SPV} HEX HEX)
+  string(LENGTH "${HEX}" HEX_LEN)
+  math(EXPR HEX_REM "${HEX_LEN} % 8")
+  if (HEX_LEN EQUAL 0 OR NOT HEX_REM EQUAL 0)
+    message(FATAL_ERROR "Not a SPIR-V module (size not a multiple of 4): ${SPV}")
+  endif()
+
+  # SPIR-V is little-endian on disk: bytes b0 b1 b2 b3 form the word 0xb3b2b1b0.
+  string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1u," WORDS "${HEX}")
+  # Eight words per line; CMake regexes have no {n} quantifier.
+  set(W "0x[0-9a-f]+u,")
+  string(REGEX REPLACE "(${W}${W}${W}${W}${W}${W}${W}${W})" "\\1\n    " WORDS "${WORDS}")
+  string(REPLACE "u,0x" "u, 0x" WORDS "${WORDS}")
+  string(STRIP "${WORDS}" WORDS)
+
+  string(APPEND ARRAYS "inline constexpr std::uint32_t k_${SPV_ID}[] = {\n    ${WORDS}\n};\n\n")
+  string(APPEND ENTRIES "    Entry{\"${SPV_NAME}\", k_${SPV_ID}},\n")
+endforeach()
+
+set(CONTENT "#pragma once
+
+// Generated by cmake/embed_spirv.cmake; do not edit.
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace ds_pba::embedded_spirv {
+
+${ARRAYS}struct Entry {
+    std::string_view name;
+    std::span<const std::uint32_t> words;
+};
+
+inline constexpr Entry k_entries[] = {
+${ENTRIES}};
+
+} // namespace ds_pba::embedded_spirv
+")
+
+# Only touch the file when the contents change, so dependents are not rebuilt needlessly.
+if (EXISTS ${OUTPUT})
+  file(READ ${OUTPUT} OLD_CONTENT)
+  if (OLD_CONTENT STREQUAL CONTENT)
+    return()
+  endif()
+endif()
+file(WRITE ${OUTPUT} "${CONTENT}")
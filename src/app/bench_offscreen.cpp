@@ -0,0 +1,269 @@
+#include "pba/gfx/frame_stats.hpp"
+#include "pba/gfx/vk_mvp.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstdio>
+#include <exception>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+enum class OutputFormat : std::uint8_t { csv, json };
+
+struct Summary {
+    std::size_t samples{0};
+    float min{0.0f};
+    float avg{0.0f};
+    float p50{0.0f};
+    float p90{0.0f};
+    float p99{0.0f};
+    float max{0.0f};
+};
+
+[[nodiscard]] Summary summarize(const std::vector<float> &samples) {
+    // A window as large as the run keeps every sample.
+    ds_pba::RollingStats stats{samples.empty() ? 1u : samples.size()};
+    for (float s : samples) {
+        stats.push(s);
+    }
+
+    Summary out{};
+    out.samples = stats.size();
+    out.min = stats.min();
+    out.avg = stats.avg();
+    out.p50 = stats.percentile(0.50f);
+    out.p90 = stats.percentile(0.90f);
+    out.p99 = stats.percentile(0.99f);
+    out.max = stats.max();
+    return out;
+}
+
+[[nodiscard]] std::optional<ds_pba::CaptureFormat> parse_capture_format(std::string_view name) {
+    constexpr std::array<ds_pba::CaptureFormat, 3> k_formats = {ds_pba::CaptureFormat::raw, ds_pba::CaptureFormat::png,
+                                                                ds_pba::CaptureFormat::y4m};
+    for (ds_pba::CaptureFormat f : k_formats) {
+        if (name == ds_pba::to_string(f)) {
+            return f;
+        }
+    }
+    return std::nullopt;
+}
+
+[[nodiscard]] std::optional<std::uint32_t> parse_u32(std::string_view v) {
+    std::uint32_t n = 0;
+    const auto [ptr, ec] = std::from_chars(v.data(), v.data() + v.size(), n);
+    if (ec != std::errc{} || ptr != v.data() + v.size()) {
+        return std::nullopt;
+    }
+    return n;
+}
+
+[[nodiscard]] std::optional<double> parse_seconds(std::string_view v) {
+    double d = 0.0;
+    const auto [ptr, ec] = std::from_chars(v.data(), v.data() + v.size(), d);
+    if (ec != std::errc{} || ptr != v.data() + v.size() || d < 0.0) {
+        return std::nullopt;
+    }
+    return d;
+}
+
+// Splits "1920x1080".
+[[nodiscard]] bool parse_resolution(std::string_view v, std::uint32_t &w, std::uint32_t &h) {
+    const std::size_t x = v.find('x');
+    if (x == std::string_view::npos) {
+        return false;
+    }
+    const std::optional<std::uint32_t> pw = parse_u32(v.substr(0, x));
+    const std::optional<std::uint32_t> ph = parse_u32(v.substr(x + 1));
+    if (!pw.has_value() || !ph.has_value()) {
+        return false;
+    }
+    w = *pw;
+    h = *ph;
+    return true;
+}
+
+// The device name comes from the driver and may contain quotes or backslashes.
+[[nodiscard]] std::string json_escape(std::string_view s) {
+    std::string out{};
+    out.reserve(s.size());
+    for (const char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20u) {
+            std::array<char, 8> buf{};
+            std::snprintf(buf.data(), buf.size(), "\\u%04x", static_cast<unsigned>(c));
+            out += buf.data();
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+// A quoted CSV field doubles its quotes.
+[[nodiscard]] std::string csv_escape(std::string_view s) {
+    std::string out{};
+    out.reserve(s.size());
+    for (const char c : s) {
+        if (c == '"') {
+            out += '"';
+        }
+        out += c;
+    }
+    return out;
+}
+
+void write_csv(std::FILE *out, const ds_pba::BenchmarkConfig &cfg, const ds_pba::BenchmarkResult &r) {
+    std::fprintf(out, "metric,device,width,height,viewports,parallel_recording,instances,culling,geometry,frames,samples,min_ms,avg_ms,p50_ms,p90_ms,p99_ms,max_ms\n");
+    const std::string device = csv_escape(r.device_name);
+    const auto row = [&](const char *metric, const Summary &s) {
+        std::fprintf(out, "%s,\"%s\",%u,%u,%u,%d,%u,%d,%s,%u,%zu,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n", metric,
+                     device.c_str(), cfg.width, cfg.height, r.viewports, r.parallel_recording ? 1 : 0,
+                     cfg.instance_count, cfg.gpu_culling ? 1 : 0, r.mesh_shaders ? "mesh" : "vertex", r.frames,
+                     s.samples, static_cast<double>(s.min), static_cast<double>(s.avg), static_cast<double>(s.p50),
+                     static_cast<double>(s.p90), static_cast<double>(s.p99), static_cast<double>(s.max));
+    };
+    row("cpu_frame", summarize(r.cpu_frame_ms));
+    row("gpu_frame", summarize(r.gpu_frame_ms));
+    row("cpu_wait", summarize(r.cpu_wait_ms));
+}
+
+void write_json(std::FILE *out, const ds_pba::BenchmarkConfig &cfg, const ds_pba::BenchmarkResult &r) {
+    const auto block = [out](const char *name, const Summary &s, const char *trailer) {
+        std::fprintf(out,
+                     "  \"%s\": {\"samples\": %zu, \"min_ms\": %.4f, \"avg_ms\": %.4f, \"p50_ms\": %.4f, "
+                     "\"p90_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f}%s\n",
+                     name, s.samples, static_cast<double>(s.min), static_cast<double>(s.avg),
+                     static_cast<double>(s.p50), static_cast<double>(s.p90), static_cast<double>(s.p99),
+                     static_cast<double>(s.max), trailer);
+    };
+
+    std::fprintf(out, "{\n");
+    std::fprintf(out, "  \"device\": \"%s\",\n", json_escape(r.device_name).c_str());
+    std::fprintf(out, "  \"width\": %u,\n  \"height\": %u,\n  \"viewports\": %u,\n", cfg.width, cfg.height,
+                 r.viewports);
+    std::fprintf(out, "  \"parallel_recording\": %s,\n", r.parallel_recording ? "true" : "false");
+    std::fprintf(out, "  \"instances\": %u,\n  \"culling\": %s,\n", cfg.instance_count,
+                 cfg.gpu_culling ? "true" : "false");
+    std::fprintf(out, "  \"geometry\": \"%s\",\n", r.mesh_shaders ? "mesh" : "vertex");
+    std::fprintf(out, "  \"frames\": %u,\n  \"elapsed_s\": %.4f,\n", r.frames, r.elapsed_s);
+    block("cpu_frame", summarize(r.cpu_frame_ms), ",");
+    block("gpu_frame", summarize(r.gpu_frame_ms), ",");
+    block("cpu_wait", summarize(r.cpu_wait_ms), "");
+    std::fprintf(out, "}\n");
+}
+
+void print_usage(const char *exe) {
+    std::fprintf(stderr,
+                 "usage: %s [--resolution WxH] [--instances N] [--frames N] [--seconds S] [--warmup N]\n"
+                 "          [--frames-in-flight 1|2|3] [--max-latency N] [--record-threads N] [--msaa N] [--no-cull]\n"
+                 "          [--mesh FILE] [--compact-vertices] [--no-mesh-shaders] [--capture raw|png|y4m]\n"
+                 "          [--viewports 1-6] [--format csv|json] [--out FILE] [--trace FILE]\n",
+                 exe);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    ds_pba::VulkanMvpOptions options{};
+    ds_pba::BenchmarkConfig config{};
+    OutputFormat format = OutputFormat::csv;
+    std::string out_path{};
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        const bool has_value = (i + 1) < argc;
+        bool ok = true;
+
+        if (arg == "--resolution" && has_value) {
+            ok = parse_resolution(argv[++i], config.width, config.height);
+        } else if ((arg == "--instances" || arg == "--frames" || arg == "--warmup" ||
+                    arg == "--frames-in-flight" || arg == "--max-latency" || arg == "--record-threads" ||
+                    arg == "--msaa" || arg == "--viewports") &&
+                   has_value) {
+            const std::optional<std::uint32_t> n = parse_u32(argv[++i]);
+            ok = n.has_value();
+            if (ok) {
+                std::uint32_t &dst = (arg == "--instances")          ? config.instance_count
+                                     : (arg == "--frames")           ? config.frame_count
+                                     : (arg == "--warmup")           ? config.warmup_frames
+                                     : (arg == "--frames-in-flight") ? options.frames_in_flight
+                                     : (arg == "--max-latency")      ? options.max_frame_latency
+                                     : (arg == "--msaa")             ? options.msaa_samples
+                                     : (arg == "--viewports")        ? options.viewports
+                                                                     : options.record_threads;
+                dst = *n;
+            }
+        } else if (arg == "--seconds" && has_value) {
+            const std::optional<double> s = parse_seconds(argv[++i]);
+            ok = s.has_value();
+            if (ok) {
+                config.duration_s = *s;
+            }
+        } else if (arg == "--no-cull") {
+            config.gpu_culling = false;
+        } else if (arg == "--mesh" && has_value) {
+            options.mesh_path = argv[++i];
+        } else if (arg == "--compact-vertices") {
+            options.compact_vertices = true;
+        } else if (arg == "--no-mesh-shaders") {
+            options.mesh_shaders = false;
+        } else if (arg == "--capture" && has_value) {
+            const std::optional<ds_pba::CaptureFormat> f = parse_capture_format(argv[++i]);
+            ok = f.has_value();
+            if (ok) {
+                options.capture = true;
+                options.capture_format = *f;
+            }
+        } else if (arg == "--format" && has_value) {
+            const std::string_view f{argv[++i]};
+            ok = (f == "csv" || f == "json");
+            format = (f == "json") ? OutputFormat::json : OutputFormat::csv;
+        } else if (arg == "--out" && has_value) {
+            out_path = argv[++i];
+        } else if (arg == "--trace" && has_value) {
+            options.trace_path = argv[++i];
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    try {
+        ds_pba::VulkanMvp app{options};
+        const ds_pba::BenchmarkResult result = app.run_benchmark(config);
+
+        std::FILE *out = stdout;
+        if (!out_path.empty()) {
+            out = std::fopen(out_path.c_str(), "w");
+            if (!out) {
+                std::fprintf(stderr, "bench_offscreen: cannot open %s\n", out_path.c_str());
+                return 1;
+            }
+        }
+
+        if (format == OutputFormat::json) {
+            write_json(out, config, result);
+        } else {
+            write_csv(out, config, result);
+        }
+
+        if (out != stdout) {
+            std::fclose(out);
+        }
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "bench_offscreen: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,194 @@
+#include "pba/core/job_system.hpp"
+#include "pba/core/transform_batch.hpp"
+#include "pba/gfx/frame_stats.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr float k_spacing = 1.6f;
+constexpr float k_time = 1.25f;
+constexpr std::uint32_t k_grain = 4096;
+
+[[nodiscard]] std::optional<std::uint32_t> parse_u32(std::string_view v) {
+    std::uint32_t n = 0;
+    const auto [ptr, ec] = std::from_chars(v.data(), v.data() + v.size(), n);
+    if (ec != std::errc{} || ptr != v.data() + v.size()) {
+        return std::nullopt;
+    }
+    return n;
+}
+
+// The renderer's instance grid and animation.
+struct Scene {
+    std::uint32_t side{1};
+    float half{0.0f};
+    glm::mat4 fit{1.0f};
+
+    explicit Scene(std::uint32_t n) {
+        while (side * side * side < n) {
+            ++side;
+        }
+        half = 0.5f * static_cast<float>(side - 1u) * k_spacing;
+        // A mesh fit like the one --mesh applies, so `post` is not the identity.
+        fit = glm::scale(glm::mat4(1.0f), glm::vec3(0.5f)) *
+              glm::translate(glm::mat4(1.0f), glm::vec3(0.1f, -0.2f, 0.3f));
+    }
+
+    [[nodiscard]] glm::vec3 position(std::uint32_t i) const {
+        return glm::vec3(static_cast<float>(i % side), static_cast<float>((i / side) % side),
+                         static_cast<float>(i / (side * side))) *
+                   k_spacing -
+               glm::vec3(half);
+    }
+
+    [[nodiscard]] static float angle(std::uint32_t i) { return k_time + 0.37f * static_cast<float>(i); }
+};
+
+// What update_instances() did before the batched kernel: one glm matrix chain per object.
+void glm_path(const Scene &s, std::uint32_t first, std::uint32_t last, float *out) {
+    for (std::uint32_t i = first; i < last; ++i) {
+        const float ti = Scene::angle(i);
+        const glm::mat4 m = glm::translate(glm::mat4(1.0f), s.position(i)) *
+                            glm::rotate(glm::mat4(1.0f), ti, glm::vec3(0.0f, 0.0f, 1.0f)) *
+                            glm::rotate(glm::mat4(1.0f), 0.6f * ti, glm::vec3(0.0f, 1.0f, 0.0f)) * s.fit;
+        float *o = out + std::size_t{12} * i;
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 4; ++c) {
+                o[4 * r + c] = m[c][r];
+            }
+        }
+    }
+}
+
+// What update_instances() does now: animate the SoA rotations, then run the kernel.
+void soa_path(const Scene &s, ds_pba::TransformBatch &tb, ds_pba::TransformKernel kernel, std::uint32_t first,
+              std::uint32_t last, float *out) {
+    for (std::uint32_t i = first; i < last; ++i) {
+        const float ti = Scene::angle(i);
+        const float sa = std::sin(0.5f * ti), ca = std::cos(0.5f * ti);
+        const float sb = std::sin(0.3f * ti), cb = std::cos(0.3f * ti);
+        tb.qx[i] = -sa * sb;
+        tb.qy[i] = ca * sb;
+        tb.qz[i] = sa * cb;
+        tb.qw[i] = ca * cb;
+    }
+    ds_pba::compose_transforms(tb, first, last, s.fit, out, kernel);
+}
+
+struct Run {
+    const char *path;
+    const char *kernel;
+    std::function<void(std::uint32_t, std::uint32_t)> body;
+};
+
+void print_usage(const char *exe) {
+    std::fprintf(stderr, "usage: %s [--instances N] [--iterations N] [--threads N]\n", exe);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::uint32_t instances = 1'000'000;
+    std::uint32_t iterations = 50;
+    std::uint32_t threads = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        const std::optional<std::uint32_t> n = (i + 1) < argc ? parse_u32(argv[i + 1]) : std::nullopt;
+        if ((arg != "--instances" && arg != "--iterations" && arg != "--threads") || !n.has_value()) {
+            print_usage(argv[0]);
+            return 2;
+        }
+        std::uint32_t &dst = (arg == "--instances") ? instances : (arg == "--iterations") ? iterations : threads;
+        dst = *n;
+        ++i;
+    }
+    if (instances == 0u || iterations == 0u) {
+        print_usage(argv[0]);
+        return 2;
+    }
+    if (threads == 0u) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    const Scene scene{instances};
+    ds_pba::TransformBatch batch{};
+    batch.resize(instances);
+    for (std::uint32_t i = 0; i < instances; ++i) {
+        const glm::vec3 p = scene.position(i);
+        batch.px[i] = p.x;
+        batch.py[i] = p.y;
+        batch.pz[i] = p.z;
+        batch.sx[i] = 1.0f;
+        batch.sy[i] = 1.0f;
+        batch.sz[i] = 1.0f;
+    }
+
+    std::vector<float> reference(std::size_t{12} * instances);
+    std::vector<float> out(reference.size());
+    glm_path(scene, 0, instances, reference.data());
+
+    std::vector<Run> runs{};
+    runs.push_back({"glm", "scalar", [&](std::uint32_t b, std::uint32_t e) { glm_path(scene, b, e, out.data()); }});
+    std::vector<ds_pba::TransformKernel> kernels{ds_pba::TransformKernel::scalar};
+    if (ds_pba::best_transform_kernel() != ds_pba::TransformKernel::scalar) {
+        kernels.push_back(ds_pba::best_transform_kernel());
+    }
+    for (ds_pba::TransformKernel k : kernels) {
+        runs.push_back({"soa", ds_pba::to_string(k),
+                        [&, k](std::uint32_t b, std::uint32_t e) { soa_path(scene, batch, k, b, e, out.data()); }});
+    }
+    // The kernel alone, on the rotations the soa runs left behind.
+    for (ds_pba::TransformKernel k : kernels) {
+        runs.push_back({"compose", ds_pba::to_string(k), [&, k](std::uint32_t b, std::uint32_t e) {
+                            ds_pba::compose_transforms(batch, b, e, scene.fit, out.data(), k);
+                        }});
+    }
+
+    ds_pba::JobSystem jobs{threads};
+    std::vector<std::uint32_t> thread_counts{1u};
+    if (threads > 1u) {
+        thread_counts.push_back(threads);
+    }
+
+    std::printf("path,kernel,instances,threads,samples,min_ms,avg_ms,p50_ms,p99_ms,max_ms,max_abs_err\n");
+    for (const Run &run : runs) {
+        for (std::uint32_t t : thread_counts) {
+            std::fill(out.begin(), out.end(), 0.0f);
+            ds_pba::RollingStats stats{iterations};
+            for (std::uint32_t it = 0; it < iterations; ++it) {
+                const auto begin = std::chrono::steady_clock::now();
+                if (t == 1u) {
+                    run.body(0, instances);
+                } else {
+                    jobs.parallel_for(0, instances, k_grain, run.body);
+                }
+                stats.push(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - begin).count());
+            }
+
+            float err = 0.0f;
+            for (std::size_t k = 0; k < out.size(); ++k) {
+                err = std::max(err, std::fabs(out[k] - reference[k]));
+            }
+            std::printf("%s,%s,%u,%u,%zu,%.4f,%.4f,%.4f,%.4f,%.4f,%.3g\n", run.path, run.kernel, instances, t,
+                        stats.size(), static_cast<double>(stats.min()), static_cast<double>(stats.avg()),
+                        static_cast<double>(stats.percentile(0.50f)), static_cast<double>(stats.percentile(0.99f)),
+                        static_cast<double>(stats.max()), static_cast<double>(err));
+        }
+    }
+    return 0;
+}
@@ -1,7 +1,169 @@
 #include "pba/gfx/vk_mvp.hpp"
 
-int main() {
-    ds_pba::VulkanMvp app{};
+#include <array>
+#include <charconv>
+#include <cstdio>
+#include <optional>
+#include <string_view>
+
+namespace {
+
+[[nodiscard]] std::optional<ds_pba::PresentPolicy> parse_present_policy(std::string_view name) {
+    constexpr std::array<ds_pba::PresentPolicy, 4> k_policies = {
+        ds_pba::PresentPolicy::low_latency, ds_pba::PresentPolicy::vsync,
+        ds_pba::PresentPolicy::adaptive_vsync, ds_pba::PresentPolicy::uncapped};
+    for (ds_pba::PresentPolicy p : k_policies) {
+        if (name == ds_pba::to_string(p)) {
+            return p;
+        }
+    }
+    return std::nullopt;
+}
+
+[[nodiscard]] std::optional<ds_pba::FramePacing> parse_frame_pacing(std::string_view name) {
+    constexpr std::array<ds_pba::FramePacing, 2> k_pacings = {ds_pba::FramePacing::late, ds_pba::FramePacing::early};
+    for (ds_pba::FramePacing p : k_pacings) {
+        if (name == ds_pba::to_string(p)) {
+            return p;
+        }
+    }
+    return std::nullopt;
+}
+
+[[nodiscard]] std::optional<ds_pba::CaptureFormat> parse_capture_format(std::string_view name) {
+    constexpr std::array<ds_pba::CaptureFormat, 3> k_formats = {ds_pba::CaptureFormat::raw, ds_pba::CaptureFormat::png,
+                                                                ds_pba::CaptureFormat::y4m};
+    for (ds_pba::CaptureFormat f : k_formats) {
+        if (name == ds_pba::to_string(f)) {
+            return f;
+        }
+    }
+    return std::nullopt;
+}
+
+[[nodiscard]] std::optional<std::uint32_t> parse_u32(std::string_view v) {
+    std::uint32_t n = 0;
+    const auto [ptr, ec] = std::from_chars(v.data(), v.data() + v.size(), n);
+    if (ec != std::errc{} || ptr != v.data() + v.size()) {
+        return std::nullopt;
+    }
+    return n;
+}
+
+[[nodiscard]] std::optional<float> parse_ms(std::string_view v) {
+    float ms = 0.0f;
+    const auto [ptr, ec] = std::from_chars(v.data(), v.data() + v.size(), ms);
+    if (ec != std::errc{} || ptr != v.data() + v.size() || ms < 0.0f) {
+        return std::nullopt;
+    }
+    return ms;
+}
+
+void print_usage(const char *exe) {
+    std::fprintf(stderr,
+                 "usage: %s [--frames-in-flight 1|2|3] "
+                 "[--present low-latency|vsync|adaptive-vsync|uncapped] [--mesh FILE] [--compact-vertices] "
+                 "[--no-mesh-shaders] "
+                 "[--record-threads N] [--viewports 1-6] [--pacing late|early] [--max-latency N] [--low-latency] "
+                 "[--msaa 1|2|4|8] [--dynamic-res MS] [--paused] [--always-render] [--capture raw|png|y4m] "
+                 "[--trace FILE]\n",
+                 exe);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    ds_pba::VulkanMvpOptions options{};
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        const bool has_value = (i + 1) < argc;
+
+        if (arg == "--frames-in-flight" && has_value) {
+            const std::optional<std::uint32_t> n = parse_u32(argv[++i]);
+            if (!n.has_value()) {
+                print_usage(argv[0]);
+                return 2;
+            }
+            options.frames_in_flight = *n;
+        } else if (arg == "--record-threads" && has_value) {
+            const std::optional<std::uint32_t> n = parse_u32(argv[++i]);
+            if (!n.has_value()) {
+                print_usage(argv[0]);
+                return 2;
+            }
+            options.record_threads = *n;
+        } else if (arg == "--viewports" && has_value) {
+            const std::optional<std::uint32_t> n = parse_u32(argv[++i]);
+            if (!n.has_value()) {
+                print_usage(argv[0]);
+                return 2;
+            }
+            options.viewports = *n;
+        } else if (arg == "--max-latency" && has_value) {
+            const std::optional<std::uint32_t> n = parse_u32(argv[++i]);
+            if (!n.has_value()) {
+                print_usage(argv[0]);
+                return 2;
+            }
+            options.max_frame_latency = *n;
+        } else if (arg == "--msaa" && has_value) {
+            const std::optional<std::uint32_t> n = parse_u32(argv[++i]);
+            if (!n.has_value()) {
+                print_usage(argv[0]);
+                return 2;
+            }
+            options.msaa_samples = *n;
+        } else if (arg == "--dynamic-res" && has_value) {
+            const std::optional<float> ms = parse_ms(argv[++i]);
+            if (!ms.has_value()) {
+                print_usage(argv[0]);
+                return 2;
+            }
+            options.dynamic_resolution_ms = *ms;
+        } else if (arg == "--pacing" && has_value) {
+            const std::optional<ds_pba::FramePacing> p = parse_frame_pacing(argv[++i]);
+            if (!p.has_value()) {
+                print_usage(argv[0]);
+                return 2;
+            }
+            options.frame_pacing = *p;
+        } else if (arg == "--present" && has_value) {
+            const std::optional<ds_pba::PresentPolicy> p = parse_present_policy(argv[++i]);
+            if (!p.has_value()) {
+                print_usage(argv[0]);
+                return 2;
+            }
+            options.present_policy = *p;
+        } else if (arg == "--mesh" && has_value) {
+            options.mesh_path = argv[++i];
+        } else if (arg == "--compact-vertices") {
+            options.compact_vertices = true;
+        } else if (arg == "--no-mesh-shaders") {
+            options.mesh_shaders = false;
+        } else if (arg == "--low-latency") {
+            options.low_latency = true;
+        } else if (arg == "--paused") {
+            options.start_paused = true;
+        } else if (arg == "--always-render") {
+            options.on_demand_render = false;
+        } else if (arg == "--capture" && has_value) {
+            const std::optional<ds_pba::CaptureFormat> f = parse_capture_format(argv[++i]);
+            if (!f.has_value()) {
+                print_usage(argv[0]);
+                return 2;
+            }
+            options.capture = true;
+            options.capture_format = *f;
+        } else if (arg == "--trace" && has_value) {
+            options.trace_path = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    ds_pba::VulkanMvp app{options};
     app.run();
     return 0;
 }
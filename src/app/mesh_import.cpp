@@ -0,0 +1,27 @@
+#include "pba/asset/gltf_import.hpp"
+
+#include <cstdio>
+#include <exception>
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: %s INPUT.gltf|INPUT.glb OUTPUT.pbamesh\n", argv[0]);
+        return 2;
+    }
+
+    try {
+        const ds_pba::GltfImportStats stats = ds_pba::import_gltf(argv[1], argv[2]);
+        std::printf("%s: %u primitive%s, %llu vertices, %llu triangles", argv[2], stats.primitives,
+                    stats.primitives == 1u ? "" : "s", static_cast<unsigned long long>(stats.vertices),
+                    static_cast<unsigned long long>(stats.indices / 3u));
+        if (stats.skipped_primitives != 0u) {
+            std::printf(" (%u point/line primitive%s skipped)", stats.skipped_primitives,
+                        stats.skipped_primitives == 1u ? "" : "s");
+        }
+        std::printf("\n");
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "mesh_import: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
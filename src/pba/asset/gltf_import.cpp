@@ -0,0 +1,826 @@
+#include "pba/asset/gltf_import.hpp"
+
+#include "pba/asset/mapped_file.hpp"
+#include "pba/asset/mesh_file.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ds_pba {
+namespace {
+
+[[noreturn]] void fail(const std::string &why) {
+    throw std::runtime_error("glTF import: " + why);
+}
+
+struct JsonMember;
+
+// Just enough of a JSON DOM for the glTF document; the bulk data lives in the buffers.
+struct Json {
+    enum class Type : std::uint8_t { null, boolean, number, string, array, object };
+
+    Type type{Type::null};
+    bool boolean{false};
+    double number{0.0};
+    std::string string{};
+    std::vector<Json> array{};
+    std::vector<JsonMember> object{};
+
+    // nullptr unless this is an object with `key`.
+    [[nodiscard]] const Json *find(std::string_view key) const noexcept;
+};
+
+struct JsonMember {
+    std::string key;
+    Json value;
+};
+
+const Json *Json::find(std::string_view key) const noexcept {
+    for (const JsonMember &m : object) {
+        if (m.key == key) {
+            return &m.value;
+        }
+    }
+    return nullptr;
+}
+
+class JsonParser {
+public:
+    explicit JsonParser(std::string_view text) : text_{text} {}
+
+    [[nodiscard]] Json parse() {
+        // A UTF-8 byte order mark is tolerated.
+        (void)literal("\xEF\xBB\xBF");
+        Json root = value(0);
+        skip_space();
+        if (pos_ != text_.size()) {
+            error("trailing characters");
+        }
+        return root;
+    }
+
+private:
+    static constexpr int k_max_depth = 128;
+
+    [[noreturn]] void error(const char *why) const {
+        fail(std::string{"JSON "} + why + " at offset " + std::to_string(pos_));
+    }
+
+    void skip_space() noexcept {
+        while (pos_ < text_.size() &&
+               (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' || text_[pos_] == '\r')) {
+            ++pos_;
+        }
+    }
+
+    [[nodiscard]] bool consume(char c) noexcept {
+        skip_space();
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) {
+            error("syntax error");
+        }
+    }
+
+    [[nodiscard]] bool literal(std::string_view word) noexcept {
+        if (text_.substr(pos_, word.size()) == word) {
+            pos_ += word.size();
+            return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] Json value(int depth) {
+        if (depth > k_max_depth) {
+            error("nested too deeply");
+        }
+        skip_space();
+        if (pos_ >= text_.size()) {
+            error("unexpected end");
+        }
+
+        Json v{};
+        const char c = text_[pos_];
+        if (c == '{') {
+            ++pos_;
+            v.type = Json::Type::object;
+            if (consume('}')) {
+                return v;
+            }
+            do {
+                skip_space();
+                std::string key = string_literal();
+                expect(':');
+                v.object.push_back(JsonMember{std::move(key), value(depth + 1)});
+            } while (consume(','));
+            expect('}');
+        } else if (c == '[') {
+            ++pos_;
+            v.type = Json::Type::array;
+            if (consume(']')) {
+                return v;
+            }
+            do {
+                v.array.push_back(value(depth + 1));
+            } while (consume(','));
+            expect(']');
+        } else if (c == '"') {
+            v.type = Json::Type::string;
+            v.string = string_literal();
+        } else if (literal("true")) {
+            v.type = Json::Type::boolean;
+            v.boolean = true;
+        } else if (literal("false")) {
+            v.type = Json::Type::boolean;
+        } else if (literal("null")) {
+            v.type = Json::Type::null;
+        } else {
+            const char *begin = text_.data() + pos_;
+            const auto [ptr, ec] = std::from_chars(begin, text_.data() + text_.size(), v.number);
+            if (ec != std::errc{}) {
+                error("bad value");
+            }
+            v.type = Json::Type::number;
+            pos_ += static_cast<std::size_t>(ptr - begin);
+        }
+        return v;
+    }
+
+    [[nodiscard]] std::string string_literal() {
+        if (pos_ >= text_.size() || text_[pos_] != '"') {
+            error("expected a string");
+        }
+        ++pos_;
+
+        std::string out{};
+        for (;;) {
+            if (pos_ >= text_.size()) {
+                error("unterminated string");
+            }
+            const char c = text_[pos_++];
+            if (c == '"') {
+                return out;
+            }
+            if (c != '\\') {
+                out.push_back(c);
+                continue;
+            }
+            if (pos_ >= text_.size()) {
+                error("unterminated string");
+            }
+            switch (text_[pos_++]) {
+            case '"':
+                out.push_back('"');
+                break;
+            case '\\':
+                out.push_back('\\');
+                break;
+            case '/':
+                out.push_back('/');
+                break;
+            case 'b':
+                out.push_back('\b');
+                break;
+            case 'f':
+                out.push_back('\f');
+                break;
+            case 'n':
+                out.push_back('\n');
+                break;
+            case 'r':
+                out.push_back('\r');
+                break;
+            case 't':
+                out.push_back('\t');
+                break;
+            case 'u':
+                append_utf8(out, code_point());
+                break;
+            default:
+                error("bad escape");
+            }
+        }
+    }
+
+    [[nodiscard]] std::uint32_t hex4() {
+        std::uint32_t v = 0;
+        const char *begin = text_.data() + pos_;
+        if (text_.size() - pos_ < 4u) {
+            error("bad \\u escape");
+        }
+        const auto [ptr, ec] = std::from_chars(begin, begin + 4, v, 16);
+        if (ec != std::errc{} || ptr != begin + 4) {
+            error("bad \\u escape");
+        }
+        pos_ += 4;
+        return v;
+    }
+
+    [[nodiscard]] std::uint32_t code_point() {
+        const std::uint32_t cp = hex4();
+        if (cp >= 0xD800u && cp < 0xDC00u && literal("\\u")) {
+            const std::uint32_t lo = hex4();
+            if (lo < 0xDC00u || lo >= 0xE000u) {
+                error("bad surrogate pair");
+            }
+            return 0x10000u + ((cp - 0xD800u) << 10u) + (lo - 0xDC00u);
+        }
+        return cp;
+    }
+
+    static void append_utf8(std::string &out, std::uint32_t cp) {
+        const auto byte = [&out](std::uint32_t b) { out.push_back(static_cast<char>(static_cast<unsigned char>(b))); };
+        if (cp < 0x80u) {
+            byte(cp);
+        } else if (cp < 0x800u) {
+            byte(0xC0u | (cp >> 6u));
+            byte(0x80u | (cp & 0x3Fu));
+        } else if (cp < 0x10000u) {
+            byte(0xE0u | (cp >> 12u));
+            byte(0x80u | ((cp >> 6u) & 0x3Fu));
+            byte(0x80u | (cp & 0x3Fu));
+        } else {
+            byte(0xF0u | (cp >> 18u));
+            byte(0x80u | ((cp >> 12u) & 0x3Fu));
+            byte(0x80u | ((cp >> 6u) & 0x3Fu));
+            byte(0x80u | (cp & 0x3Fu));
+        }
+    }
+
+    std::string_view text_;
+    std::size_t pos_{0};
+};
+
+[[nodiscard]] const Json &member(const Json &obj, std::string_view key, const char *what) {
+    const Json *v = obj.find(key);
+    if (!v) {
+        fail(std::string{what} + " is missing \"" + std::string{key} + "\"");
+    }
+    return *v;
+}
+
+[[nodiscard]] std::uint64_t to_uint(const Json &v, const char *what) {
+    // Integers beyond 2^53 cannot come out of a double exactly; no real asset has them.
+    if (v.type != Json::Type::number || v.number < 0.0 || v.number > 9007199254740992.0 ||
+        v.number != std::floor(v.number)) {
+        fail(std::string{what} + " must be a non-negative integer");
+    }
+    return static_cast<std::uint64_t>(v.number);
+}
+
+[[nodiscard]] std::uint64_t uint_or(const Json &obj, std::string_view key, std::uint64_t fallback, const char *what) {
+    const Json *v = obj.find(key);
+    return v ? to_uint(*v, what) : fallback;
+}
+
+[[nodiscard]] const Json &element(const Json &doc, std::string_view array, std::uint64_t index) {
+    const Json *a = doc.find(array);
+    if (!a || a->type != Json::Type::array || index >= a->array.size()) {
+        fail("\"" + std::string{array} + "\" has no element " + std::to_string(index));
+    }
+    return a->array[static_cast<std::size_t>(index)];
+}
+
+// Fills `out` from a JSON array of exactly out.size() numbers. Returns false, leaving `out`
+// alone, when `v` is absent.
+bool number_array(const Json *v, std::span<float> out, const char *what) {
+    if (!v) {
+        return false;
+    }
+    if (v->type != Json::Type::array || v->array.size() != out.size()) {
+        fail(std::string{what} + " must be an array of " + std::to_string(out.size()) + " numbers");
+    }
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        if (v->array[i].type != Json::Type::number) {
+            fail(std::string{what} + " must be an array of " + std::to_string(out.size()) + " numbers");
+        }
+        out[i] = static_cast<float>(v->array[i].number);
+    }
+    return true;
+}
+
+[[nodiscard]] std::vector<std::byte> decode_base64(std::string_view s) {
+    std::vector<std::byte> out{};
+    out.reserve(s.size() / 4u * 3u);
+    std::uint32_t acc = 0;
+    std::uint32_t bits = 0;
+    for (char c : s) {
+        std::uint32_t v = 0;
+        if (c >= 'A' && c <= 'Z') {
+            v = static_cast<std::uint32_t>(c - 'A');
+        } else if (c >= 'a' && c <= 'z') {
+            v = static_cast<std::uint32_t>(c - 'a') + 26u;
+        } else if (c >= '0' && c <= '9') {
+            v = static_cast<std::uint32_t>(c - '0') + 52u;
+        } else if (c == '+') {
+            v = 62u;
+        } else if (c == '/') {
+            v = 63u;
+        } else if (c == '=') {
+            break;
+        } else {
+            fail("bad base64 data URI");
+        }
+        acc = (acc << 6u) | v;
+        bits += 6u;
+        if (bits >= 8u) {
+            bits -= 8u;
+            out.push_back(static_cast<std::byte>((acc >> bits) & 0xFFu));
+        }
+    }
+    return out;
+}
+
+// Relative URIs may percent-encode characters such as spaces.
+[[nodiscard]] std::string decode_uri(std::string_view uri) {
+    std::string out{};
+    out.reserve(uri.size());
+    for (std::size_t i = 0; i < uri.size(); ++i) {
+        unsigned char v = 0;
+        if (uri[i] == '%' && i + 2u < uri.size() &&
+            std::from_chars(uri.data() + i + 1, uri.data() + i + 3, v, 16).ptr == uri.data() + i + 3) {
+            out.push_back(static_cast<char>(v));
+            i += 2;
+        } else {
+            out.push_back(uri[i]);
+        }
+    }
+    return out;
+}
+
+struct Buffer {
+    MappedFile file{};
+    std::vector<std::byte> decoded{}; // data: URIs
+    std::span<const std::byte> bytes{};
+};
+
+struct Document {
+    MappedFile file{}; // the .gltf / .glb itself; a GLB's binary chunk points into it
+    Json json{};
+    std::span<const std::byte> glb_bin{};
+    std::vector<Buffer> buffers{};
+};
+
+constexpr std::uint32_t k_glb_magic = 0x46546C67u; // "glTF"
+constexpr std::uint32_t k_glb_chunk_json = 0x4E4F534Au;
+constexpr std::uint32_t k_glb_chunk_bin = 0x004E4942u;
+
+// GLB and the buffers are little-endian, as is every platform this runs on.
+[[nodiscard]] std::uint32_t read_u32(std::span<const std::byte> bytes, std::size_t offset) {
+    std::uint32_t v = 0;
+    std::memcpy(&v, bytes.data() + offset, sizeof(v));
+    return v;
+}
+
+[[nodiscard]] std::string_view as_chars(std::span<const std::byte> bytes) {
+    return {reinterpret_cast<const char *>(bytes.data()), bytes.size()};
+}
+
+void load_document(const std::filesystem::path &src, Document &doc) {
+    doc.file.open(src);
+    const std::span<const std::byte> bytes = doc.file.bytes();
+
+    std::string_view json_text{};
+    if (bytes.size() >= 12u && read_u32(bytes, 0) == k_glb_magic) {
+        if (read_u32(bytes, 4) != 2u) {
+            fail("unsupported GLB version");
+        }
+        const std::size_t length = std::min<std::size_t>(read_u32(bytes, 8), bytes.size());
+        std::size_t offset = 12;
+        while (offset + 8u <= length) {
+            const std::size_t chunk_length = read_u32(bytes, offset);
+            const std::uint32_t type = read_u32(bytes, offset + 4u);
+            offset += 8u;
+            if (chunk_length > length - offset) {
+                fail("truncated GLB chunk");
+            }
+            const std::span<const std::byte> chunk = bytes.subspan(offset, chunk_length);
+            if (type == k_glb_chunk_json && json_text.empty()) {
+                json_text = as_chars(chunk);
+            } else if (type == k_glb_chunk_bin && doc.glb_bin.empty()) {
+                doc.glb_bin = chunk;
+            }
+            offset += (chunk_length + 3u) & ~std::size_t{3};
+        }
+        if (json_text.empty()) {
+            fail("GLB without a JSON chunk");
+        }
+    } else {
+        json_text = as_chars(bytes);
+    }
+    doc.json = JsonParser{json_text}.parse();
+
+    const Json *buffers = doc.json.find("buffers");
+    const std::size_t count = (buffers && buffers->type == Json::Type::array) ? buffers->array.size() : 0u;
+    doc.buffers.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const Json &b = buffers->array[i];
+        const std::uint64_t length = to_uint(member(b, "byteLength", "buffer"), "buffer.byteLength");
+        Buffer &out = doc.buffers[i];
+
+        const Json *uri = b.find("uri");
+        if (!uri) {
+            if (i != 0u || doc.glb_bin.empty()) {
+                fail("buffer " + std::to_string(i) + " has no uri");
+            }
+            out.bytes = doc.glb_bin;
+        } else if (uri->type != Json::Type::string) {
+            fail("buffer " + std::to_string(i) + " has a non-string uri");
+        } else if (uri->string.starts_with("data:")) {
+            const std::string_view data{uri->string};
+            const std::size_t comma = data.find(',');
+            if (comma == std::string_view::npos || data.substr(0, comma).find(";base64") == std::string_view::npos) {
+                fail("only base64 data URIs are supported");
+            }
+            out.decoded = decode_base64(data.substr(comma + 1u));
+            out.bytes = out.decoded;
+        } else {
+            out.file.open(src.parent_path() / std::filesystem::path{decode_uri(uri->string)});
+            out.bytes = out.file.bytes();
+        }
+
+        if (out.bytes.size() < length) {
+            fail("buffer " + std::to_string(i) + " is shorter than its byteLength");
+        }
+        out.bytes = out.bytes.first(static_cast<std::size_t>(length));
+    }
+}
+
+constexpr std::uint32_t k_byte = 5120;
+constexpr std::uint32_t k_unsigned_byte = 5121;
+constexpr std::uint32_t k_short = 5122;
+constexpr std::uint32_t k_unsigned_short = 5123;
+constexpr std::uint32_t k_unsigned_int = 5125;
+constexpr std::uint32_t k_float = 5126;
+
+[[nodiscard]] std::size_t component_size(std::uint32_t type) noexcept {
+    switch (type) {
+    case k_byte:
+    case k_unsigned_byte:
+        return 1;
+    case k_short:
+    case k_unsigned_short:
+        return 2;
+    case k_unsigned_int:
+    case k_float:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+[[nodiscard]] std::uint32_t component_count(const Json &type) noexcept {
+    if (type.type != Json::Type::string) {
+        return 0;
+    }
+    if (type.string == "SCALAR") {
+        return 1;
+    }
+    if (type.string == "VEC2") {
+        return 2;
+    }
+    if (type.string == "VEC3") {
+        return 3;
+    }
+    return type.string == "VEC4" ? 4u : 0u;
+}
+
+// A bounds-checked view of an accessor's elements.
+struct Accessor {
+    const std::byte *data{nullptr};
+    std::size_t count{0};
+    std::size_t stride{0};
+    std::size_t component_size{0};
+    std::uint32_t component_type{0};
+    std::uint32_t components{0};
+    bool normalized{false};
+};
+
+[[nodiscard]] Accessor accessor(const Document &doc, std::uint64_t index) {
+    const Json &a = element(doc.json, "accessors", index);
+    if (a.find("sparse")) {
+        fail("sparse accessors are not supported");
+    }
+    const Json *view_index = a.find("bufferView");
+    if (!view_index) {
+        fail("accessors without a bufferView are not supported");
+    }
+
+    Accessor out{};
+    out.count = static_cast<std::size_t>(to_uint(member(a, "count", "accessor"), "accessor.count"));
+    out.component_type =
+        static_cast<std::uint32_t>(to_uint(member(a, "componentType", "accessor"), "accessor.componentType"));
+    out.component_size = component_size(out.component_type);
+    out.components = component_count(member(a, "type", "accessor"));
+    const Json *normalized = a.find("normalized");
+    out.normalized = normalized && normalized->type == Json::Type::boolean && normalized->boolean;
+    if (out.component_size == 0u || out.components == 0u) {
+        fail("unsupported accessor type");
+    }
+
+    const Json &view = element(doc.json, "bufferViews", to_uint(*view_index, "accessor.bufferView"));
+    const std::uint64_t buffer = to_uint(member(view, "buffer", "bufferView"), "bufferView.buffer");
+    if (buffer >= doc.buffers.size()) {
+        fail("bufferView references a missing buffer");
+    }
+    const std::span<const std::byte> bytes = doc.buffers[static_cast<std::size_t>(buffer)].bytes;
+
+    const std::uint64_t element_size = out.component_size * out.components;
+    const std::uint64_t view_offset = uint_or(view, "byteOffset", 0, "bufferView.byteOffset");
+    const std::uint64_t view_length = to_uint(member(view, "byteLength", "bufferView"), "bufferView.byteLength");
+    const std::uint64_t stride = uint_or(view, "byteStride", element_size, "bufferView.byteStride");
+    const std::uint64_t offset = uint_or(a, "byteOffset", 0, "accessor.byteOffset");
+    if (view_offset > bytes.size() || view_length > bytes.size() - view_offset || stride < element_size) {
+        fail("bufferView out of bounds");
+    }
+    if (out.count != 0u && (offset > view_length || element_size > view_length - offset ||
+                            out.count - 1u > (view_length - offset - element_size) / stride)) {
+        fail("accessor out of bounds");
+    }
+
+    out.data = bytes.data() + view_offset + offset;
+    out.stride = static_cast<std::size_t>(stride);
+    return out;
+}
+
+[[nodiscard]] float read_float(const Accessor &a, std::size_t i, std::uint32_t component) {
+    const std::byte *p = a.data + i * a.stride + component * a.component_size;
+    const auto load = [p](auto v) {
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    };
+    switch (a.component_type) {
+    case k_float:
+        return load(float{});
+    case k_unsigned_byte: {
+        const float v = static_cast<float>(load(std::uint8_t{}));
+        return a.normalized ? v / 255.0f : v;
+    }
+    case k_unsigned_short: {
+        const float v = static_cast<float>(load(std::uint16_t{}));
+        return a.normalized ? v / 65535.0f : v;
+    }
+    case k_byte: {
+        const float v = static_cast<float>(load(std::int8_t{}));
+        return a.normalized ? std::max(v / 127.0f, -1.0f) : v;
+    }
+    case k_short: {
+        const float v = static_cast<float>(load(std::int16_t{}));
+        return a.normalized ? std::max(v / 32767.0f, -1.0f) : v;
+    }
+    default:
+        return static_cast<float>(load(std::uint32_t{}));
+    }
+}
+
+[[nodiscard]] std::uint32_t read_index(const Accessor &a, std::size_t i) {
+    const std::byte *p = a.data + i * a.stride;
+    switch (a.component_type) {
+    case k_unsigned_byte: {
+        std::uint8_t v = 0;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    case k_unsigned_short: {
+        std::uint16_t v = 0;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    default: {
+        std::uint32_t v = 0;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    }
+}
+
+[[nodiscard]] glm::mat4 local_transform(const Json &node) {
+    std::array<float, 16> m{};
+    if (number_array(node.find("matrix"), m, "node.matrix")) {
+        return glm::make_mat4(m.data()); // column-major, like glm
+    }
+
+    std::array<float, 3> t = {0.0f, 0.0f, 0.0f};
+    std::array<float, 4> r = {0.0f, 0.0f, 0.0f, 1.0f}; // x y z w
+    std::array<float, 3> s = {1.0f, 1.0f, 1.0f};
+    number_array(node.find("translation"), t, "node.translation");
+    number_array(node.find("rotation"), r, "node.rotation");
+    number_array(node.find("scale"), s, "node.scale");
+
+    return glm::translate(glm::mat4(1.0f), glm::vec3(t[0], t[1], t[2])) *
+           glm::mat4_cast(glm::quat(r[3], r[0], r[1], r[2])) *
+           glm::scale(glm::mat4(1.0f), glm::vec3(s[0], s[1], s[2]));
+}
+
+constexpr std::uint64_t k_mode_triangles = 4;
+constexpr std::uint64_t k_mode_triangle_strip = 5;
+constexpr std::uint64_t k_mode_triangle_fan = 6;
+
+// Converts primitives into writer chunks; the scratch vectors are reused so the importer holds one
+// primitive at a time.
+class PrimitiveWriter {
+public:
+    PrimitiveWriter(const Document &doc, MeshFileWriter &writer, GltfImportStats &stats)
+        : doc_{doc}, writer_{writer}, stats_{stats} {}
+
+    void mesh(std::uint64_t index, const glm::mat4 &world) {
+        const Json &m = element(doc_.json, "meshes", index);
+        for (const Json &p : member(m, "primitives", "mesh").array) {
+            primitive(p, world);
+        }
+    }
+
+private:
+    void primitive(const Json &p, const glm::mat4 &world) {
+        const std::uint64_t mode = uint_or(p, "mode", k_mode_triangles, "primitive.mode");
+        if (mode < k_mode_triangles || mode > k_mode_triangle_fan) {
+            ++stats_.skipped_primitives;
+            return;
+        }
+
+        const Json &attributes = member(p, "attributes", "primitive");
+        const Accessor pos = accessor(doc_, to_uint(member(attributes, "POSITION", "primitive"), "POSITION"));
+        if (pos.component_type != k_float || pos.components != 3u) {
+            fail("POSITION must be a float VEC3");
+        }
+
+        std::optional<Accessor> color{};
+        if (const Json *c = attributes.find("COLOR_0")) {
+            color = accessor(doc_, to_uint(*c, "COLOR_0"));
+            if ((color->components != 3u && color->components != 4u) ||
+                (color->component_type != k_float && !color->normalized)) {
+                fail("COLOR_0 must be a float or normalized VEC3/VEC4");
+            }
+            if (color->count != pos.count) {
+                fail("COLOR_0 and POSITION counts differ");
+            }
+        }
+
+        std::array<float, 4> factor = {1.0f, 1.0f, 1.0f, 1.0f};
+        if (const Json *material = p.find("material")) {
+            const Json &m = element(doc_.json, "materials", to_uint(*material, "primitive.material"));
+            if (const Json *pbr = m.find("pbrMetallicRoughness")) {
+                number_array(pbr->find("baseColorFactor"), factor, "baseColorFactor");
+            }
+        }
+        const glm::vec3 tint(factor[0], factor[1], factor[2]);
+
+        vertices_.resize(pos.count);
+        for (std::size_t i = 0; i < pos.count; ++i) {
+            const glm::vec3 p_model(read_float(pos, i, 0), read_float(pos, i, 1), read_float(pos, i, 2));
+            vertices_[i].pos = glm::vec3(world * glm::vec4(p_model, 1.0f));
+            vertices_[i].color =
+                color ? tint * glm::vec3(read_float(*color, i, 0), read_float(*color, i, 1), read_float(*color, i, 2))
+                      : tint;
+        }
+
+        corners_.clear();
+        if (const Json *ind = p.find("indices")) {
+            const Accessor idx = accessor(doc_, to_uint(*ind, "primitive.indices"));
+            if (idx.components != 1u || (idx.component_type != k_unsigned_byte &&
+                                         idx.component_type != k_unsigned_short && idx.component_type != k_unsigned_int)) {
+                fail("indices must be unsigned integer scalars");
+            }
+            corners_.resize(idx.count);
+            for (std::size_t i = 0; i < idx.count; ++i) {
+                corners_[i] = read_index(idx, i);
+                if (corners_[i] >= pos.count) {
+                    fail("index out of range");
+                }
+            }
+        } else {
+            corners_.resize(pos.count);
+            std::iota(corners_.begin(), corners_.end(), 0u);
+        }
+
+        // A mirroring transform turns the winding around; swap two corners to keep front faces.
+        const bool flip = glm::determinant(glm::mat3(world)) < 0.0f;
+        triangles_.clear();
+        const auto emit = [this, flip](std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+            if (flip) {
+                std::swap(b, c);
+            }
+            triangles_.insert(triangles_.end(), {a, b, c});
+        };
+        if (mode == k_mode_triangles) {
+            if (corners_.size() % 3u != 0u) {
+                fail("triangle list index count is not a multiple of 3");
+            }
+            for (std::size_t i = 0; i < corners_.size(); i += 3u) {
+                emit(corners_[i], corners_[i + 1u], corners_[i + 2u]);
+            }
+        } else if (mode == k_mode_triangle_strip) {
+            // Every other strip triangle is wound the other way round.
+            for (std::size_t i = 2; i < corners_.size(); ++i) {
+                if (i % 2u == 0u) {
+                    emit(corners_[i - 2u], corners_[i - 1u], corners_[i]);
+                } else {
+                    emit(corners_[i - 1u], corners_[i - 2u], corners_[i]);
+                }
+            }
+        } else {
+            for (std::size_t i = 2; i < corners_.size(); ++i) {
+                emit(corners_[0], corners_[i - 1u], corners_[i]);
+            }
+        }
+
+        if (triangles_.empty()) {
+            return;
+        }
+        writer_.add_chunk(vertices_, triangles_);
+        ++stats_.primitives;
+        stats_.vertices += vertices_.size();
+        stats_.indices += triangles_.size();
+    }
+
+    const Document &doc_;
+    MeshFileWriter &writer_;
+    GltfImportStats &stats_;
+
+    std::vector<MeshVertex> vertices_{};
+    std::vector<std::uint32_t> corners_{};   // as stored, before triangulation
+    std::vector<std::uint32_t> triangles_{}; // triangle list
+};
+
+} // namespace
+
+GltfImportStats import_gltf(const std::filesystem::path &src, const std::filesystem::path &dst) {
+    Document doc{};
+    load_document(src, doc);
+    const Json &json = doc.json;
+
+    GltfImportStats stats{};
+    MeshFileWriter writer{};
+    writer.open(dst);
+    PrimitiveWriter primitives{doc, writer, stats};
+
+    const Json *scenes = json.find("scenes");
+    if (scenes && scenes->type == Json::Type::array && !scenes->array.empty()) {
+        const Json &scene = element(json, "scenes", uint_or(json, "scene", 0, "scene"));
+        const Json *nodes = json.find("nodes");
+        std::vector<bool> visited(nodes && nodes->type == Json::Type::array ? nodes->array.size() : 0u, false);
+
+        struct Pending {
+            std::uint64_t node;
+            glm::mat4 parent;
+        };
+        std::vector<Pending> stack{};
+        if (const Json *roots = scene.find("nodes")) {
+            for (auto it = roots->array.rbegin(); it != roots->array.rend(); ++it) {
+                stack.push_back(Pending{to_uint(*it, "scene.nodes"), glm::mat4(1.0f)});
+            }
+        }
+
+        while (!stack.empty()) {
+            const Pending p = stack.back();
+            stack.pop_back();
+            const Json &node = element(json, "nodes", p.node);
+            if (visited[static_cast<std::size_t>(p.node)]) {
+                fail("node hierarchy is not a tree");
+            }
+            visited[static_cast<std::size_t>(p.node)] = true;
+
+            const glm::mat4 world = p.parent * local_transform(node);
+            if (const Json *mesh = node.find("mesh")) {
+                primitives.mesh(to_uint(*mesh, "node.mesh"), world);
+            }
+            if (const Json *children = node.find("children")) {
+                for (auto it = children->array.rbegin(); it != children->array.rend(); ++it) {
+                    stack.push_back(Pending{to_uint(*it, "node.children"), world});
+                }
+            }
+        }
+    } else if (const Json *meshes = json.find("meshes")) {
+        for (std::size_t i = 0; i < meshes->array.size(); ++i) {
+            primitives.mesh(i, glm::mat4(1.0f));
+        }
+    }
+
+    writer.finish();
+    return stats;
+}
+
+} // namespace ds_pba
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+namespace ds_pba {
+
+struct GltfImportStats {
+    std::uint32_t primitives{0};         // written as chunks, once per node instancing them
+    std::uint32_t skipped_primitives{0}; // points and lines
+    std::uint64_t vertices{0};
+    std::uint64_t indices{0};
+};
+
+// Converts a glTF 2.0 asset (.gltf with external or base64 data: buffers, or binary .glb) into a
+// .pbamesh.
+//
+// Every triangle primitive (lists, strips and fans) reachable from the default scene becomes one
+// chunk, baked into world space by its node hierarchy; an asset without scenes writes each mesh
+// once, untransformed. Vertex colors are COLOR_0 times the material's baseColorFactor. Buffers are
+// read through memory mappings and one primitive is converted at a time, so the importer's own
+// footprint stays at about the largest primitive.
+//
+// Throws std::runtime_error on malformed or unsupported input (e.g. sparse accessors or a
+// primitive without POSITION); a partially written `dst` is removed.
+GltfImportStats import_gltf(const std::filesystem::path &src, const std::filesystem::path &dst);
+
+} // namespace ds_pba
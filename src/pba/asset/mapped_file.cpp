@@ -0,0 +1,144 @@
+#include "pba/asset/mapped_file.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PBA_HAS_MMAP 1
+#else
+#define PBA_HAS_MMAP 0
+#endif
+
+namespace ds_pba {
+namespace {
+
+[[noreturn]] void throw_errno(const char *what, const std::filesystem::path &path) {
+    const int err = errno;
+    throw std::runtime_error(std::string{what} + "(" + path.string() + "): " +
+                             std::system_category().message(err));
+}
+
+#if PBA_HAS_MMAP
+[[nodiscard]] std::size_t page_size() noexcept {
+    static const std::size_t size = [] {
+        const long s = ::sysconf(_SC_PAGESIZE);
+        return s > 0 ? static_cast<std::size_t>(s) : std::size_t{4096};
+    }();
+    return size;
+}
+#endif
+
+} // namespace
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data_{std::exchange(other.data_, nullptr)}, size_{std::exchange(other.size_, 0u)},
+      open_{std::exchange(other.open_, false)} {
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0u);
+        open_ = std::exchange(other.open_, false);
+    }
+    return *this;
+}
+
+void MappedFile::open(const std::filesystem::path &path) {
+    close();
+
+#if PBA_HAS_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw_errno("open", path);
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw_errno("fstat", path);
+    }
+
+    const auto size = static_cast<std::size_t>(st.st_size);
+    if (size != 0u) {
+        void *p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw_errno("mmap", path);
+        }
+        // Readers mostly walk the file front to back; let the kernel read ahead aggressively.
+        ::madvise(p, size, MADV_SEQUENTIAL);
+        data_ = static_cast<const std::byte *>(p);
+    }
+    // The mapping keeps the file alive.
+    ::close(fd);
+
+    size_ = size;
+    open_ = true;
+#else
+    throw std::runtime_error("Memory-mapped files are not supported on this platform: " + path.string());
+#endif
+}
+
+void MappedFile::close() noexcept {
+#if PBA_HAS_MMAP
+    if (data_) {
+        ::munmap(const_cast<std::byte *>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+}
+
+void MappedFile::prefetch(std::size_t offset, std::size_t size) const noexcept {
+#if PBA_HAS_MMAP
+    if (!data_ || offset >= size_) {
+        return;
+    }
+    // Grow outwards to whole pages; madvise needs a page-aligned start.
+    const std::size_t page = page_size();
+    const std::size_t begin = offset / page * page;
+    const std::size_t end = std::min(size_, offset + std::min(size, size_ - offset));
+    ::madvise(const_cast<std::byte *>(data_) + begin, end - begin, MADV_WILLNEED);
+#else
+    (void)offset;
+    (void)size;
+#endif
+}
+
+void MappedFile::discard(std::size_t offset, std::size_t size) const noexcept {
+#if PBA_HAS_MMAP
+    if (!data_ || offset >= size_) {
+        return;
+    }
+    // Shrink inwards to whole pages so the neighbours of the range stay resident. The mapping is
+    // private and never written, so dropped pages are simply read back from the file if touched.
+    const std::size_t page = page_size();
+    const std::size_t end = std::min(size_, offset + std::min(size, size_ - offset));
+    const std::size_t begin = (offset + page - 1u) / page * page;
+    const std::size_t last = (end == size_) ? end : end / page * page;
+    if (last <= begin) {
+        return;
+    }
+    ::madvise(const_cast<std::byte *>(data_) + begin, last - begin, MADV_DONTNEED);
+#else
+    (void)offset;
+    (void)size;
+#endif
+}
+
+} // namespace ds_pba
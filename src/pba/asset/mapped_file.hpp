@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace ds_pba {
+
+// A read-only memory mapping of a whole file.
+//
+// Pages are faulted in from the page cache on first touch, so a consumer that copies straight out
+// of bytes() (e.g. into a staging buffer) never holds a second copy of the file in memory.
+// prefetch() starts readahead for a range that is about to be read; discard() drops the resident
+// pages of a range that has been consumed, which keeps RSS bounded while streaming files larger
+// than memory. Both are hints: ranges are clamped to the file and failures are ignored.
+class MappedFile final {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    // Throws std::runtime_error if the file cannot be opened or mapped. An empty file opens with
+    // an empty bytes().
+    void open(const std::filesystem::path &path);
+    void close() noexcept;
+
+    [[nodiscard]] bool is_open() const noexcept { return open_; }
+    [[nodiscard]] std::span<const std::byte> bytes() const noexcept { return {data_, size_}; }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+    void prefetch(std::size_t offset, std::size_t size) const noexcept;
+    void discard(std::size_t offset, std::size_t size) const noexcept;
+
+private:
+    const std::byte *data_{nullptr};
+    std::size_t size_{0};
+    bool open_{false};
+};
+
+} // namespace ds_pba
@@ -0,0 +1,253 @@
+#include "pba/asset/mesh_file.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace ds_pba {
+namespace {
+
+constexpr std::uint64_t k_section_alignment = 16;
+constexpr std::uint64_t k_index_size = sizeof(std::uint32_t);
+
+// Rebased indices are written through a fixed buffer instead of a copy of the whole chunk.
+constexpr std::size_t k_index_batch = 4096;
+
+[[noreturn]] void throw_invalid(const std::filesystem::path &path, const char *why) {
+    throw std::runtime_error("Invalid mesh file " + path.string() + ": " + why);
+}
+
+// a + b <= limit, without overflowing.
+[[nodiscard]] bool fits(std::uint64_t a, std::uint64_t b, std::uint64_t limit) noexcept {
+    return a <= limit && b <= limit - a;
+}
+
+} // namespace
+
+void MeshFile::open(const std::filesystem::path &path) {
+    close();
+    file_.open(path);
+
+    const std::span<const std::byte> bytes = file_.bytes();
+    if (bytes.size() < sizeof(MeshFileHeader)) {
+        close();
+        throw_invalid(path, "truncated header");
+    }
+    std::memcpy(&header_, bytes.data(), sizeof(MeshFileHeader));
+
+    const char *why = nullptr;
+    const std::uint64_t size = bytes.size();
+    if (header_.magic != k_mesh_file_magic) {
+        why = "bad magic";
+    } else if (header_.version != k_mesh_file_version) {
+        why = "unsupported version";
+    } else if (header_.vertex_stride != sizeof(MeshVertex)) {
+        why = "unsupported vertex stride";
+    } else if (header_.chunk_count == 0u || header_.index_count == 0u) {
+        why = "no triangles";
+    } else if (header_.chunk_table_offset % alignof(MeshChunk) != 0u ||
+               !fits(header_.chunk_table_offset, std::uint64_t{header_.chunk_count} * sizeof(MeshChunk), size)) {
+        why = "chunk table out of bounds";
+    }
+    if (why) {
+        close();
+        throw_invalid(path, why);
+    }
+
+    chunks_.resize(header_.chunk_count);
+    std::memcpy(chunks_.data(), bytes.data() + header_.chunk_table_offset, chunks_.size() * sizeof(MeshChunk));
+
+    // Chunks must be dense and laid out in order, which is what lets MeshStreamer walk the file
+    // front to back.
+    std::uint64_t vertices = 0;
+    std::uint64_t indices = 0;
+    std::uint64_t end = sizeof(MeshFileHeader);
+    for (const MeshChunk &c : chunks_) {
+        if (c.vertex_count > size / sizeof(MeshVertex) || c.index_count > size / k_index_size) {
+            close();
+            throw_invalid(path, "chunk data out of bounds");
+        }
+        const std::uint64_t vertex_bytes = c.vertex_count * sizeof(MeshVertex);
+        const std::uint64_t index_bytes = c.index_count * k_index_size;
+        if (c.index_count == 0u || c.index_count % 3u != 0u) {
+            // MeshFileWriter::add_chunk() never writes these.
+            why = "chunk without whole triangles";
+        } else if (c.first_vertex != vertices || c.first_index != indices) {
+            why = "chunks are not dense";
+        } else if (c.vertex_offset < end || !fits(c.vertex_offset, vertex_bytes, header_.chunk_table_offset) ||
+                   c.index_offset < c.vertex_offset + vertex_bytes ||
+                   !fits(c.index_offset, index_bytes, header_.chunk_table_offset)) {
+            why = "chunk data out of order or out of bounds";
+        }
+        if (why) {
+            close();
+            throw_invalid(path, why);
+        }
+        vertices += c.vertex_count;
+        indices += c.index_count;
+        end = c.index_offset + index_bytes;
+    }
+    if (vertices != header_.vertex_count || indices != header_.index_count) {
+        close();
+        throw_invalid(path, "chunk counts do not match the header");
+    }
+}
+
+void MeshFile::close() noexcept {
+    file_.close();
+    header_ = MeshFileHeader{};
+    chunks_.clear();
+}
+
+std::span<const std::byte> MeshFile::vertex_bytes(const MeshChunk &chunk) const noexcept {
+    return file_.bytes().subspan(static_cast<std::size_t>(chunk.vertex_offset),
+                                 static_cast<std::size_t>(chunk.vertex_count * sizeof(MeshVertex)));
+}
+
+std::span<const std::byte> MeshFile::index_bytes(const MeshChunk &chunk) const noexcept {
+    return file_.bytes().subspan(static_cast<std::size_t>(chunk.index_offset),
+                                 static_cast<std::size_t>(chunk.index_count * k_index_size));
+}
+
+MeshFileWriter::~MeshFileWriter() {
+    close();
+    if (incomplete_) {
+        std::error_code ec;
+        std::filesystem::remove(path_, ec);
+    }
+}
+
+void MeshFileWriter::open(const std::filesystem::path &path) {
+    close();
+    file_ = std::fopen(path.string().c_str(), "wb");
+    if (!file_) {
+        throw std::runtime_error("Cannot open " + path.string() + " for writing");
+    }
+    path_ = path;
+    incomplete_ = true;
+    offset_ = 0;
+    chunks_.clear();
+    vertex_count_ = 0;
+    index_count_ = 0;
+    bounds_min_ = glm::vec3(std::numeric_limits<float>::max());
+    bounds_max_ = glm::vec3(std::numeric_limits<float>::lowest());
+
+    // Placeholder; finish() rewrites it once the counts are known.
+    const MeshFileHeader header{};
+    write(&header, sizeof(header));
+}
+
+void MeshFileWriter::add_chunk(std::span<const MeshVertex> vertices, std::span<const std::uint32_t> indices) {
+    if (!file_) {
+        throw std::runtime_error("MeshFileWriter::add_chunk() without open()");
+    }
+    if (indices.size() % 3u != 0u) {
+        throw std::invalid_argument("Mesh chunk index count must be a multiple of 3");
+    }
+    if (vertex_count_ + vertices.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::invalid_argument("Mesh exceeds 2^32 vertices");
+    }
+    for (std::uint32_t i : indices) {
+        if (i >= vertices.size()) {
+            throw std::invalid_argument("Mesh chunk index out of range");
+        }
+    }
+    if (indices.empty()) {
+        return;
+    }
+
+    MeshChunk chunk{};
+    chunk.first_vertex = vertex_count_;
+    chunk.vertex_count = vertices.size();
+    chunk.first_index = index_count_;
+    chunk.index_count = indices.size();
+
+    pad_to_alignment();
+    chunk.vertex_offset = offset_;
+    write(vertices.data(), vertices.size_bytes());
+
+    pad_to_alignment();
+    chunk.index_offset = offset_;
+    const auto base = static_cast<std::uint32_t>(vertex_count_);
+    std::array<std::uint32_t, k_index_batch> batch{};
+    for (std::size_t first = 0; first < indices.size(); first += batch.size()) {
+        const std::size_t n = std::min(batch.size(), indices.size() - first);
+        for (std::size_t i = 0; i < n; ++i) {
+            batch[i] = base + indices[first + i];
+        }
+        write(batch.data(), n * sizeof(std::uint32_t));
+    }
+
+    for (const MeshVertex &v : vertices) {
+        bounds_min_ = glm::min(bounds_min_, v.pos);
+        bounds_max_ = glm::max(bounds_max_, v.pos);
+    }
+
+    chunks_.push_back(chunk);
+    vertex_count_ += chunk.vertex_count;
+    index_count_ += chunk.index_count;
+}
+
+void MeshFileWriter::finish() {
+    if (!file_) {
+        throw std::runtime_error("MeshFileWriter::finish() without open()");
+    }
+    if (chunks_.empty()) {
+        close();
+        throw std::runtime_error("Mesh file " + path_.string() + " has no triangles");
+    }
+
+    pad_to_alignment();
+    MeshFileHeader header{};
+    header.magic = k_mesh_file_magic;
+    header.version = k_mesh_file_version;
+    header.vertex_stride = sizeof(MeshVertex);
+    header.vertex_count = vertex_count_;
+    header.index_count = index_count_;
+    header.chunk_table_offset = offset_;
+    header.chunk_count = static_cast<std::uint32_t>(chunks_.size());
+    header.reserved = 0;
+    // The sphere around the bounding box: conservative, but needs only one pass over the vertices.
+    const glm::vec3 center = 0.5f * (bounds_min_ + bounds_max_);
+    header.bounds = glm::vec4(center, glm::length(bounds_max_ - center));
+
+    write(chunks_.data(), chunks_.size() * sizeof(MeshChunk));
+    if (std::fseek(file_, 0, SEEK_SET) != 0) {
+        close();
+        throw std::runtime_error("Cannot seek in " + path_.string());
+    }
+    write(&header, sizeof(header));
+
+    const bool ok = std::fclose(file_) == 0;
+    file_ = nullptr;
+    if (!ok) {
+        throw std::runtime_error("Cannot write " + path_.string());
+    }
+    incomplete_ = false;
+}
+
+void MeshFileWriter::write(const void *data, std::size_t size) {
+    if (size != 0u && std::fwrite(data, 1, size, file_) != size) {
+        close();
+        throw std::runtime_error("Cannot write " + path_.string());
+    }
+    offset_ += size;
+}
+
+void MeshFileWriter::pad_to_alignment() {
+    constexpr std::array<std::byte, k_section_alignment> k_zeros{};
+    const std::uint64_t pad = (k_section_alignment - offset_ % k_section_alignment) % k_section_alignment;
+    write(k_zeros.data(), static_cast<std::size_t>(pad));
+}
+
+void MeshFileWriter::close() noexcept {
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+} // namespace ds_pba
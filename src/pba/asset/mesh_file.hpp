@@ -0,0 +1,127 @@
+#pragma once
+
+#include "pba/asset/mapped_file.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace ds_pba {
+
+// The vertex layout of .pbamesh files; matches the renderer's float32 vertex format, so vertex
+// data is uploaded straight out of the file mapping.
+struct MeshVertex {
+    glm::vec3 pos;
+    glm::vec3 color;
+};
+static_assert(sizeof(MeshVertex) == 24, "MeshVertex must stay tightly packed");
+
+// .pbamesh layout: a MeshFileHeader, then every chunk's vertices followed by its uint32 indices,
+// in chunk order, then the chunk table. Sections start on 16-byte boundaries.
+//
+// Chunks are dense: chunk i's vertices and indices directly follow chunk i-1's in the mesh-wide
+// vertex and index arrays. Indices are mesh-wide and only reference the chunk's own vertices, so
+// uploading the file front to back makes every index uploaded so far drawable.
+inline constexpr std::array<char, 8> k_mesh_file_magic = {'P', 'B', 'A', 'M', 'E', 'S', 'H', '\0'};
+inline constexpr std::uint32_t k_mesh_file_version = 1;
+
+struct MeshFileHeader {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t vertex_stride; // sizeof(MeshVertex)
+    std::uint64_t vertex_count;
+    std::uint64_t index_count;
+    std::uint64_t chunk_table_offset;
+    std::uint32_t chunk_count;
+    std::uint32_t reserved;
+    glm::vec4 bounds; // xyz center, w radius of a sphere enclosing every vertex
+};
+static_assert(sizeof(MeshFileHeader) == 64, "MeshFileHeader is part of the file format");
+
+struct MeshChunk {
+    std::uint64_t vertex_offset; // file offsets of the chunk's vertices and indices
+    std::uint64_t index_offset;
+    std::uint64_t first_vertex;
+    std::uint64_t vertex_count;
+    std::uint64_t first_index;
+    std::uint64_t index_count;
+};
+static_assert(sizeof(MeshChunk) == 48, "MeshChunk is part of the file format");
+
+// A memory-mapped .pbamesh. Vertex and index data are views into the mapping and are never
+// copied; only the header and chunk table are read eagerly.
+class MeshFile final {
+public:
+    MeshFile() = default;
+
+    MeshFile(const MeshFile &) = delete;
+    MeshFile &operator=(const MeshFile &) = delete;
+
+    // Validates the header and the chunk table against the file size, but not the index values,
+    // which would mean reading the whole file. Throws std::runtime_error.
+    void open(const std::filesystem::path &path);
+    void close() noexcept;
+
+    [[nodiscard]] bool is_open() const noexcept { return file_.is_open(); }
+    [[nodiscard]] const MeshFileHeader &header() const noexcept { return header_; }
+    [[nodiscard]] std::span<const MeshChunk> chunks() const noexcept { return chunks_; }
+    [[nodiscard]] const MappedFile &mapping() const noexcept { return file_; }
+
+    // Valid until close().
+    [[nodiscard]] std::span<const std::byte> vertex_bytes(const MeshChunk &chunk) const noexcept;
+    [[nodiscard]] std::span<const std::byte> index_bytes(const MeshChunk &chunk) const noexcept;
+
+private:
+    MappedFile file_{};
+    MeshFileHeader header_{};
+    std::vector<MeshChunk> chunks_{};
+};
+
+// Writes a .pbamesh one chunk at a time, so an importer only ever holds the chunk it is
+// converting. Destroying the writer before finish() succeeds removes the incomplete file.
+class MeshFileWriter final {
+public:
+    MeshFileWriter() = default;
+    ~MeshFileWriter();
+
+    MeshFileWriter(const MeshFileWriter &) = delete;
+    MeshFileWriter &operator=(const MeshFileWriter &) = delete;
+
+    // Throws std::runtime_error.
+    void open(const std::filesystem::path &path);
+
+    // `indices` are local to `vertices`. Throws std::invalid_argument if the index count is not a
+    // multiple of 3 or an index is out of range, std::runtime_error on a write error.
+    void add_chunk(std::span<const MeshVertex> vertices, std::span<const std::uint32_t> indices);
+
+    // Writes the chunk table and the header; until then the file is incomplete. Throws
+    // std::runtime_error if nothing was added or on a write error.
+    void finish();
+
+    [[nodiscard]] std::uint64_t vertex_count() const noexcept { return vertex_count_; }
+    [[nodiscard]] std::uint64_t index_count() const noexcept { return index_count_; }
+    [[nodiscard]] std::size_t chunk_count() const noexcept { return chunks_.size(); }
+
+private:
+    void write(const void *data, std::size_t size);
+    void pad_to_alignment();
+    void close() noexcept;
+
+    std::FILE *file_{nullptr};
+    std::filesystem::path path_{};
+    bool incomplete_{false}; // opened but not finished
+    std::uint64_t offset_{0};
+    std::vector<MeshChunk> chunks_{};
+    std::uint64_t vertex_count_{0};
+    std::uint64_t index_count_{0};
+    glm::vec3 bounds_min_{0.0f};
+    glm::vec3 bounds_max_{0.0f};
+};
+
+} // namespace ds_pba
@@ -0,0 +1,83 @@
+#include "pba/asset/mesh_streamer.hpp"
+
+#include <algorithm>
+
+namespace ds_pba {
+namespace {
+
+constexpr std::uint64_t k_triangle_bytes = 3u * sizeof(std::uint32_t);
+
+} // namespace
+
+void MeshStreamer::begin(const MeshFile &file) {
+    file_ = &file;
+    chunk_ = 0;
+    stream_ = Stream::vertices;
+    stream_offset_ = 0;
+    discarded_ = 0;
+    drawable_indices_ = 0;
+    streamed_bytes_ = 0;
+
+    const MeshFileHeader &h = file.header();
+    total_bytes_ = h.vertex_count * sizeof(MeshVertex) + h.index_count * sizeof(std::uint32_t);
+}
+
+std::uint64_t MeshStreamer::pump(std::uint64_t budget, const UploadFn &upload) {
+    if (done()) {
+        return 0;
+    }
+    budget = std::max(budget, k_triangle_bytes);
+    std::uint64_t sent = 0;
+    std::uint64_t file_pos = discarded_;
+
+    while (!done() && sent < budget) {
+        const MeshChunk &c = file_->chunks()[chunk_];
+        const bool vertices = (stream_ == Stream::vertices);
+        const std::span<const std::byte> data = vertices ? file_->vertex_bytes(c) : file_->index_bytes(c);
+
+        std::uint64_t n = std::min<std::uint64_t>(data.size() - stream_offset_, budget - sent);
+        if (!vertices) {
+            // Whole triangles only; the rest of the budget is left for the next pump. A consumed
+            // stream still falls through so the walk moves on to the next chunk.
+            n -= n % k_triangle_bytes;
+            if (n == 0u && stream_offset_ != data.size()) {
+                break;
+            }
+        }
+
+        if (n != 0u) {
+            const std::uint64_t dst_base =
+                vertices ? c.first_vertex * sizeof(MeshVertex) : c.first_index * sizeof(std::uint32_t);
+            upload(stream_, dst_base + stream_offset_,
+                   data.subspan(static_cast<std::size_t>(stream_offset_), static_cast<std::size_t>(n)));
+            sent += n;
+            stream_offset_ += n;
+            file_pos = (vertices ? c.vertex_offset : c.index_offset) + stream_offset_;
+        }
+
+        if (!vertices) {
+            drawable_indices_ = c.first_index + stream_offset_ / sizeof(std::uint32_t);
+        }
+        if (stream_offset_ == data.size()) {
+            stream_offset_ = 0;
+            if (vertices) {
+                stream_ = Stream::indices;
+            } else {
+                stream_ = Stream::vertices;
+                ++chunk_;
+            }
+        }
+    }
+    streamed_bytes_ += sent;
+
+    // The uploader has copied everything before file_pos, so those pages are no longer needed.
+    const MappedFile &mapping = file_->mapping();
+    mapping.discard(static_cast<std::size_t>(discarded_), static_cast<std::size_t>(file_pos - discarded_));
+    discarded_ = file_pos;
+    if (!done()) {
+        mapping.prefetch(static_cast<std::size_t>(file_pos), static_cast<std::size_t>(budget));
+    }
+    return sent;
+}
+
+} // namespace ds_pba
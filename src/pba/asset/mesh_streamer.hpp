@@ -0,0 +1,58 @@
+#pragma once
+
+#include "pba/asset/mesh_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+
+namespace ds_pba {
+
+// Feeds an open MeshFile to an uploader a budget of bytes at a time, so a large scene loads over
+// many frames instead of blocking one.
+//
+// Data goes out in file order (each chunk's vertices, then its indices) as views into the file
+// mapping, so nothing is copied before the uploader's own staging copy. Index uploads are split on
+// whole triangles; together with the .pbamesh ordering guarantee this makes the first
+// drawable_indices() indices safe to draw once the uploads so far are visible. After each pump()
+// the consumed pages are dropped and the next budget's worth is prefetched, so resident memory
+// stays around two budgets no matter how large the file is.
+class MeshStreamer final {
+public:
+    enum class Stream : std::uint8_t { vertices, indices };
+
+    // `dst_offset` is in bytes, into a buffer holding the whole mesh's vertices or indices.
+    using UploadFn = std::function<void(Stream stream, std::uint64_t dst_offset, std::span<const std::byte> data)>;
+
+    MeshStreamer() = default;
+
+    MeshStreamer(const MeshStreamer &) = delete;
+    MeshStreamer &operator=(const MeshStreamer &) = delete;
+
+    // `file` must stay open until done().
+    void begin(const MeshFile &file);
+
+    // Hands at most `budget` bytes (at least one triangle's indices) to `upload`. Returns the
+    // number of bytes handed over; 0 once done().
+    std::uint64_t pump(std::uint64_t budget, const UploadFn &upload);
+
+    [[nodiscard]] bool done() const noexcept { return file_ == nullptr || chunk_ == file_->chunks().size(); }
+    [[nodiscard]] std::uint64_t drawable_indices() const noexcept { return drawable_indices_; }
+    [[nodiscard]] std::uint64_t streamed_bytes() const noexcept { return streamed_bytes_; }
+    [[nodiscard]] std::uint64_t total_bytes() const noexcept { return total_bytes_; }
+
+private:
+    const MeshFile *file_{nullptr};
+    std::size_t chunk_{0};
+    Stream stream_{Stream::vertices};
+    std::uint64_t stream_offset_{0}; // bytes of the current chunk's current stream handed over
+    // File offset up to which pages have been discarded.
+    std::uint64_t discarded_{0};
+
+    std::uint64_t drawable_indices_{0};
+    std::uint64_t streamed_bytes_{0};
+    std::uint64_t total_bytes_{0};
+};
+
+} // namespace ds_pba
@@ -0,0 +1,215 @@
+#include "pba/core/job_system.hpp"
+
+#include "pba/core/profiler.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace ds_pba {
+namespace {
+
+// Failed steal rounds before an idle worker goes to sleep.
+constexpr std::uint32_t k_idle_spins = 64;
+
+struct CurrentWorker {
+    const void *system{nullptr};
+    std::uint32_t index{0};
+};
+
+thread_local CurrentWorker t_current_worker{};
+
+} // namespace
+
+JobSystem::JobSystem(std::uint32_t thread_count) {
+    const std::uint32_t n = std::max(thread_count, 1u);
+    workers_.reserve(n);
+    for (std::uint32_t i = 0; i < n; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+        workers_.back()->steal_from = (i + 1u) % n;
+    }
+
+    threads_.reserve(n - 1u);
+    for (std::uint32_t i = 1; i < n; ++i) {
+        threads_.emplace_back([this, i]() { worker_main(i); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    stop_.store(true);
+    wake_epoch_.fetch_add(1);
+    wake_epoch_.notify_all();
+    for (std::thread &t : threads_) {
+        t.join();
+    }
+}
+
+void JobSystem::run(JobCounter &counter, JobFn fn, const void *data, std::uint32_t first, std::uint32_t last,
+                    std::uint32_t grain) {
+    if (last <= first) {
+        return;
+    }
+    push(current_worker(), Task{fn, data, first, last, grain, &counter});
+}
+
+void JobSystem::wait(JobCounter &counter) {
+    Worker &self = current_worker();
+    while (!counter.done()) {
+        if (!try_execute_one(self)) {
+            std::this_thread::yield();
+        }
+    }
+
+    if (counter.failed_.load(std::memory_order_relaxed)) {
+        const std::exception_ptr error = counter.error_;
+        counter.error_ = nullptr;
+        counter.failed_.store(false, std::memory_order_relaxed);
+        std::rethrow_exception(error);
+    }
+}
+
+JobSystem::Worker &JobSystem::current_worker() noexcept {
+    // Any thread that is not one of ours is taken to be the creating thread.
+    const std::uint32_t index = (t_current_worker.system == this) ? t_current_worker.index : 0u;
+    return *workers_[index];
+}
+
+void JobSystem::push(Worker &self, const Task &task) {
+    task.counter->pending_.fetch_add(1, std::memory_order_relaxed);
+
+    Job &job = self.arena[self.next_job & k_deque_mask];
+    const std::int64_t b = self.bottom.load(std::memory_order_relaxed);
+    const std::int64_t t = self.top.load(std::memory_order_acquire);
+    if (b - t >= k_deque_capacity || job.queued.load(std::memory_order_acquire)) {
+        execute(self, task);
+        return;
+    }
+    ++self.next_job;
+    job.task = task;
+    job.queued.store(true, std::memory_order_relaxed);
+
+    self.slots[static_cast<std::size_t>(b & k_deque_mask)].store(&job, std::memory_order_relaxed);
+    self.bottom.store(b + 1, std::memory_order_release);
+
+    // Pairs with the sleeping_ increment in worker_main(): either the sleeper's last look at the
+    // deques finds this job, or this sees the sleeper and wakes it.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed) != 0u) {
+        wake_epoch_.fetch_add(1, std::memory_order_release);
+        wake_epoch_.notify_one();
+    }
+}
+
+JobSystem::Job *JobSystem::pop(Worker &self) noexcept {
+    const std::int64_t b = self.bottom.load(std::memory_order_relaxed) - 1;
+    self.bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = self.top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        self.bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job *job = self.slots[static_cast<std::size_t>(b & k_deque_mask)].load(std::memory_order_relaxed);
+    if (t == b) {
+        // Last job: race the thieves for it.
+        if (!self.top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            job = nullptr;
+        }
+        self.bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+JobSystem::Job *JobSystem::steal(Worker &victim) noexcept {
+    std::int64_t t = victim.top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t b = victim.bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+        return nullptr;
+    }
+
+    Job *job = victim.slots[static_cast<std::size_t>(t & k_deque_mask)].load(std::memory_order_relaxed);
+    if (!victim.top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return job;
+}
+
+bool JobSystem::try_execute_one(Worker &self) {
+    Job *job = pop(self);
+
+    const auto n = static_cast<std::uint32_t>(workers_.size());
+    for (std::uint32_t i = 0; i < n && job == nullptr; ++i) {
+        const std::uint32_t victim = (self.steal_from + i) % n;
+        if (workers_[victim].get() != &self) {
+            job = steal(*workers_[victim]);
+            if (job != nullptr) {
+                // Whoever had work once probably has more; start there next time.
+                self.steal_from = victim;
+            }
+        }
+    }
+    if (job == nullptr) {
+        return false;
+    }
+
+    const Task task = job->task;
+    job->queued.store(false, std::memory_order_release);
+    execute(self, task);
+    return true;
+}
+
+void JobSystem::execute(Worker &self, Task task) {
+    // Hand the upper halves to thieves and keep the lower one, so the oldest (stolen) jobs are
+    // always the largest.
+    if (task.grain != 0u) {
+        while (task.last - task.first > task.grain) {
+            const std::uint32_t mid = task.first + (task.last - task.first) / 2u;
+            push(self, Task{task.fn, task.data, mid, task.last, task.grain, task.counter});
+            task.last = mid;
+        }
+    }
+
+    JobCounter &counter = *task.counter;
+    try {
+        task.fn(task.data, task.first, task.last);
+    } catch (...) {
+        if (!counter.failed_.exchange(true, std::memory_order_relaxed)) {
+            counter.error_ = std::current_exception();
+        }
+    }
+    counter.pending_.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::worker_main(std::uint32_t index) {
+    t_current_worker = CurrentWorker{this, index};
+    Worker &self = *workers_[index];
+    if constexpr (profiler::k_enabled) {
+        profiler::set_thread_name("job worker " + std::to_string(index));
+    }
+
+    std::uint32_t idle = 0;
+    while (!stop_.load(std::memory_order_acquire)) {
+        if (try_execute_one(self)) {
+            idle = 0;
+            continue;
+        }
+        if (++idle < k_idle_spins) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // The epoch is read before announcing the sleep, so a wake-up after the last look below
+        // is never missed.
+        const std::uint32_t epoch = wake_epoch_.load(std::memory_order_acquire);
+        sleeping_.fetch_add(1, std::memory_order_seq_cst);
+        if (!stop_.load(std::memory_order_acquire) && !try_execute_one(self)) {
+            wake_epoch_.wait(epoch, std::memory_order_acquire);
+        }
+        sleeping_.fetch_sub(1, std::memory_order_relaxed);
+        idle = 0;
+    }
+}
+
+} // namespace ds_pba
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace ds_pba {
+
+// Fork/join counter of a group of jobs. Starts at zero; JobSystem::run() adds to it and every
+// finished job (including the ones it split off) takes one away.
+class JobCounter final {
+public:
+    JobCounter() = default;
+
+    JobCounter(const JobCounter &) = delete;
+    JobCounter &operator=(const JobCounter &) = delete;
+
+    [[nodiscard]] bool done() const noexcept { return pending_.load(std::memory_order_acquire) == 0u; }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<std::uint32_t> pending_{0};
+    // The first exception wins the flag and is published by that job's decrement of pending_.
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_{};
+};
+
+// Work-stealing job system for per-frame and simulation work.
+//
+// Every thread has a fixed-size lock-free deque (Chase-Lev): its owner pushes and pops at the
+// bottom, idle threads steal the oldest job from the top. A job covers an index range; one
+// larger than its grain pushes its upper half for others to steal and keeps splitting the
+// lower half, so parallel_for() spreads across the cores without a central queue.
+//
+// run() and wait() may be called from the thread that created the system or from inside a job;
+// jobs must not block on anything but wait(). wait() executes queued jobs until its counter is
+// done, so nested fork/join never idles a thread. Idle workers spin briefly, then sleep until
+// new work is pushed.
+class JobSystem final {
+public:
+    // Executes [first, last) of the job's range.
+    using JobFn = void (*)(const void *data, std::uint32_t first, std::uint32_t last);
+
+    // `thread_count` includes the creating thread; 0 or 1 means every job executes inline.
+    explicit JobSystem(std::uint32_t thread_count);
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    // Number of threads that execute jobs, including the creating thread.
+    [[nodiscard]] std::uint32_t thread_count() const noexcept {
+        return static_cast<std::uint32_t>(workers_.size());
+    }
+
+    // Queues fn(data, first, last) on the calling thread's deque, split into sub-ranges of at
+    // most `grain` indices (0 = never split). `data` must outlive the wait() on `counter`.
+    void run(JobCounter &counter, JobFn fn, const void *data, std::uint32_t first, std::uint32_t last,
+             std::uint32_t grain = 0);
+
+    // Executes jobs until `counter` is done, then rethrows the first exception one of its jobs
+    // threw.
+    void wait(JobCounter &counter);
+
+    // Calls fn(first, last) over sub-ranges of [first, last) of at most `grain` indices, in
+    // parallel, and returns once all of them have finished. `fn` may be called concurrently.
+    template <typename Fn>
+    void parallel_for(std::uint32_t first, std::uint32_t last, std::uint32_t grain, const Fn &fn) {
+        if (last <= first) {
+            return;
+        }
+        if (workers_.size() == 1u || last - first <= grain) {
+            fn(first, last);
+            return;
+        }
+        JobCounter counter{};
+        run(
+            counter,
+            [](const void *data, std::uint32_t b, std::uint32_t e) { (*static_cast<const Fn *>(data))(b, e); },
+            &fn, first, last, grain);
+        wait(counter);
+    }
+
+private:
+    // Power of two. A push into a full deque, or out of an arena slot a thief still holds,
+    // executes the job inline instead.
+    static constexpr std::uint32_t k_deque_capacity = 4096;
+    static constexpr std::int64_t k_deque_mask = k_deque_capacity - 1;
+
+    struct Task {
+        JobFn fn{nullptr};
+        const void *data{nullptr};
+        std::uint32_t first{0};
+        std::uint32_t last{0};
+        std::uint32_t grain{0};
+        JobCounter *counter{nullptr};
+    };
+
+    struct Job {
+        Task task{};
+        // Set while the job sits in a deque; cleared once the thread taking it has copied the task.
+        std::atomic<bool> queued{false};
+    };
+
+    // Owned by one thread. Jobs are allocated round-robin from its arena and referenced from
+    // the deque by pointer.
+    struct alignas(64) Worker {
+        std::atomic<std::int64_t> top{0};
+        alignas(64) std::atomic<std::int64_t> bottom{0};
+        std::array<std::atomic<Job *>, k_deque_capacity> slots{};
+        std::array<Job, k_deque_capacity> arena{};
+        std::uint32_t next_job{0};
+        std::uint32_t steal_from{0};
+    };
+
+    [[nodiscard]] Worker &current_worker() noexcept;
+    void push(Worker &self, const Task &task);
+    [[nodiscard]] static Job *pop(Worker &self) noexcept;
+    [[nodiscard]] static Job *steal(Worker &victim) noexcept;
+    [[nodiscard]] bool try_execute_one(Worker &self);
+    void execute(Worker &self, Task task);
+    void worker_main(std::uint32_t index);
+
+    std::vector<std::unique_ptr<Worker>> workers_{};
+    std::vector<std::thread> threads_{};
+
+    // Sleeping workers wait on wake_epoch_; a push bumps it only while someone sleeps.
+    std::atomic<std::uint32_t> sleeping_{0};
+    std::atomic<std::uint32_t> wake_epoch_{0};
+    std::atomic<bool> stop_{false};
+};
+
+} // namespace ds_pba
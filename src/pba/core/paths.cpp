@@ -0,0 +1,47 @@
+#include "pba/core/paths.hpp"
+
+#include <cstdint>
+#include <string>
+#include <system_error>
+
+#if defined(__APPLE__)
+#include <mach-o/dyld.h>
+#endif
+
+namespace ds_pba {
+
+std::filesystem::path executable_dir() {
+#if defined(__APPLE__)
+    std::uint32_t size = 0;
+    _NSGetExecutablePath(nullptr, &size);
+    std::string buf(size, '\0');
+    if (_NSGetExecutablePath(buf.data(), &size) != 0) {
+        return {};
+    }
+    buf.resize(std::char_traits<char>::length(buf.c_str()));
+
+    std::error_code ec;
+    const std::filesystem::path exe = std::filesystem::weakly_canonical(buf, ec);
+    return ec ? std::filesystem::path{buf}.parent_path() : exe.parent_path();
+#elif defined(__linux__)
+    std::error_code ec;
+    const std::filesystem::path exe = std::filesystem::read_symlink("/proc/self/exe", ec);
+    return ec ? std::filesystem::path{} : exe.parent_path();
+#else
+    return {};
+#endif
+}
+
+const std::filesystem::path &asset_root() {
+    static const std::filesystem::path root = []() {
+        const std::filesystem::path dir = executable_dir();
+        std::error_code ec;
+        if (!dir.empty() && std::filesystem::is_directory(dir / "assets", ec)) {
+            return dir / "assets";
+        }
+        return std::filesystem::path{"assets"};
+    }();
+    return root;
+}
+
+} // namespace ds_pba
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <filesystem>
+
+namespace ds_pba {
+
+// Directory containing the running executable, or an empty path if the platform query fails.
+[[nodiscard]] std::filesystem::path executable_dir();
+
+// The `assets` directory shipped next to the executable (the build copies it there). Falls back
+// to `assets` relative to the working directory so running from the source tree keeps working.
+// Resolved once; safe to call from any thread.
+[[nodiscard]] const std::filesystem::path &asset_root();
+
+} // namespace ds_pba
@@ -0,0 +1,241 @@
+#include "pba/core/profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace ds_pba::profiler {
+
+std::uint64_t now_ns() noexcept {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          std::chrono::steady_clock::now().time_since_epoch())
+                                          .count());
+}
+
+#if PBA_PROFILER
+
+namespace {
+
+struct Zone {
+    const char *name{nullptr};
+    std::uint64_t begin_ns{0};
+    std::uint64_t end_ns{0};
+};
+
+// Single-writer ring. The owner claims an index before it overwrites that index's slot and
+// publishes it afterwards, so a reader can tell which of the slots it copied were being
+// overwritten in the meantime.
+class Ring final {
+public:
+    void push(const char *name, std::uint64_t begin_ns, std::uint64_t end_ns) noexcept {
+        const std::uint64_t i = claimed_.load(std::memory_order_relaxed);
+        claimed_.store(i + 1u, std::memory_order_relaxed);
+        // Keeps the claim ahead of the slot stores; pairs with the fence in snapshot().
+        std::atomic_thread_fence(std::memory_order_release);
+        Slot &s = slots_[i % k_ring_capacity];
+        s.name.store(name, std::memory_order_relaxed);
+        s.begin_ns.store(begin_ns, std::memory_order_relaxed);
+        s.end_ns.store(end_ns, std::memory_order_relaxed);
+        written_.store(i + 1u, std::memory_order_release);
+    }
+
+    // Appends the zones still in the ring to `out`, oldest first.
+    void snapshot(std::vector<Zone> &out) const {
+        const std::uint64_t written = written_.load(std::memory_order_acquire);
+        const std::uint64_t first = written > k_ring_capacity ? written - k_ring_capacity : 0u;
+        const std::size_t base = out.size();
+        for (std::uint64_t i = first; i < written; ++i) {
+            const Slot &s = slots_[i % k_ring_capacity];
+            out.push_back(Zone{s.name.load(std::memory_order_relaxed), s.begin_ns.load(std::memory_order_relaxed),
+                               s.end_ns.load(std::memory_order_relaxed)});
+        }
+
+        // Index i shares its slot with i + capacity, so every copy older than the newest claim
+        // minus the capacity may mix two zones.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const std::uint64_t claimed = claimed_.load(std::memory_order_relaxed);
+        const std::uint64_t valid_from = claimed > k_ring_capacity ? claimed - k_ring_capacity : 0u;
+        if (valid_from > first) {
+            const auto torn = static_cast<std::ptrdiff_t>(std::min(valid_from, written) - first);
+            const auto begin = out.begin() + static_cast<std::ptrdiff_t>(base);
+            out.erase(begin, begin + torn);
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<const char *> name{nullptr};
+        std::atomic<std::uint64_t> begin_ns{0};
+        std::atomic<std::uint64_t> end_ns{0};
+    };
+
+    std::atomic<std::uint64_t> claimed_{0};
+    std::atomic<std::uint64_t> written_{0};
+    std::array<Slot, k_ring_capacity> slots_{};
+};
+
+struct Track {
+    std::string name{}; // guarded by Registry::mutex
+    Ring ring{};
+};
+
+struct Registry {
+    std::mutex mutex{};
+    std::unique_ptr<Track> gpu{std::make_unique<Track>()};
+    // Never shrinks, so a finished thread's zones stay in the trace.
+    std::vector<std::unique_ptr<Track>> threads{};
+};
+
+// Leaked on purpose: threads may still record while static destructors run.
+Registry &registry() {
+    static Registry *const r = [] {
+        auto *reg = new Registry{};
+        reg->gpu->name = "GPU (graphics queue)";
+        return reg;
+    }();
+    return *r;
+}
+
+thread_local Track *t_track = nullptr;
+
+// Registers the calling thread on first use; null if that fails (out of memory).
+[[nodiscard]] Track *this_thread_track() noexcept {
+    if (t_track != nullptr) {
+        return t_track;
+    }
+    try {
+        Registry &reg = registry();
+        auto track = std::make_unique<Track>();
+        const std::lock_guard lock{reg.mutex};
+        track->name = "thread " + std::to_string(reg.threads.size());
+        reg.threads.push_back(std::move(track));
+        t_track = reg.threads.back().get();
+    } catch (...) {
+        return nullptr;
+    }
+    return t_track;
+}
+
+void write_json_string(std::FILE *f, std::string_view s) {
+    std::fputc('"', f);
+    for (const char c : s) {
+        if (c == '"' || c == '\\') {
+            std::fputc('\\', f);
+            std::fputc(c, f);
+        } else if (static_cast<unsigned char>(c) < 0x20u) {
+            std::fprintf(f, "\\u%04x", static_cast<unsigned>(c));
+        } else {
+            std::fputc(c, f);
+        }
+    }
+    std::fputc('"', f);
+}
+
+} // namespace
+
+void record(const char *name, std::uint64_t begin_ns, std::uint64_t end_ns) noexcept {
+    if (Track *track = this_thread_track()) {
+        track->ring.push(name, begin_ns, end_ns);
+    }
+}
+
+void record_gpu(const char *name, std::uint64_t begin_ns, std::uint64_t end_ns) noexcept {
+    registry().gpu->ring.push(name, begin_ns, end_ns);
+}
+
+void set_thread_name(std::string_view name) {
+    if (Track *track = this_thread_track()) {
+        const std::lock_guard lock{registry().mutex};
+        track->name = name;
+    }
+}
+
+bool write_chrome_trace(const std::filesystem::path &path) {
+    struct Source {
+        std::string name{};
+        std::vector<Zone> zones{};
+    };
+
+    // tid 0 is the GPU, threads follow in registration order.
+    std::vector<Source> sources{};
+    {
+        Registry &reg = registry();
+        const std::lock_guard lock{reg.mutex};
+        sources.resize(reg.threads.size() + 1u);
+        sources[0].name = reg.gpu->name;
+        reg.gpu->ring.snapshot(sources[0].zones);
+        for (std::size_t i = 0; i < reg.threads.size(); ++i) {
+            sources[i + 1u].name = reg.threads[i]->name;
+            reg.threads[i]->ring.snapshot(sources[i + 1u].zones);
+        }
+    }
+
+    // Timestamps are written relative to the oldest zone, in microseconds.
+    std::uint64_t origin = UINT64_MAX;
+    for (const Source &src : sources) {
+        for (const Zone &z : src.zones) {
+            origin = std::min(origin, z.begin_ns);
+        }
+    }
+    if (origin == UINT64_MAX) {
+        origin = 0;
+    }
+
+    std::error_code ec;
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+    std::FILE *f = std::fopen(path.string().c_str(), "wb");
+    if (!f) {
+        return false;
+    }
+
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", f);
+    for (std::size_t tid = 0; tid < sources.size(); ++tid) {
+        std::fprintf(f, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":",
+                     tid == 0u ? "" : ",", tid);
+        write_json_string(f, sources[tid].name);
+        std::fputs("}}", f);
+
+        for (const Zone &z : sources[tid].zones) {
+            if (z.name == nullptr || z.end_ns < z.begin_ns) {
+                continue;
+            }
+            std::fputs(",\n{\"name\":", f);
+            write_json_string(f, z.name);
+            std::fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f}", tid,
+                         static_cast<double>(z.begin_ns - origin) * 1e-3,
+                         static_cast<double>(z.end_ns - z.begin_ns) * 1e-3);
+        }
+    }
+    std::fputs("\n]}\n", f);
+
+    const bool ok = std::ferror(f) == 0;
+    return (std::fclose(f) == 0) && ok;
+}
+
+#else
+
+void record(const char *, std::uint64_t, std::uint64_t) noexcept {
+}
+
+void record_gpu(const char *, std::uint64_t, std::uint64_t) noexcept {
+}
+
+void set_thread_name(std::string_view) {
+}
+
+bool write_chrome_trace(const std::filesystem::path &) {
+    return false;
+}
+
+#endif
+
+} // namespace ds_pba::profiler
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+// Set by the PBA_PROFILER CMake option. At 0 every PBA_PROFILE_ZONE compiles to nothing and the
+// functions below are no-ops.
+#ifndef PBA_PROFILER
+#define PBA_PROFILER 0
+#endif
+
+namespace ds_pba::profiler {
+
+inline constexpr bool k_enabled = PBA_PROFILER != 0;
+
+// Zones kept per thread; once a ring is full the oldest zone is overwritten.
+inline constexpr std::uint32_t k_ring_capacity = 16384;
+
+// Nanoseconds on the clock every zone is recorded against (std::chrono::steady_clock, i.e.
+// CLOCK_MONOTONIC on Linux).
+[[nodiscard]] std::uint64_t now_ns() noexcept;
+
+// Appends a finished zone to the calling thread's ring. The first call on a thread registers
+// its ring; after that it is a handful of relaxed stores. `name` is stored by pointer, so it must
+// outlive the profiler (a string literal).
+void record(const char *name, std::uint64_t begin_ns, std::uint64_t end_ns) noexcept;
+
+// The same for GPU work that has already been mapped onto now_ns(), shown as its own track.
+// Only one thread (the one reading the timestamp queries) may call it.
+void record_gpu(const char *name, std::uint64_t begin_ns, std::uint64_t end_ns) noexcept;
+
+// Names the calling thread's track in the trace; unnamed threads show as "thread N".
+void set_thread_name(std::string_view name);
+
+// Writes every zone still held by the rings as Chrome trace event JSON (chrome://tracing,
+// ui.perfetto.dev). Safe while other threads keep recording: a zone overwritten during the
+// export is dropped rather than written torn. Returns false if the file could not be written.
+[[nodiscard]] bool write_chrome_trace(const std::filesystem::path &path);
+
+// Records the enclosing scope as one zone.
+class ScopedZone final {
+public:
+    explicit ScopedZone(const char *name) noexcept : name_{name}, begin_ns_{now_ns()} {}
+    ~ScopedZone() { record(name_, begin_ns_, now_ns()); }
+
+    ScopedZone(const ScopedZone &) = delete;
+    ScopedZone &operator=(const ScopedZone &) = delete;
+
+private:
+    const char *name_;
+    std::uint64_t begin_ns_;
+};
+
+} // namespace ds_pba::profiler
+
+#define PBA_PROFILE_CONCAT_INNER(a, b) a##b
+#define PBA_PROFILE_CONCAT(a, b) PBA_PROFILE_CONCAT_INNER(a, b)
+
+#if PBA_PROFILER
+#define PBA_PROFILE_ZONE(name) const ::ds_pba::profiler::ScopedZone PBA_PROFILE_CONCAT(pba_zone_, __COUNTER__){name}
+#else
+#define PBA_PROFILE_ZONE(name) static_cast<void>(0)
+#endif
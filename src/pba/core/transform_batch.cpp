@@ -0,0 +1,272 @@
+#include "pba/core/transform_batch.hpp"
+
+#include <initializer_list>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define PBA_TRANSFORM_AVX2 1
+#else
+#define PBA_TRANSFORM_AVX2 0
+#endif
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define PBA_TRANSFORM_NEON 1
+#else
+#define PBA_TRANSFORM_NEON 0
+#endif
+
+namespace ds_pba {
+namespace {
+
+// post = [a | b]: a row-major 3x3 linear part and a translation.
+struct PostAffine {
+    float a[3][3];
+    float b[3];
+};
+
+[[nodiscard]] PostAffine to_post_affine(const glm::mat4 &m) noexcept {
+    PostAffine p{};
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            p.a[r][c] = m[c][r];
+        }
+        p.b[r] = m[3][r];
+    }
+    return p;
+}
+
+void compose_scalar(const TransformBatch &t, std::uint32_t first, std::uint32_t last, const PostAffine &p,
+                    float *out) noexcept {
+    for (std::uint32_t i = first; i < last; ++i) {
+        const float x = t.qx[i];
+        const float y = t.qy[i];
+        const float z = t.qz[i];
+        const float w = t.qw[i];
+        const float xx = x * (x + x), yy = y * (y + y), zz = z * (z + z);
+        const float xy = x * (y + y), xz = x * (z + z), yz = y * (z + z);
+        const float wx = w * (x + x), wy = w * (y + y), wz = w * (z + z);
+        const float sx = t.sx[i], sy = t.sy[i], sz = t.sz[i];
+
+        // R(q) * S(s): the rotation's columns scaled.
+        const float rs[3][3] = {
+            {(1.0f - (yy + zz)) * sx, (xy - wz) * sy, (xz + wy) * sz},
+            {(xy + wz) * sx, (1.0f - (xx + zz)) * sy, (yz - wx) * sz},
+            {(xz - wy) * sx, (yz + wx) * sy, (1.0f - (xx + yy)) * sz},
+        };
+        const float tr[3] = {t.px[i], t.py[i], t.pz[i]};
+
+        float *o = out + std::size_t{12} * i;
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                o[4 * r + c] = rs[r][0] * p.a[0][c] + rs[r][1] * p.a[1][c] + rs[r][2] * p.a[2][c];
+            }
+            o[4 * r + 3] = rs[r][0] * p.b[0] + rs[r][1] * p.b[1] + rs[r][2] * p.b[2] + tr[r];
+        }
+    }
+}
+
+#if PBA_TRANSFORM_AVX2
+#define PBA_AVX2_TARGET __attribute__((target("avx2,fma")))
+
+// c[k] holds column k of one output row for eight instances; transposes them into the eight
+// instances' 16-byte rows, 12 floats apart.
+PBA_AVX2_TARGET inline void store_rows_avx2(const __m256 (&c)[4], float *dst) noexcept {
+    const __m256 t0 = _mm256_unpacklo_ps(c[0], c[1]);
+    const __m256 t1 = _mm256_unpackhi_ps(c[0], c[1]);
+    const __m256 t2 = _mm256_unpacklo_ps(c[2], c[3]);
+    const __m256 t3 = _mm256_unpackhi_ps(c[2], c[3]);
+    // Instances k and k + 4 end up in the low and high half of rows[k].
+    const __m256 rows[4] = {
+        _mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(t0), _mm256_castps_pd(t2))),
+        _mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(t0), _mm256_castps_pd(t2))),
+        _mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(t1), _mm256_castps_pd(t3))),
+        _mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(t1), _mm256_castps_pd(t3))),
+    };
+    for (int k = 0; k < 4; ++k) {
+        _mm_storeu_ps(dst + 12 * k, _mm256_castps256_ps128(rows[k]));
+        _mm_storeu_ps(dst + 12 * (k + 4), _mm256_extractf128_ps(rows[k], 1));
+    }
+}
+
+PBA_AVX2_TARGET void compose_avx2(const TransformBatch &t, std::uint32_t first, std::uint32_t last,
+                                  const PostAffine &p, float *out) noexcept {
+    __m256 a[3][3];
+    __m256 b[3];
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            a[r][c] = _mm256_set1_ps(p.a[r][c]);
+        }
+        b[r] = _mm256_set1_ps(p.b[r]);
+    }
+    const __m256 one = _mm256_set1_ps(1.0f);
+
+    std::uint32_t i = first;
+    for (; last - i >= 8u; i += 8u) {
+        const __m256 x = _mm256_loadu_ps(t.qx.data() + i);
+        const __m256 y = _mm256_loadu_ps(t.qy.data() + i);
+        const __m256 z = _mm256_loadu_ps(t.qz.data() + i);
+        const __m256 w = _mm256_loadu_ps(t.qw.data() + i);
+        const __m256 x2 = _mm256_add_ps(x, x);
+        const __m256 y2 = _mm256_add_ps(y, y);
+        const __m256 z2 = _mm256_add_ps(z, z);
+        const __m256 xx = _mm256_mul_ps(x, x2), yy = _mm256_mul_ps(y, y2), zz = _mm256_mul_ps(z, z2);
+        const __m256 xy = _mm256_mul_ps(x, y2), xz = _mm256_mul_ps(x, z2), yz = _mm256_mul_ps(y, z2);
+        const __m256 wx = _mm256_mul_ps(w, x2), wy = _mm256_mul_ps(w, y2), wz = _mm256_mul_ps(w, z2);
+        const __m256 sx = _mm256_loadu_ps(t.sx.data() + i);
+        const __m256 sy = _mm256_loadu_ps(t.sy.data() + i);
+        const __m256 sz = _mm256_loadu_ps(t.sz.data() + i);
+
+        const __m256 rs[3][3] = {
+            {_mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx), _mm256_mul_ps(_mm256_sub_ps(xy, wz), sy),
+             _mm256_mul_ps(_mm256_add_ps(xz, wy), sz)},
+            {_mm256_mul_ps(_mm256_add_ps(xy, wz), sx), _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy),
+             _mm256_mul_ps(_mm256_sub_ps(yz, wx), sz)},
+            {_mm256_mul_ps(_mm256_sub_ps(xz, wy), sx), _mm256_mul_ps(_mm256_add_ps(yz, wx), sy),
+             _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz)},
+        };
+        const __m256 tr[3] = {_mm256_loadu_ps(t.px.data() + i), _mm256_loadu_ps(t.py.data() + i),
+                              _mm256_loadu_ps(t.pz.data() + i)};
+
+        float *o = out + std::size_t{12} * i;
+        for (int r = 0; r < 3; ++r) {
+            __m256 c[4];
+            for (int k = 0; k < 3; ++k) {
+                c[k] = _mm256_fmadd_ps(rs[r][0], a[0][k],
+                                       _mm256_fmadd_ps(rs[r][1], a[1][k], _mm256_mul_ps(rs[r][2], a[2][k])));
+            }
+            c[3] = _mm256_fmadd_ps(rs[r][0], b[0],
+                                   _mm256_fmadd_ps(rs[r][1], b[1], _mm256_fmadd_ps(rs[r][2], b[2], tr[r])));
+            store_rows_avx2(c, o + 4 * r);
+        }
+    }
+    compose_scalar(t, i, last, p, out);
+}
+
+[[nodiscard]] bool cpu_has_avx2() noexcept {
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+#endif
+
+#if PBA_TRANSFORM_NEON
+// c[k] holds column k of one output row for four instances; transposes them into the four
+// instances' 16-byte rows, 12 floats apart.
+inline void store_rows_neon(const float32x4_t (&c)[4], float *dst) noexcept {
+    const float64x2_t t0 = vreinterpretq_f64_f32(vtrn1q_f32(c[0], c[1]));
+    const float64x2_t t1 = vreinterpretq_f64_f32(vtrn2q_f32(c[0], c[1]));
+    const float64x2_t t2 = vreinterpretq_f64_f32(vtrn1q_f32(c[2], c[3]));
+    const float64x2_t t3 = vreinterpretq_f64_f32(vtrn2q_f32(c[2], c[3]));
+    vst1q_f32(dst, vreinterpretq_f32_f64(vtrn1q_f64(t0, t2)));
+    vst1q_f32(dst + 12, vreinterpretq_f32_f64(vtrn1q_f64(t1, t3)));
+    vst1q_f32(dst + 24, vreinterpretq_f32_f64(vtrn2q_f64(t0, t2)));
+    vst1q_f32(dst + 36, vreinterpretq_f32_f64(vtrn2q_f64(t1, t3)));
+}
+
+void compose_neon(const TransformBatch &t, std::uint32_t first, std::uint32_t last, const PostAffine &p,
+                  float *out) noexcept {
+    float32x4_t a[3][3];
+    float32x4_t b[3];
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            a[r][c] = vdupq_n_f32(p.a[r][c]);
+        }
+        b[r] = vdupq_n_f32(p.b[r]);
+    }
+    const float32x4_t one = vdupq_n_f32(1.0f);
+
+    std::uint32_t i = first;
+    for (; last - i >= 4u; i += 4u) {
+        const float32x4_t x = vld1q_f32(t.qx.data() + i);
+        const float32x4_t y = vld1q_f32(t.qy.data() + i);
+        const float32x4_t z = vld1q_f32(t.qz.data() + i);
+        const float32x4_t w = vld1q_f32(t.qw.data() + i);
+        const float32x4_t x2 = vaddq_f32(x, x);
+        const float32x4_t y2 = vaddq_f32(y, y);
+        const float32x4_t z2 = vaddq_f32(z, z);
+        const float32x4_t xx = vmulq_f32(x, x2), yy = vmulq_f32(y, y2), zz = vmulq_f32(z, z2);
+        const float32x4_t xy = vmulq_f32(x, y2), xz = vmulq_f32(x, z2), yz = vmulq_f32(y, z2);
+        const float32x4_t wx = vmulq_f32(w, x2), wy = vmulq_f32(w, y2), wz = vmulq_f32(w, z2);
+        const float32x4_t sx = vld1q_f32(t.sx.data() + i);
+        const float32x4_t sy = vld1q_f32(t.sy.data() + i);
+        const float32x4_t sz = vld1q_f32(t.sz.data() + i);
+
+        const float32x4_t rs[3][3] = {
+            {vmulq_f32(vsubq_f32(one, vaddq_f32(yy, zz)), sx), vmulq_f32(vsubq_f32(xy, wz), sy),
+             vmulq_f32(vaddq_f32(xz, wy), sz)},
+            {vmulq_f32(vaddq_f32(xy, wz), sx), vmulq_f32(vsubq_f32(one, vaddq_f32(xx, zz)), sy),
+             vmulq_f32(vsubq_f32(yz, wx), sz)},
+            {vmulq_f32(vsubq_f32(xz, wy), sx), vmulq_f32(vaddq_f32(yz, wx), sy),
+             vmulq_f32(vsubq_f32(one, vaddq_f32(xx, yy)), sz)},
+        };
+        const float32x4_t tr[3] = {vld1q_f32(t.px.data() + i), vld1q_f32(t.py.data() + i),
+                                   vld1q_f32(t.pz.data() + i)};
+
+        float *o = out + std::size_t{12} * i;
+        for (int r = 0; r < 3; ++r) {
+            float32x4_t c[4];
+            for (int k = 0; k < 3; ++k) {
+                c[k] = vfmaq_f32(vfmaq_f32(vmulq_f32(rs[r][2], a[2][k]), rs[r][1], a[1][k]), rs[r][0], a[0][k]);
+            }
+            c[3] = vfmaq_f32(vfmaq_f32(vfmaq_f32(tr[r], rs[r][2], b[2]), rs[r][1], b[1]), rs[r][0], b[0]);
+            store_rows_neon(c, o + 4 * r);
+        }
+    }
+    compose_scalar(t, i, last, p, out);
+}
+#endif
+
+} // namespace
+
+void TransformBatch::resize(std::size_t count) {
+    for (std::vector<float> *v : {&px, &py, &pz, &qx, &qy, &qz, &qw, &sx, &sy, &sz}) {
+        v->resize(count);
+    }
+}
+
+const char *to_string(TransformKernel kernel) noexcept {
+    switch (kernel) {
+    case TransformKernel::scalar:
+        return "scalar";
+    case TransformKernel::avx2:
+        return "avx2";
+    case TransformKernel::neon:
+        return "neon";
+    }
+    return "unknown";
+}
+
+TransformKernel best_transform_kernel() noexcept {
+#if PBA_TRANSFORM_AVX2
+    static const TransformKernel kernel = cpu_has_avx2() ? TransformKernel::avx2 : TransformKernel::scalar;
+    return kernel;
+#elif PBA_TRANSFORM_NEON
+    return TransformKernel::neon;
+#else
+    return TransformKernel::scalar;
+#endif
+}
+
+void compose_transforms(const TransformBatch &batch, std::uint32_t first, std::uint32_t last, const glm::mat4 &post,
+                        float *out, TransformKernel kernel) {
+    if (last <= first) {
+        return;
+    }
+    const PostAffine p = to_post_affine(post);
+
+#if PBA_TRANSFORM_AVX2
+    if (kernel == TransformKernel::avx2 && cpu_has_avx2()) {
+        compose_avx2(batch, first, last, p, out);
+        return;
+    }
+#endif
+#if PBA_TRANSFORM_NEON
+    if (kernel == TransformKernel::neon) {
+        compose_neon(batch, first, last, p, out);
+        return;
+    }
+#endif
+    static_cast<void>(kernel);
+    compose_scalar(batch, first, last, p, out);
+}
+
+} // namespace ds_pba
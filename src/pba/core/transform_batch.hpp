@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace ds_pba {
+
+// Instance transforms in structure-of-arrays layout, so the SIMD kernels load one component of
+// eight (AVX2) or four (NEON) instances with a single instruction.
+struct TransformBatch {
+    std::vector<float> px{}, py{}, pz{};       // translation
+    std::vector<float> qx{}, qy{}, qz{}, qw{}; // unit rotation quaternion
+    std::vector<float> sx{}, sy{}, sz{};       // per-axis scale
+
+    void resize(std::size_t count);
+    [[nodiscard]] std::size_t size() const noexcept { return px.size(); }
+};
+
+enum class TransformKernel : std::uint8_t { scalar, avx2, neon };
+
+[[nodiscard]] const char *to_string(TransformKernel kernel) noexcept;
+
+// The widest kernel this build and CPU support; AVX2 is checked at runtime, NEON is part of every
+// AArch64 CPU.
+[[nodiscard]] TransformKernel best_transform_kernel() noexcept;
+
+// For every instance i in [first, last), writes the top three rows of T(p) * R(q) * S(s) * post,
+// row-major, to out[12 * i, 12 * i + 12): the packed 3x4 model matrix cube.vert reads. `post`
+// must be affine. Safe to call concurrently on disjoint ranges. An unsupported `kernel` falls
+// back to scalar.
+void compose_transforms(const TransformBatch &batch, std::uint32_t first, std::uint32_t last, const glm::mat4 &post,
+                        float *out, TransformKernel kernel = best_transform_kernel());
+
+} // namespace ds_pba
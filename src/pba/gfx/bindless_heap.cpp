@@ -0,0 +1,176 @@
+#include "pba/gfx/bindless_heap.hpp"
+
+#include <array>
+#include <stdexcept>
+#include <string>
+
+namespace ds_pba {
+namespace {
+
+void vk_check(VkResult r, const char *what) {
+    if (r != VK_SUCCESS) {
+        throw std::runtime_error(std::string{what} + " (VkResult=" + std::to_string(static_cast<int>(r)) + ")");
+    }
+}
+
+} // namespace
+
+std::uint32_t BindlessHeap::Slots::acquire(const char *what) {
+    std::uint32_t slot = 0;
+    if (!free.empty()) {
+        slot = free.back();
+        free.pop_back();
+    } else if (next < capacity) {
+        slot = next++;
+    } else {
+        throw std::runtime_error(std::string{"BindlessHeap: out of "} + what + " slots (" +
+                                 std::to_string(capacity) + ")");
+    }
+    ++live;
+    return slot;
+}
+
+void BindlessHeap::Slots::release(std::uint32_t slot) {
+    if (slot == k_invalid_slot) {
+        return;
+    }
+    free.push_back(slot);
+    --live;
+}
+
+BindlessHeap::~BindlessHeap() {
+    destroy();
+}
+
+void BindlessHeap::init(VkDevice device, VkShaderStageFlags stages, std::uint32_t max_buffers,
+                        std::uint32_t max_images) {
+    device_ = device;
+
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    bindings[k_buffer_binding].binding = k_buffer_binding;
+    bindings[k_buffer_binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[k_buffer_binding].descriptorCount = max_buffers;
+    bindings[k_buffer_binding].stageFlags = stages;
+    bindings[k_buffer_binding].pImmutableSamplers = nullptr;
+    bindings[k_image_binding].binding = k_image_binding;
+    bindings[k_image_binding].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[k_image_binding].descriptorCount = max_images; // upper bound; the set gets its own count
+    bindings[k_image_binding].stageFlags = stages;
+    bindings[k_image_binding].pImmutableSamplers = nullptr;
+
+    constexpr VkDescriptorBindingFlags k_common =
+        VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+    const std::array<VkDescriptorBindingFlags, 2> binding_flags = {
+        k_common, k_common | VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT};
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bfci{};
+    bfci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    bfci.pNext = nullptr;
+    bfci.bindingCount = static_cast<std::uint32_t>(binding_flags.size());
+    bfci.pBindingFlags = binding_flags.data();
+
+    VkDescriptorSetLayoutCreateInfo lci{};
+    lci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    lci.pNext = &bfci;
+    lci.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    lci.bindingCount = static_cast<std::uint32_t>(bindings.size());
+    lci.pBindings = bindings.data();
+    vk_check(vkCreateDescriptorSetLayout(device_, &lci, nullptr, &layout_), "vkCreateDescriptorSetLayout(bindless)");
+
+    const std::array<VkDescriptorPoolSize, 2> sizes = {
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, max_buffers},
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, max_images},
+    };
+
+    VkDescriptorPoolCreateInfo pci{};
+    pci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pci.pNext = nullptr;
+    pci.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    pci.maxSets = 1;
+    pci.poolSizeCount = static_cast<std::uint32_t>(sizes.size());
+    pci.pPoolSizes = sizes.data();
+    vk_check(vkCreateDescriptorPool(device_, &pci, nullptr, &pool_), "vkCreateDescriptorPool(bindless)");
+
+    VkDescriptorSetVariableDescriptorCountAllocateInfo vci{};
+    vci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO;
+    vci.pNext = nullptr;
+    vci.descriptorSetCount = 1;
+    vci.pDescriptorCounts = &max_images;
+
+    VkDescriptorSetAllocateInfo ai{};
+    ai.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    ai.pNext = &vci;
+    ai.descriptorPool = pool_;
+    ai.descriptorSetCount = 1;
+    ai.pSetLayouts = &layout_;
+    vk_check(vkAllocateDescriptorSets(device_, &ai, &set_), "vkAllocateDescriptorSets(bindless)");
+
+    buffers_ = Slots{};
+    buffers_.capacity = max_buffers;
+    images_ = Slots{};
+    images_.capacity = max_images;
+}
+
+void BindlessHeap::destroy() {
+    if (pool_) {
+        vkDestroyDescriptorPool(device_, pool_, nullptr);
+        pool_ = VK_NULL_HANDLE;
+    }
+    if (layout_) {
+        vkDestroyDescriptorSetLayout(device_, layout_, nullptr);
+        layout_ = VK_NULL_HANDLE;
+    }
+    set_ = VK_NULL_HANDLE;
+    buffers_ = Slots{};
+    images_ = Slots{};
+}
+
+std::uint32_t BindlessHeap::add_buffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+    const std::uint32_t slot = buffers_.acquire("buffer");
+
+    const VkDescriptorBufferInfo dbi{buffer, offset, range};
+
+    VkWriteDescriptorSet w{};
+    w.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    w.pNext = nullptr;
+    w.dstSet = set_;
+    w.dstBinding = k_buffer_binding;
+    w.dstArrayElement = slot;
+    w.descriptorCount = 1;
+    w.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    w.pImageInfo = nullptr;
+    w.pBufferInfo = &dbi;
+    w.pTexelBufferView = nullptr;
+    vkUpdateDescriptorSets(device_, 1, &w, 0, nullptr);
+    return slot;
+}
+
+std::uint32_t BindlessHeap::add_image(VkImageView view, VkSampler sampler, VkImageLayout layout) {
+    const std::uint32_t slot = images_.acquire("image");
+
+    const VkDescriptorImageInfo dii{sampler, view, layout};
+
+    VkWriteDescriptorSet w{};
+    w.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    w.pNext = nullptr;
+    w.dstSet = set_;
+    w.dstBinding = k_image_binding;
+    w.dstArrayElement = slot;
+    w.descriptorCount = 1;
+    w.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    w.pImageInfo = &dii;
+    w.pBufferInfo = nullptr;
+    w.pTexelBufferView = nullptr;
+    vkUpdateDescriptorSets(device_, 1, &w, 0, nullptr);
+    return slot;
+}
+
+void BindlessHeap::release_buffer(std::uint32_t slot) {
+    buffers_.release(slot);
+}
+
+void BindlessHeap::release_image(std::uint32_t slot) {
+    images_.release(slot);
+}
+
+} // namespace ds_pba
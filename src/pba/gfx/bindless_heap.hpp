@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace ds_pba {
+
+// One global descriptor set that every pipeline binds once as set 0: a runtime array of storage
+// buffers and one of combined image samplers. Shaders reach a resource through the slot it was
+// added at, passed in push constants or read from another buffer, so more objects or materials
+// never mean more descriptor sets to allocate or bind.
+//
+// Both bindings are UPDATE_AFTER_BIND and PARTIALLY_BOUND: free slots can be written while frames
+// using other slots are in flight, and slots nobody references need no valid descriptor. The
+// image array is the variable-count binding, sized when the set is allocated.
+//
+// Needs the Vulkan 1.2 descriptor indexing features runtimeDescriptorArray,
+// descriptorBindingPartiallyBound, descriptorBindingVariableDescriptorCount and
+// descriptorBinding{StorageBuffer,SampledImage}UpdateAfterBind.
+class BindlessHeap final {
+public:
+    static constexpr std::uint32_t k_buffer_binding = 0;
+    static constexpr std::uint32_t k_image_binding = 1;
+    static constexpr std::uint32_t k_invalid_slot = UINT32_MAX;
+
+    BindlessHeap() = default;
+    ~BindlessHeap();
+
+    BindlessHeap(const BindlessHeap &) = delete;
+    BindlessHeap &operator=(const BindlessHeap &) = delete;
+
+    // `stages` are the shader stages that may index the heap. Throws std::runtime_error on failure.
+    void init(VkDevice device, VkShaderStageFlags stages, std::uint32_t max_buffers, std::uint32_t max_images);
+    // The GPU must be done with the set.
+    void destroy();
+
+    [[nodiscard]] VkDescriptorSetLayout layout() const noexcept { return layout_; }
+    [[nodiscard]] VkDescriptorSet set() const noexcept { return set_; }
+
+    // Write the descriptor into a free slot and return it. Throws std::runtime_error when full.
+    [[nodiscard]] std::uint32_t add_buffer(VkBuffer buffer, VkDeviceSize offset = 0,
+                                           VkDeviceSize range = VK_WHOLE_SIZE);
+    [[nodiscard]] std::uint32_t add_image(VkImageView view, VkSampler sampler, VkImageLayout layout);
+
+    // Return a slot for reuse. No submitted work that has not completed may still index it, so
+    // release from a deferred deletion rather than while frames using it are in flight.
+    // k_invalid_slot is ignored.
+    void release_buffer(std::uint32_t slot);
+    void release_image(std::uint32_t slot);
+
+    [[nodiscard]] std::uint32_t buffer_capacity() const noexcept { return buffers_.capacity; }
+    [[nodiscard]] std::uint32_t image_capacity() const noexcept { return images_.capacity; }
+    [[nodiscard]] std::uint32_t live_buffers() const noexcept { return buffers_.live; }
+    [[nodiscard]] std::uint32_t live_images() const noexcept { return images_.live; }
+
+private:
+    // Free list over [0, capacity); never-used slots are handed out from `next` first.
+    struct Slots {
+        std::uint32_t capacity{0};
+        std::uint32_t next{0};
+        std::uint32_t live{0};
+        std::vector<std::uint32_t> free{};
+
+        [[nodiscard]] std::uint32_t acquire(const char *what);
+        void release(std::uint32_t slot);
+    };
+
+    VkDevice device_{VK_NULL_HANDLE};
+    VkDescriptorSetLayout layout_{VK_NULL_HANDLE};
+    VkDescriptorPool pool_{VK_NULL_HANDLE};
+    VkDescriptorSet set_{VK_NULL_HANDLE};
+    Slots buffers_{};
+    Slots images_{};
+};
+
+} // namespace ds_pba
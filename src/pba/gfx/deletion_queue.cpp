@@ -0,0 +1,29 @@
+#include "pba/gfx/deletion_queue.hpp"
+
+#include <utility>
+
+namespace ds_pba {
+
+void DeletionQueue::push(std::uint64_t serial, std::function<void()> destroy) {
+    // Serials only grow, so the deque stays sorted and flush() can stop at the first miss.
+    entries_.push_back(Entry{serial, std::move(destroy)});
+}
+
+void DeletionQueue::flush(std::uint64_t completed_serial) {
+    while (!entries_.empty() && entries_.front().serial <= completed_serial) {
+        // Pop before running so a destroy callback may safely retire further objects.
+        std::function<void()> destroy = std::move(entries_.front().destroy);
+        entries_.pop_front();
+        destroy();
+    }
+}
+
+void DeletionQueue::flush_all() {
+    while (!entries_.empty()) {
+        std::function<void()> destroy = std::move(entries_.front().destroy);
+        entries_.pop_front();
+        destroy();
+    }
+}
+
+} // namespace ds_pba
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+namespace ds_pba {
+
+// Defers destruction of GPU objects until the submission that last used them has completed.
+//
+// Every queue submission gets a monotonically increasing serial. Callers retire a resource
+// under the serial of the newest submission that may still reference it and later report the
+// highest serial known to have finished (e.g. after a frame timeline wait); every entry at or
+// below that serial is then destroyed in retirement order.
+class DeletionQueue final {
+public:
+    DeletionQueue() = default;
+    ~DeletionQueue() = default;
+
+    DeletionQueue(const DeletionQueue &) = delete;
+    DeletionQueue &operator=(const DeletionQueue &) = delete;
+
+    void push(std::uint64_t serial, std::function<void()> destroy);
+
+    // Runs every entry whose serial is <= completed_serial.
+    void flush(std::uint64_t completed_serial);
+
+    // Runs everything; only valid once the device is idle.
+    void flush_all();
+
+    [[nodiscard]] std::size_t size() const noexcept { return entries_.size(); }
+
+private:
+    struct Entry {
+        std::uint64_t serial{0};
+        std::function<void()> destroy{};
+    };
+
+    std::deque<Entry> entries_{};
+};
+
+} // namespace ds_pba
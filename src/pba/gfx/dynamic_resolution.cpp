@@ -0,0 +1,67 @@
+#include "pba/gfx/dynamic_resolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ds_pba {
+namespace {
+
+// Exponential smoothing of the GPU time; absorbs single-frame spikes.
+constexpr float k_smoothing = 0.2f;
+// Shrinking aims for this fraction of the budget; growing starts below k_grow_below.
+constexpr float k_aim = 0.9f;
+constexpr float k_grow_below = 0.75f;
+constexpr float k_max_grow_step = 0.05f;
+// Scales are snapped to 1/64 so tiny corrections do not change the render size every frame.
+constexpr float k_scale_quantum = 64.0f;
+// Covers frames_in_flight of timings measured at the previous scale.
+constexpr std::uint32_t k_cooldown_frames = 8;
+
+} // namespace
+
+void DynamicResolution::set_target_ms(float ms) noexcept {
+    target_ms_ = std::max(ms, 0.0f);
+    if (!enabled()) {
+        reset();
+    }
+}
+
+float DynamicResolution::update(float gpu_ms) noexcept {
+    if (!enabled() || gpu_ms <= 0.0f) {
+        return scale_;
+    }
+
+    smoothed_ms_ = (smoothed_ms_ > 0.0f) ? smoothed_ms_ + k_smoothing * (gpu_ms - smoothed_ms_) : gpu_ms;
+    if (cooldown_ > 0u) {
+        --cooldown_;
+        return scale_;
+    }
+
+    const float load = smoothed_ms_ / target_ms_;
+    if (load <= 1.0f && load >= k_grow_below) {
+        return scale_;
+    }
+
+    float next = scale_ * std::sqrt(k_aim / load);
+    if (load < k_grow_below) {
+        next = std::min(next, scale_ + k_max_grow_step);
+    }
+    next = std::clamp(std::round(next * k_scale_quantum) / k_scale_quantum, k_min_scale, 1.0f);
+    if (next == scale_) {
+        return scale_;
+    }
+
+    // Predict the time at the new scale so the smoothing does not restart from stale samples.
+    smoothed_ms_ *= (next * next) / (scale_ * scale_);
+    scale_ = next;
+    cooldown_ = k_cooldown_frames;
+    return scale_;
+}
+
+void DynamicResolution::reset() noexcept {
+    scale_ = 1.0f;
+    smoothed_ms_ = 0.0f;
+    cooldown_ = 0;
+}
+
+} // namespace ds_pba
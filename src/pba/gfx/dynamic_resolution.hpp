@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ds_pba {
+
+// Picks the offscreen render scale from measured GPU time so the pass stays within a budget.
+//
+// The pass cost is taken to be proportional to its pixel count (scale^2): over budget the scale
+// drops straight to the estimate that lands just under it, while spare time only grows it in
+// small steps. Between the two thresholds nothing changes, and after every change the
+// controller waits a few frames so timings still in flight for the old scale are not acted on.
+class DynamicResolution final {
+public:
+    static constexpr float k_min_scale = 0.5f;
+
+    // 0 disables the controller and pins the scale to 1.
+    void set_target_ms(float ms) noexcept;
+    [[nodiscard]] float target_ms() const noexcept { return target_ms_; }
+    [[nodiscard]] bool enabled() const noexcept { return target_ms_ > 0.0f; }
+
+    // Feeds one frame's GPU time for the scaled pass; returns the scale to render the next
+    // frame at, in [k_min_scale, 1].
+    float update(float gpu_ms) noexcept;
+    void reset() noexcept;
+
+    [[nodiscard]] float scale() const noexcept { return scale_; }
+    [[nodiscard]] float smoothed_ms() const noexcept { return smoothed_ms_; }
+
+private:
+    float target_ms_{0.0f};
+    float scale_{1.0f};
+    float smoothed_ms_{0.0f};
+    std::uint32_t cooldown_{0};
+};
+
+} // namespace ds_pba
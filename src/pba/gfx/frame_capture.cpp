@@ -0,0 +1,311 @@
+#include "pba/gfx/frame_capture.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace ds_pba {
+namespace {
+
+[[nodiscard]] constexpr std::array<std::uint32_t, 256> make_crc32_table() noexcept {
+    std::array<std::uint32_t, 256> table{};
+    for (std::uint32_t n = 0; n < 256u; ++n) {
+        std::uint32_t c = n;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1u) != 0u ? (0xEDB88320u ^ (c >> 1u)) : (c >> 1u);
+        }
+        table[n] = c;
+    }
+    return table;
+}
+
+constexpr std::array<std::uint32_t, 256> k_crc32_table = make_crc32_table();
+
+[[nodiscard]] std::uint32_t crc32_update(std::uint32_t crc, const std::uint8_t *data, std::size_t size) noexcept {
+    for (std::size_t i = 0; i < size; ++i) {
+        crc = k_crc32_table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8u);
+    }
+    return crc;
+}
+
+void put_be32(std::vector<std::uint8_t> &out, std::uint32_t v) {
+    out.push_back(static_cast<std::uint8_t>(v >> 24u));
+    out.push_back(static_cast<std::uint8_t>(v >> 16u));
+    out.push_back(static_cast<std::uint8_t>(v >> 8u));
+    out.push_back(static_cast<std::uint8_t>(v));
+}
+
+void put_chunk(std::vector<std::uint8_t> &out, const char (&type)[5], const std::uint8_t *data, std::size_t size) {
+    put_be32(out, static_cast<std::uint32_t>(size));
+    const std::size_t type_at = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + size);
+    const std::uint32_t crc = crc32_update(0xFFFFFFFFu, out.data() + type_at, size + 4u) ^ 0xFFFFFFFFu;
+    put_be32(out, crc);
+}
+
+// RGBA8 PNG with a zlib stream of stored (uncompressed) deflate blocks. Files are ~4 bytes per
+// pixel, but encoding is a copy plus two checksums, which keeps the writer ahead of 60 Hz.
+void encode_png(const CapturedFrame &frame, std::vector<std::uint8_t> &out) {
+    constexpr std::size_t k_max_stored = 65535;
+    const std::size_t row_bytes = static_cast<std::size_t>(frame.width) * 4u;
+    const std::size_t raw_size = (row_bytes + 1u) * frame.height; // filter byte per row
+
+    out.clear();
+    out.reserve(raw_size + raw_size / k_max_stored * 5u + 128u);
+
+    constexpr std::array<std::uint8_t, 8> k_signature = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    out.insert(out.end(), k_signature.begin(), k_signature.end());
+
+    std::array<std::uint8_t, 13> ihdr{};
+    ihdr[0] = static_cast<std::uint8_t>(frame.width >> 24u);
+    ihdr[1] = static_cast<std::uint8_t>(frame.width >> 16u);
+    ihdr[2] = static_cast<std::uint8_t>(frame.width >> 8u);
+    ihdr[3] = static_cast<std::uint8_t>(frame.width);
+    ihdr[4] = static_cast<std::uint8_t>(frame.height >> 24u);
+    ihdr[5] = static_cast<std::uint8_t>(frame.height >> 16u);
+    ihdr[6] = static_cast<std::uint8_t>(frame.height >> 8u);
+    ihdr[7] = static_cast<std::uint8_t>(frame.height);
+    ihdr[8] = 8; // bit depth
+    ihdr[9] = 6; // color type: RGBA
+    put_chunk(out, "IHDR", ihdr.data(), ihdr.size());
+
+    // IDAT is assembled in place: length and type first, payload streamed, then the CRC.
+    const std::size_t idat_at = out.size();
+    put_be32(out, 0);
+    out.insert(out.end(), {'I', 'D', 'A', 'T'});
+    out.push_back(0x78); // zlib: deflate, 32K window
+    out.push_back(0x01); // no preset dictionary, fastest; header is a multiple of 31
+
+    std::uint32_t adler_a = 1;
+    std::uint32_t adler_b = 0;
+    std::size_t block_left = 0;
+    std::size_t remaining = raw_size;
+
+    const auto emit = [&](const std::uint8_t *data, std::size_t size) {
+        while (size > 0u) {
+            if (block_left == 0u) {
+                block_left = std::min(remaining, k_max_stored);
+                remaining -= block_left;
+                const auto len = static_cast<std::uint16_t>(block_left);
+                const auto nlen = static_cast<std::uint16_t>(~len);
+                out.push_back(remaining == 0u ? 1u : 0u); // BFINAL, BTYPE = stored
+                out.push_back(static_cast<std::uint8_t>(len));
+                out.push_back(static_cast<std::uint8_t>(len >> 8u));
+                out.push_back(static_cast<std::uint8_t>(nlen));
+                out.push_back(static_cast<std::uint8_t>(nlen >> 8u));
+            }
+            const std::size_t n = std::min(size, block_left);
+            out.insert(out.end(), data, data + n);
+            for (std::size_t i = 0; i < n; ++i) {
+                adler_a = (adler_a + data[i]) % 65521u;
+                adler_b = (adler_b + adler_a) % 65521u;
+            }
+            data += n;
+            size -= n;
+            block_left -= n;
+        }
+    };
+
+    constexpr std::uint8_t k_filter_none = 0;
+    for (std::uint32_t y = 0; y < frame.height; ++y) {
+        emit(&k_filter_none, 1);
+        emit(frame.rgba.data() + static_cast<std::size_t>(y) * row_bytes, row_bytes);
+    }
+    put_be32(out, (adler_b << 16u) | adler_a);
+
+    const std::size_t idat_size = out.size() - idat_at - 8u;
+    out[idat_at + 0] = static_cast<std::uint8_t>(idat_size >> 24u);
+    out[idat_at + 1] = static_cast<std::uint8_t>(idat_size >> 16u);
+    out[idat_at + 2] = static_cast<std::uint8_t>(idat_size >> 8u);
+    out[idat_at + 3] = static_cast<std::uint8_t>(idat_size);
+    const std::uint32_t crc = crc32_update(0xFFFFFFFFu, out.data() + idat_at + 4u, idat_size + 4u) ^ 0xFFFFFFFFu;
+    put_be32(out, crc);
+
+    put_chunk(out, "IEND", nullptr, 0);
+}
+
+[[nodiscard]] bool write_file(const std::filesystem::path &path, const std::uint8_t *data, std::size_t size) {
+    std::FILE *f = std::fopen(path.string().c_str(), "wb");
+    if (!f) {
+        return false;
+    }
+    const bool ok = std::fwrite(data, 1, size, f) == size;
+    return (std::fclose(f) == 0) && ok;
+}
+
+[[nodiscard]] std::filesystem::path frame_path(const std::filesystem::path &dir, std::uint64_t index,
+                                               const char *ext) {
+    std::array<char, 32> name{};
+    std::snprintf(name.data(), name.size(), "frame_%06llu.%s", static_cast<unsigned long long>(index), ext);
+    return dir / name.data();
+}
+
+[[nodiscard]] std::uint8_t to_u8(float v) noexcept {
+    return static_cast<std::uint8_t>(std::clamp(std::lround(v), 0L, 255L));
+}
+
+} // namespace
+
+const char *to_string(CaptureFormat format) noexcept {
+    switch (format) {
+        case CaptureFormat::raw:
+            return "raw";
+        case CaptureFormat::png:
+            return "png";
+        case CaptureFormat::y4m:
+            return "y4m";
+    }
+    return "unknown";
+}
+
+FrameCapture::FrameCapture(std::size_t max_queued) : max_queued_{std::max<std::size_t>(1, max_queued)} {
+}
+
+FrameCapture::~FrameCapture() {
+    stop();
+}
+
+void FrameCapture::start(const std::filesystem::path &directory, CaptureFormat format) {
+    stop();
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        throw std::runtime_error("Failed to create capture directory " + directory.string() + ": " + ec.message());
+    }
+
+    directory_ = directory;
+    format_ = format;
+    stop_ = false;
+    written_.store(0, std::memory_order_relaxed);
+    dropped_.store(0, std::memory_order_relaxed);
+    failed_.store(0, std::memory_order_relaxed);
+
+    writer_ = std::thread([this]() { writer_main(); });
+    active_ = true;
+}
+
+void FrameCapture::stop() {
+    if (!active_) {
+        return;
+    }
+    {
+        const std::lock_guard<std::mutex> lock{mutex_};
+        stop_ = true;
+    }
+    wake_.notify_one();
+    writer_.join();
+    active_ = false;
+}
+
+std::vector<std::uint8_t> FrameCapture::take_buffer() {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    if (free_buffers_.empty()) {
+        return {};
+    }
+    std::vector<std::uint8_t> buf = std::move(free_buffers_.back());
+    free_buffers_.pop_back();
+    return buf;
+}
+
+bool FrameCapture::submit(CapturedFrame &&frame) {
+    {
+        const std::lock_guard<std::mutex> lock{mutex_};
+        if (!active_ || queue_.size() >= max_queued_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            free_buffers_.push_back(std::move(frame.rgba));
+            return false;
+        }
+        queue_.push_back(std::move(frame));
+    }
+    wake_.notify_one();
+    return true;
+}
+
+void FrameCapture::writer_main() {
+    for (;;) {
+        CapturedFrame frame{};
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+            wake_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                break; // stop requested and fully drained
+            }
+            frame = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        if (write_frame(frame)) {
+            written_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            failed_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        const std::lock_guard<std::mutex> lock{mutex_};
+        free_buffers_.push_back(std::move(frame.rgba));
+    }
+
+    if (y4m_) {
+        std::fclose(y4m_);
+        y4m_ = nullptr;
+    }
+}
+
+bool FrameCapture::write_frame(const CapturedFrame &frame) {
+    const std::size_t expected = static_cast<std::size_t>(frame.width) * frame.height * 4u;
+    if (frame.width == 0u || frame.height == 0u || frame.rgba.size() < expected) {
+        return false;
+    }
+
+    switch (format_) {
+        case CaptureFormat::raw:
+            return write_file(frame_path(directory_, frame.index, "rgba"), frame.rgba.data(), expected);
+        case CaptureFormat::png:
+            encode_png(frame, scratch_);
+            return write_file(frame_path(directory_, frame.index, "png"), scratch_.data(), scratch_.size());
+        case CaptureFormat::y4m:
+            return write_y4m_frame(frame);
+    }
+    return false;
+}
+
+bool FrameCapture::write_y4m_frame(const CapturedFrame &frame) {
+    if (!y4m_) {
+        y4m_ = std::fopen((directory_ / "capture.y4m").string().c_str(), "wb");
+        if (!y4m_) {
+            return false;
+        }
+        y4m_width_ = frame.width;
+        y4m_height_ = frame.height;
+        // Nominal 60 fps; y4m carries no timestamps.
+        std::fprintf(y4m_, "YUV4MPEG2 W%u H%u F60:1 Ip A1:1 C444\n", y4m_width_, y4m_height_);
+    }
+    // A stream has one resolution; frames rendered after a resize are skipped.
+    if (frame.width != y4m_width_ || frame.height != y4m_height_) {
+        return false;
+    }
+
+    // Full-range BT.601, planar Y, Cb, Cr.
+    const std::size_t pixels = static_cast<std::size_t>(frame.width) * frame.height;
+    scratch_.resize(pixels * 3u);
+    std::uint8_t *y_plane = scratch_.data();
+    std::uint8_t *u_plane = y_plane + pixels;
+    std::uint8_t *v_plane = u_plane + pixels;
+    for (std::size_t i = 0; i < pixels; ++i) {
+        const float r = frame.rgba[i * 4u + 0u];
+        const float g = frame.rgba[i * 4u + 1u];
+        const float b = frame.rgba[i * 4u + 2u];
+        y_plane[i] = to_u8(0.299f * r + 0.587f * g + 0.114f * b);
+        u_plane[i] = to_u8(128.0f - 0.168736f * r - 0.331264f * g + 0.5f * b);
+        v_plane[i] = to_u8(128.0f + 0.5f * r - 0.418688f * g - 0.081312f * b);
+    }
+
+    return std::fputs("FRAME\n", y4m_) >= 0 && std::fwrite(scratch_.data(), 1, scratch_.size(), y4m_) == scratch_.size();
+}
+
+} // namespace ds_pba
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ds_pba {
+
+enum class CaptureFormat : std::uint8_t {
+    raw, // one headerless RGBA8 file per frame
+    png, // one PNG per frame (uncompressed deflate, so encoding stays cheap)
+    y4m, // a single YUV4MPEG2 4:4:4 stream, playable by ffmpeg/mpv
+};
+
+[[nodiscard]] const char *to_string(CaptureFormat format) noexcept;
+
+struct CapturedFrame {
+    std::uint64_t index{0};
+    std::uint32_t width{0};
+    std::uint32_t height{0};
+    std::vector<std::uint8_t> rgba{}; // tightly packed, width * height * 4 bytes
+};
+
+// Encodes and writes captured frames on a background thread so the render thread only pays
+// for a memcpy out of the readback buffer.
+//
+// submit() never blocks: when the writer falls behind by more than `max_queued` frames the
+// frame is dropped and counted instead, because stalling the render loop would distort the very
+// timings a capture is meant to record. Pixel buffers are recycled through take_buffer().
+class FrameCapture final {
+public:
+    explicit FrameCapture(std::size_t max_queued = 8);
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture &) = delete;
+    FrameCapture &operator=(const FrameCapture &) = delete;
+
+    // Creates `directory` and starts the writer thread. Throws std::runtime_error on failure.
+    void start(const std::filesystem::path &directory, CaptureFormat format);
+    // Writes everything still queued, then joins the writer. No-op when not active.
+    void stop();
+
+    [[nodiscard]] bool active() const noexcept { return active_; }
+    [[nodiscard]] CaptureFormat format() const noexcept { return format_; }
+    [[nodiscard]] const std::filesystem::path &directory() const noexcept { return directory_; }
+
+    // Returns a previously written frame's buffer (capacity kept) or an empty one.
+    [[nodiscard]] std::vector<std::uint8_t> take_buffer();
+    // Returns false if the frame was dropped.
+    bool submit(CapturedFrame &&frame);
+
+    [[nodiscard]] std::uint64_t written() const noexcept { return written_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t failed() const noexcept { return failed_.load(std::memory_order_relaxed); }
+
+private:
+    void writer_main();
+    [[nodiscard]] bool write_frame(const CapturedFrame &frame);
+    [[nodiscard]] bool write_y4m_frame(const CapturedFrame &frame);
+
+    std::size_t max_queued_;
+    bool active_{false};
+    CaptureFormat format_{CaptureFormat::png};
+    std::filesystem::path directory_{};
+
+    std::thread writer_{};
+    std::mutex mutex_{};
+    std::condition_variable wake_{};
+    std::deque<CapturedFrame> queue_{};
+    std::vector<std::vector<std::uint8_t>> free_buffers_{};
+    bool stop_{false};
+
+    // Writer-thread only.
+    std::FILE *y4m_{nullptr};
+    std::uint32_t y4m_width_{0};
+    std::uint32_t y4m_height_{0};
+    std::vector<std::uint8_t> scratch_{};
+
+    std::atomic<std::uint64_t> written_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> failed_{0};
+};
+
+} // namespace ds_pba
@@ -0,0 +1,77 @@
+#include "pba/gfx/frame_pacer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+namespace ds_pba {
+namespace {
+
+void vk_check(VkResult r, const char *what) {
+    if (r != VK_SUCCESS) {
+        throw std::runtime_error(std::string{what} + " (VkResult=" + std::to_string(static_cast<int>(r)) + ")");
+    }
+}
+
+} // namespace
+
+FramePacer::~FramePacer() {
+    destroy();
+}
+
+void FramePacer::init(VkDevice device) {
+    device_ = device;
+
+    VkSemaphoreTypeCreateInfo tci{};
+    tci.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    tci.pNext = nullptr;
+    tci.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    tci.initialValue = 0;
+
+    VkSemaphoreCreateInfo sci{};
+    sci.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    sci.pNext = &tci;
+    sci.flags = 0;
+    vk_check(vkCreateSemaphore(device_, &sci, nullptr, &semaphore_), "vkCreateSemaphore(frame_timeline)");
+
+    submitted_ = 0;
+    completed_ = 0;
+}
+
+void FramePacer::destroy() {
+    if (semaphore_) {
+        vkDestroySemaphore(device_, semaphore_, nullptr);
+        semaphore_ = VK_NULL_HANDLE;
+    }
+}
+
+std::uint64_t FramePacer::completed() {
+    std::uint64_t value = 0;
+    vk_check(vkGetSemaphoreCounterValue(device_, semaphore_, &value), "vkGetSemaphoreCounterValue(frame)");
+    completed_ = std::max(completed_, value);
+    return completed_;
+}
+
+float FramePacer::wait(std::uint64_t value) {
+    if (value <= completed_ || value <= completed()) {
+        return 0.0f;
+    }
+
+    VkSemaphoreWaitInfo wi{};
+    wi.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    wi.pNext = nullptr;
+    wi.flags = 0;
+    wi.semaphoreCount = 1;
+    wi.pSemaphores = &semaphore_;
+    wi.pValues = &value;
+
+    const auto begin = std::chrono::steady_clock::now();
+    vk_check(vkWaitSemaphores(device_, &wi, UINT64_MAX), "vkWaitSemaphores(frame)");
+    const float waited = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    completed_ = std::max(completed_, value);
+    return waited;
+}
+
+} // namespace ds_pba
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+
+#include <vulkan/vulkan.h>
+
+namespace ds_pba {
+
+// Frame pacing on a single timeline semaphore that every graphics submission signals.
+//
+// Submission N signals value N, so "has frame N finished on the GPU" is a counter read instead of
+// a per-slot fence, and any CPU code (deletion, readback, uploads) can wait on an exact frame.
+// wait() blocks on a value and reports how long the CPU actually stalled; latency_target() turns
+// a bound on queued frames into the value to wait for.
+class FramePacer final {
+public:
+    FramePacer() = default;
+    ~FramePacer();
+
+    FramePacer(const FramePacer &) = delete;
+    FramePacer &operator=(const FramePacer &) = delete;
+
+    // Throws std::runtime_error on failure.
+    void init(VkDevice device);
+    // The GPU must be done with the semaphore.
+    void destroy();
+
+    [[nodiscard]] VkSemaphore semaphore() const noexcept { return semaphore_; }
+
+    // Reserves the value the next graphics submission signals.
+    [[nodiscard]] std::uint64_t next_signal() noexcept { return ++submitted_; }
+    [[nodiscard]] std::uint64_t submitted() const noexcept { return submitted_; }
+    // Queries the semaphore; never blocks.
+    [[nodiscard]] std::uint64_t completed();
+
+    // Blocks until the GPU has reached `value`. Returns the time spent blocked in ms, 0 when the
+    // value had already been reached.
+    float wait(std::uint64_t value);
+
+    // The value to wait for before recording a new frame so that, once it is submitted, at most
+    // `max_in_flight` frames are queued on the GPU.
+    [[nodiscard]] std::uint64_t latency_target(std::uint32_t max_in_flight) const noexcept {
+        return submitted_ >= max_in_flight ? submitted_ + 1u - max_in_flight : 0u;
+    }
+
+private:
+    VkDevice device_{VK_NULL_HANDLE};
+    VkSemaphore semaphore_{VK_NULL_HANDLE};
+    std::uint64_t submitted_{0};
+    // Highest value seen complete; skips the query for values already known to be done.
+    std::uint64_t completed_{0};
+};
+
+} // namespace ds_pba
@@ -0,0 +1,83 @@
+#include "pba/gfx/frame_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace ds_pba {
+
+RollingStats::RollingStats(std::size_t capacity) : samples_(capacity, 0.0f) {
+    if (capacity == 0) {
+        throw std::invalid_argument("RollingStats capacity must be > 0");
+    }
+    sorted_.reserve(capacity);
+}
+
+void RollingStats::push(float value) {
+    samples_[head_] = value;
+    head_ = (head_ + 1u) % samples_.size();
+    count_ = std::min(count_ + 1u, samples_.size());
+    sorted_valid_ = false;
+}
+
+void RollingStats::clear() noexcept {
+    head_ = 0;
+    count_ = 0;
+    sorted_valid_ = false;
+}
+
+float RollingStats::latest() const noexcept {
+    if (count_ == 0) {
+        return 0.0f;
+    }
+    return samples_[(head_ + samples_.size() - 1u) % samples_.size()];
+}
+
+float RollingStats::min() const noexcept {
+    if (count_ == 0) {
+        return 0.0f;
+    }
+    return *std::min_element(samples_.begin(), samples_.begin() + static_cast<std::ptrdiff_t>(count_));
+}
+
+float RollingStats::max() const noexcept {
+    if (count_ == 0) {
+        return 0.0f;
+    }
+    return *std::max_element(samples_.begin(), samples_.begin() + static_cast<std::ptrdiff_t>(count_));
+}
+
+float RollingStats::avg() const noexcept {
+    if (count_ == 0) {
+        return 0.0f;
+    }
+    double sum = 0.0;
+    for (std::size_t i = 0; i < count_; ++i) {
+        sum += static_cast<double>(samples_[i]);
+    }
+    return static_cast<float>(sum / static_cast<double>(count_));
+}
+
+float RollingStats::percentile(float p) const {
+    if (count_ == 0) {
+        return 0.0f;
+    }
+
+    // Sorted once per push, so every percentile read until the next sample is a lookup.
+    if (!sorted_valid_) {
+        sorted_.assign(samples_.begin(), samples_.begin() + static_cast<std::ptrdiff_t>(count_));
+        std::sort(sorted_.begin(), sorted_.end());
+        sorted_valid_ = true;
+    }
+    const float clamped = std::clamp(p, 0.0f, 1.0f);
+    const auto rank = static_cast<std::size_t>(std::ceil(clamped * static_cast<float>(count_)));
+    const std::size_t idx = (rank == 0) ? 0 : rank - 1u;
+    return sorted_[idx];
+}
+
+int RollingStats::plot_offset() const noexcept {
+    // Until the ring wraps the samples are already in order starting at 0.
+    return (count_ < samples_.size()) ? 0 : static_cast<int>(head_);
+}
+
+} // namespace ds_pba
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace ds_pba {
+
+// Fixed-size window of the most recent samples (e.g. frame times in ms) with the summary
+// statistics shown in the Info window. Storage is a ring so it can be handed to
+// ImGui::PlotLines directly via data()/plot_offset().
+class RollingStats final {
+public:
+    explicit RollingStats(std::size_t capacity = 240);
+
+    void push(float value);
+    void clear() noexcept;
+
+    [[nodiscard]] std::size_t size() const noexcept { return count_; }
+    [[nodiscard]] bool empty() const noexcept { return count_ == 0; }
+
+    [[nodiscard]] float latest() const noexcept;
+    [[nodiscard]] float min() const noexcept;
+    [[nodiscard]] float max() const noexcept;
+    [[nodiscard]] float avg() const noexcept;
+
+    // Nearest-rank percentile, p in [0, 1]. Returns 0 when empty. The first call after a push
+    // sorts the window into a scratch buffer that later calls reuse, so reading several
+    // percentiles of one window sorts it once. Not safe to call concurrently.
+    [[nodiscard]] float percentile(float p) const;
+
+    [[nodiscard]] const float *data() const noexcept { return samples_.data(); }
+    [[nodiscard]] int plot_count() const noexcept { return static_cast<int>(count_); }
+    // Index of the oldest sample, as ImGui::PlotLines' values_offset expects.
+    [[nodiscard]] int plot_offset() const noexcept;
+
+private:
+    std::vector<float> samples_;
+    std::size_t head_{0};
+    std::size_t count_{0};
+    // The window sorted, valid until the next push() or clear().
+    mutable std::vector<float> sorted_{};
+    mutable bool sorted_valid_{false};
+};
+
+} // namespace ds_pba
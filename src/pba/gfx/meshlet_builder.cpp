@@ -0,0 +1,164 @@
+#include "pba/gfx/meshlet_builder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace ds_pba {
+namespace {
+
+// Below this spread of normals the cone is too wide to ever cull anything.
+constexpr float k_min_cone_dot = 0.1f;
+
+// Slack, relative to the meshlet radius, for rounding when checking the apex against the planes.
+constexpr float k_apex_epsilon = 1e-4f;
+
+void finish_meshlet(MeshletMesh &out, Meshlet &m, std::span<const glm::vec3> positions) {
+    const std::span<const std::uint32_t> verts{out.vertices.data() + m.vertex_offset, m.vertex_count};
+    const std::span<const std::uint32_t> tris{out.triangles.data() + m.triangle_offset, m.triangle_count};
+
+    // Sphere around the AABB center: not minimal, but cheap and never smaller than the meshlet.
+    glm::vec3 lo{positions[verts[0]]};
+    glm::vec3 hi{lo};
+    for (std::uint32_t v : verts) {
+        lo = glm::min(lo, positions[v]);
+        hi = glm::max(hi, positions[v]);
+    }
+    const glm::vec3 center = 0.5f * (lo + hi);
+    float radius = 0.0f;
+    for (std::uint32_t v : verts) {
+        radius = std::max(radius, glm::length(positions[v] - center));
+    }
+    m.sphere = glm::vec4(center, radius);
+
+    const auto corner = [&](std::uint32_t tri, std::uint32_t k) {
+        return positions[verts[(tri >> (8u * k)) & 0xffu]];
+    };
+
+    std::vector<glm::vec3> normals{};
+    normals.reserve(tris.size());
+    glm::vec3 axis{0.0f};
+    for (std::uint32_t tri : tris) {
+        const glm::vec3 n = glm::cross(corner(tri, 1) - corner(tri, 0), corner(tri, 2) - corner(tri, 0));
+        const float len = glm::length(n);
+        if (len > 0.0f) {
+            normals.push_back(n / len);
+            axis += n / len;
+        }
+    }
+
+    // Disabled unless every normal lies well within a common half space.
+    m.cone_axis = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    m.cone_apex = glm::vec4(center, 0.0f);
+    const float axis_len = glm::length(axis);
+    if (normals.empty() || axis_len <= 0.0f) {
+        return;
+    }
+    axis /= axis_len;
+
+    float min_dot = 1.0f;
+    for (const glm::vec3 &n : normals) {
+        min_dot = std::min(min_dot, glm::dot(axis, n));
+    }
+    if (min_dot <= k_min_cone_dot) {
+        return;
+    }
+
+    // Move the apex back along the axis until it is behind every triangle's plane
+    // (dot(apex - p0, n) <= 0), so the test holds for the visible side of every triangle, not just
+    // the center. Concave patches need the apex further back than convex ones.
+    float max_t = 0.0f;
+    std::size_t i = 0;
+    for (std::uint32_t tri : tris) {
+        const glm::vec3 e = glm::cross(corner(tri, 1) - corner(tri, 0), corner(tri, 2) - corner(tri, 0));
+        if (glm::length(e) <= 0.0f) {
+            continue;
+        }
+        const glm::vec3 &n = normals[i++];
+        const float t = glm::dot(center - corner(tri, 0), n) / glm::dot(axis, n);
+        max_t = std::max(max_t, t);
+    }
+    const glm::vec3 apex = center - axis * max_t;
+
+    // A cone whose apex is in front of any plane would cull visible triangles; keep it disabled.
+    const float slack = k_apex_epsilon * std::max(radius, 1.0f);
+    i = 0;
+    for (std::uint32_t tri : tris) {
+        const glm::vec3 e = glm::cross(corner(tri, 1) - corner(tri, 0), corner(tri, 2) - corner(tri, 0));
+        if (glm::length(e) <= 0.0f) {
+            continue;
+        }
+        if (glm::dot(apex - corner(tri, 0), normals[i++]) > slack) {
+            return;
+        }
+    }
+
+    m.cone_apex = glm::vec4(apex, 0.0f);
+    m.cone_axis = glm::vec4(axis, std::sqrt(1.0f - min_dot * min_dot));
+}
+
+} // namespace
+
+MeshletMesh build_meshlets(std::span<const glm::vec3> positions, std::span<const std::uint32_t> indices,
+                           const MeshletLimits &limits) {
+    if (indices.size() % 3u != 0u) {
+        throw std::invalid_argument("build_meshlets: index count must be a multiple of 3");
+    }
+    if (limits.max_vertices < 3u || limits.max_vertices > 256u || limits.max_triangles < 1u ||
+        limits.max_triangles > 256u) {
+        throw std::invalid_argument("build_meshlets: limits must be in [3, 256] vertices, [1, 256] triangles");
+    }
+
+    MeshletMesh out{};
+    // Source vertex -> local index in the open meshlet, UINT32_MAX when not in it.
+    std::vector<std::uint32_t> local(positions.size(), UINT32_MAX);
+
+    Meshlet m{};
+    const auto close = [&]() {
+        if (m.triangle_count == 0u) {
+            return;
+        }
+        finish_meshlet(out, m, positions);
+        out.meshlets.push_back(m);
+        for (std::uint32_t i = 0; i < m.vertex_count; ++i) {
+            local[out.vertices[m.vertex_offset + i]] = UINT32_MAX;
+        }
+        m = Meshlet{};
+        m.vertex_offset = static_cast<std::uint32_t>(out.vertices.size());
+        m.triangle_offset = static_cast<std::uint32_t>(out.triangles.size());
+    };
+
+    for (std::size_t t = 0; t < indices.size(); t += 3u) {
+        const std::uint32_t a = indices[t];
+        const std::uint32_t b = indices[t + 1u];
+        const std::uint32_t c = indices[t + 2u];
+        if (a >= positions.size() || b >= positions.size() || c >= positions.size()) {
+            throw std::invalid_argument("build_meshlets: index out of range");
+        }
+
+        const std::uint32_t new_vertices = (local[a] == UINT32_MAX ? 1u : 0u) +
+                                           (local[b] == UINT32_MAX && b != a ? 1u : 0u) +
+                                           (local[c] == UINT32_MAX && c != a && c != b ? 1u : 0u);
+        if (m.vertex_count + new_vertices > limits.max_vertices || m.triangle_count + 1u > limits.max_triangles) {
+            close();
+        }
+
+        std::uint32_t packed = 0;
+        std::uint32_t shift = 0;
+        for (std::uint32_t v : {a, b, c}) {
+            if (local[v] == UINT32_MAX) {
+                local[v] = m.vertex_count++;
+                out.vertices.push_back(v);
+            }
+            packed |= local[v] << shift;
+            shift += 8u;
+        }
+        out.triangles.push_back(packed);
+        ++m.triangle_count;
+    }
+    close();
+
+    return out;
+}
+
+} // namespace ds_pba
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace ds_pba {
+
+// Upper bounds per meshlet; must not exceed max_vertices / max_primitives in cube.mesh.
+struct MeshletLimits {
+    std::uint32_t max_vertices{64};
+    std::uint32_t max_triangles{124};
+};
+
+// One meshlet and its culling bounds, in model space. Matches struct Meshlet in cube.task and
+// cube.mesh (std430).
+struct Meshlet {
+    std::uint32_t vertex_offset;   // into MeshletMesh::vertices
+    std::uint32_t triangle_offset; // into MeshletMesh::triangles
+    std::uint32_t vertex_count;
+    std::uint32_t triangle_count;
+    glm::vec4 sphere;    // xyz center, w radius
+    glm::vec4 cone_axis; // xyz axis, w cutoff; a cutoff of 1 or more never culls
+    glm::vec4 cone_apex; // xyz apex, w unused
+};
+static_assert(sizeof(Meshlet) == 64, "Meshlet must match the std430 layout in cube.task/cube.mesh");
+
+struct MeshletMesh {
+    std::vector<Meshlet> meshlets{};
+    // Meshlet-local vertex -> index into the source vertex array.
+    std::vector<std::uint32_t> vertices{};
+    // One entry per triangle: three 8-bit meshlet-local vertex indices in bytes 0..2.
+    std::vector<std::uint32_t> triangles{};
+};
+
+// Splits an indexed triangle list into meshlets for the task/mesh shader path.
+//
+// Triangles are taken greedily in index order, so index buffers already optimized for vertex
+// reuse give well-filled meshlets; a meshlet is closed as soon as the next triangle would exceed
+// either limit. Each meshlet gets a bounding sphere for frustum culling and a normal cone for
+// backface culling of the whole meshlet: it faces away from a camera at `eye` when
+// dot(normalize(apex - eye), axis) >= cutoff.
+//
+// Throws std::invalid_argument if the index count is not a multiple of 3, an index is out of
+// range, or the limits are outside [3, 256] vertices / [1, 256] triangles.
+[[nodiscard]] MeshletMesh build_meshlets(std::span<const glm::vec3> positions,
+                                         std::span<const std::uint32_t> indices,
+                                         const MeshletLimits &limits = {});
+
+} // namespace ds_pba
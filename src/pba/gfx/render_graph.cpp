@@ -0,0 +1,629 @@
+#include "pba/gfx/render_graph.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+#pragma clang diagnostic ignored "-Wzero-as-null-pointer-constant"
+#pragma clang diagnostic ignored "-Wcast-qual"
+#pragma clang diagnostic ignored "-Wcast-align"
+#pragma clang diagnostic ignored "-Wconversion"
+#pragma clang diagnostic ignored "-Wsign-conversion"
+#pragma clang diagnostic ignored "-Wfloat-conversion"
+#pragma clang diagnostic ignored "-Wdouble-promotion"
+#pragma clang diagnostic ignored "-Wshadow"
+#pragma clang diagnostic ignored "-Wundef"
+#pragma clang diagnostic ignored "-Wmissing-field-initializers"
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+#endif
+
+#include <vk_mem_alloc.h>
+
+#if defined(__clang__)
+#pragma clang diagnostic pop
+#endif
+
+namespace ds_pba {
+namespace {
+
+void vk_check(VkResult r, const char *what) {
+    if (r != VK_SUCCESS) {
+        throw std::runtime_error(std::string{what} + " (VkResult=" + std::to_string(static_cast<int>(r)) + ")");
+    }
+}
+
+constexpr VkAccessFlags k_write_access = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                         VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT |
+                                         VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+// A cached transient is freed once this many compiles that declare transients have not used it.
+constexpr std::uint64_t k_transient_idle_frames = 240;
+// At most this many unused transients are cached; beyond that the least recently used go first.
+constexpr std::size_t k_max_idle_transients = 16;
+
+struct UsageInfo {
+    RgState state{};
+    bool write{false};
+};
+
+[[nodiscard]] UsageInfo usage_info(RgUsage usage) noexcept {
+    switch (usage) {
+        case RgUsage::color_attachment:
+            return {{VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                     VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                     VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL},
+                    true};
+        case RgUsage::depth_attachment:
+            return {{VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                     VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                     VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL},
+                    true};
+        case RgUsage::sampled_fragment:
+            return {{VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+                    false};
+        case RgUsage::storage_read_compute:
+            return {{VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL}, false};
+        case RgUsage::storage_write_compute:
+            return {{VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                     VK_IMAGE_LAYOUT_GENERAL},
+                    true};
+        case RgUsage::storage_read_vertex:
+            return {{VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL}, false};
+        case RgUsage::storage_read_mesh:
+            return {{VK_PIPELINE_STAGE_TASK_SHADER_BIT_EXT | VK_PIPELINE_STAGE_MESH_SHADER_BIT_EXT,
+                     VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL},
+                    false};
+        case RgUsage::indirect_read:
+            return {{VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED},
+                    false};
+        case RgUsage::transfer_read:
+            return {{VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL},
+                    false};
+        case RgUsage::transfer_write:
+            return {{VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL},
+                    true};
+    }
+    return {};
+}
+
+[[nodiscard]] bool same_desc(const RgImageDesc &a, const RgImageDesc &b) noexcept {
+    return a.format == b.format && a.extent.width == b.extent.width && a.extent.height == b.extent.height &&
+           a.usage == b.usage && a.aspect == b.aspect && a.samples == b.samples &&
+           a.lazily_allocated == b.lazily_allocated;
+}
+
+[[nodiscard]] bool is_set(const RgState &s) noexcept {
+    return s.stages != 0u || s.access != 0u || s.layout != VK_IMAGE_LAYOUT_UNDEFINED;
+}
+
+} // namespace
+
+RenderGraph::~RenderGraph() {
+    destroy();
+}
+
+void RenderGraph::init(VkDevice device, VmaAllocator allocator) {
+    device_ = device;
+    allocator_ = allocator;
+}
+
+void RenderGraph::destroy() {
+    destroy_transients();
+    reset();
+}
+
+void RenderGraph::reset() {
+    resources_.clear();
+    passes_.clear();
+    uses_.clear();
+    transients_.clear();
+    trackers_.clear();
+    batches_.clear();
+    image_barriers_.clear();
+    buffer_barriers_.clear();
+}
+
+RgResource RenderGraph::import_image(const char *name, VkImage image, VkImageAspectFlags aspect,
+                                     const RgState &initial, const RgState &final_state) {
+    Resource r{};
+    r.name = name;
+    r.is_image = true;
+    r.image = image;
+    r.aspect = aspect;
+    r.initial = initial;
+    r.final_state = final_state;
+    resources_.push_back(r);
+    return RgResource{static_cast<std::uint32_t>(resources_.size() - 1u)};
+}
+
+RgResource RenderGraph::import_buffer(const char *name, VkBuffer buffer, const RgState &initial,
+                                      const RgState &final_state) {
+    Resource r{};
+    r.name = name;
+    r.buffer = buffer;
+    r.initial = initial;
+    r.final_state = final_state;
+    resources_.push_back(r);
+    return RgResource{static_cast<std::uint32_t>(resources_.size() - 1u)};
+}
+
+RgResource RenderGraph::create_image(const char *name, const RgImageDesc &desc) {
+    Resource r{};
+    r.name = name;
+    r.is_image = true;
+    r.aspect = desc.aspect;
+    r.transient = static_cast<std::uint32_t>(transients_.size());
+    transients_.push_back(desc);
+    resources_.push_back(r);
+    return RgResource{static_cast<std::uint32_t>(resources_.size() - 1u)};
+}
+
+void RenderGraph::add_pass(const char *name, std::initializer_list<RgUse> uses, RecordFn record) {
+    add_pass(name, std::span<const RgUse>{uses.begin(), uses.size()}, std::move(record));
+}
+
+void RenderGraph::add_pass(const char *name, std::span<const RgUse> uses, RecordFn record) {
+    Pass p{};
+    p.name = name;
+    p.first_use = static_cast<std::uint32_t>(uses_.size());
+    p.use_count = static_cast<std::uint32_t>(uses.size());
+    p.record = std::move(record);
+    uses_.insert(uses_.end(), uses.begin(), uses.end());
+    passes_.push_back(std::move(p));
+}
+
+void RenderGraph::compile() {
+    const auto pass_count = static_cast<std::uint32_t>(passes_.size());
+
+    for (Resource &r : resources_) {
+        r.first_pass = UINT32_MAX;
+        r.last_pass = 0;
+    }
+    for (std::uint32_t p = 0; p < pass_count; ++p) {
+        for (std::uint32_t u = 0; u < passes_[p].use_count; ++u) {
+            Resource &r = resources_.at(uses_[passes_[p].first_use + u].resource.index);
+            r.first_pass = std::min(r.first_pass, p);
+            r.last_pass = std::max(r.last_pass, p);
+        }
+    }
+
+    resolve_transients();
+
+    trackers_.assign(resources_.size(), Tracker{});
+    for (std::size_t i = 0; i < resources_.size(); ++i) {
+        const Resource &r = resources_[i];
+        if (r.transient != UINT32_MAX) {
+            continue; // initialized from its memory's previous occupant at first use
+        }
+        Tracker &t = trackers_[i];
+        t.layout = r.initial.layout;
+        t.write_access = r.initial.access & k_write_access;
+        t.write_stages = t.write_access != 0u ? r.initial.stages : 0u;
+        // A read-only or access-less initial state (e.g. a semaphore wait stage) is still
+        // something the first write must be ordered after.
+        t.read_stages = t.write_access != 0u ? 0u : r.initial.stages;
+    }
+
+    // Last state of each transient memory block, handed to the next image placed in it.
+    std::vector<Tracker> memory_state(transient_blocks_.size(), Tracker{});
+
+    batches_.assign(pass_count + 1u, Batch{});
+    image_barriers_.clear();
+    buffer_barriers_.clear();
+
+    for (std::uint32_t p = 0; p < pass_count; ++p) {
+        Batch &batch = batches_[p];
+        batch.first_image = static_cast<std::uint32_t>(image_barriers_.size());
+        batch.first_buffer = static_cast<std::uint32_t>(buffer_barriers_.size());
+
+        for (std::uint32_t u = 0; u < passes_[p].use_count; ++u) {
+            const RgUse &use = uses_[passes_[p].first_use + u];
+            const Resource &r = resources_[use.resource.index];
+            if (r.transient != UINT32_MAX && r.first_pass == p) {
+                Tracker &t = trackers_[use.resource.index];
+                t = memory_state[transient_images_[assigned_[r.transient]].memory];
+                t.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+                t.visible_stages = 0;
+                t.visible_access = 0;
+            }
+            const UsageInfo info = usage_info(use.usage);
+            access(use.resource.index, info.state, info.write, use.discard, batch);
+        }
+
+        for (std::uint32_t u = 0; u < passes_[p].use_count; ++u) {
+            const RgUse &use = uses_[passes_[p].first_use + u];
+            const Resource &r = resources_[use.resource.index];
+            if (r.transient != UINT32_MAX && r.last_pass == p) {
+                memory_state[transient_images_[assigned_[r.transient]].memory] = trackers_[use.resource.index];
+            }
+        }
+    }
+
+    Batch &last = batches_[pass_count];
+    last.first_image = static_cast<std::uint32_t>(image_barriers_.size());
+    last.first_buffer = static_cast<std::uint32_t>(buffer_barriers_.size());
+    for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(resources_.size()); ++i) {
+        if (is_set(resources_[i].final_state)) {
+            access(i, resources_[i].final_state, false, false, last);
+        }
+    }
+}
+
+void RenderGraph::access(std::uint32_t resource, const RgState &need, bool write, bool discard, Batch &batch) {
+    const Resource &r = resources_[resource];
+    Tracker &t = trackers_[resource];
+
+    const bool layout_change = r.is_image && need.layout != VK_IMAGE_LAYOUT_UNDEFINED && need.layout != t.layout;
+    const bool unseen_write = t.write_access != 0u && ((need.stages & ~t.visible_stages) != 0u ||
+                                                       (need.access & ~t.visible_access) != 0u);
+    const bool write_after_read = write && t.read_stages != 0u;
+
+    if (layout_change || unseen_write || write_after_read) {
+        const VkPipelineStageFlags src = t.write_stages | t.read_stages;
+        batch.src_stages |= (src != 0u) ? src : VkPipelineStageFlags{VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT};
+        batch.dst_stages |= (need.stages != 0u) ? need.stages : VkPipelineStageFlags{VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT};
+
+        if (r.is_image) {
+            VkImageMemoryBarrier b{};
+            b.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            b.pNext = nullptr;
+            b.srcAccessMask = t.write_access;
+            b.dstAccessMask = need.access;
+            b.oldLayout = (discard && layout_change) ? VK_IMAGE_LAYOUT_UNDEFINED : t.layout;
+            b.newLayout = layout_change ? need.layout : t.layout;
+            b.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            b.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            b.image = r.image;
+            b.subresourceRange.aspectMask = r.aspect;
+            b.subresourceRange.baseMipLevel = 0;
+            b.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+            b.subresourceRange.baseArrayLayer = 0;
+            b.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+            image_barriers_.push_back(b);
+            ++batch.image_count;
+        } else {
+            VkBufferMemoryBarrier b{};
+            b.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            b.pNext = nullptr;
+            b.srcAccessMask = t.write_access;
+            b.dstAccessMask = need.access;
+            b.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            b.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            b.buffer = r.buffer;
+            b.offset = 0;
+            b.size = VK_WHOLE_SIZE;
+            buffer_barriers_.push_back(b);
+            ++batch.buffer_count;
+        }
+
+        if (layout_change) {
+            t.layout = need.layout;
+        }
+        // Earlier barriers since the last write still hold; a write resets both below.
+        t.visible_stages |= need.stages;
+        t.visible_access |= need.access;
+        // The barrier waited for every earlier reader; later barriers chain through this one.
+        t.read_stages = 0;
+    }
+
+    if (write) {
+        t.write_stages = need.stages;
+        t.write_access = need.access & k_write_access;
+        t.visible_stages = 0;
+        t.visible_access = 0;
+        t.read_stages = 0;
+    } else {
+        t.read_stages |= need.stages;
+    }
+}
+
+void RenderGraph::execute(VkCommandBuffer cb) const {
+    const auto flush = [&](const Batch &b) {
+        if (b.image_count == 0u && b.buffer_count == 0u) {
+            return;
+        }
+        vkCmdPipelineBarrier(cb, b.src_stages, b.dst_stages, 0, 0, nullptr, b.buffer_count,
+                             buffer_barriers_.data() + b.first_buffer, b.image_count,
+                             image_barriers_.data() + b.first_image);
+    };
+
+    for (std::size_t p = 0; p < passes_.size(); ++p) {
+        const Pass &pass = passes_[p];
+        const bool label = begin_label_ && end_label_ && pass.use_count != 0u;
+        if (label) {
+            VkDebugUtilsLabelEXT info{};
+            info.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+            info.pNext = nullptr;
+            info.pLabelName = pass.name;
+            begin_label_(cb, &info);
+        }
+        flush(batches_[p]);
+        if (pass.record) {
+            pass.record(cb);
+        }
+        if (label) {
+            end_label_(cb);
+        }
+    }
+    flush(batches_.back());
+}
+
+VkImage RenderGraph::image(RgResource r) const {
+    return resources_.at(r.index).image;
+}
+
+VkImageView RenderGraph::image_view(RgResource r) const {
+    const Resource &res = resources_.at(r.index);
+    return res.transient != UINT32_MAX ? transient_images_.at(assigned_.at(res.transient)).view : VK_NULL_HANDLE;
+}
+
+void RenderGraph::resolve_transients() {
+    const std::size_t n = transients_.size();
+    // A frame without transients (e.g. an idle one) neither uses nor ages the cache.
+    assigned_.assign(n, UINT32_MAX);
+    if (n == 0u) {
+        return;
+    }
+    if (!device_ || !allocator_) {
+        throw std::runtime_error("RenderGraph::init() must be called before creating transient images");
+    }
+    ++transient_frame_;
+
+    std::vector<std::uint32_t> owner(n, 0); // transient -> resource
+    for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(resources_.size()); ++i) {
+        if (resources_[i].transient != UINT32_MAX) {
+            owner[resources_[i].transient] = i;
+        }
+    }
+
+    std::vector<bool> overlap(n * n, false);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            const Resource &a = resources_[owner[i]];
+            const Resource &b = resources_[owner[j]];
+            overlap[i * n + j] = a.first_pass <= b.last_pass && b.first_pass <= a.last_pass;
+        }
+    }
+
+    // Whether transient i may live in block b: nothing alive at the same time may be placed there.
+    const auto block_free = [&](std::size_t i, std::uint32_t b) {
+        for (std::size_t j = 0; j < n; ++j) {
+            if (j != i && assigned_[j] != UINT32_MAX && overlap[i * n + j] &&
+                transient_images_[assigned_[j]].memory == b) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // Reuse any cached image with the same description first.
+    std::vector<bool> taken(transient_images_.size(), false);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::uint32_t c = 0; c < static_cast<std::uint32_t>(transient_images_.size()); ++c) {
+            if (!taken[c] && same_desc(transients_[i], transient_images_[c].desc) &&
+                block_free(i, transient_images_[c].memory)) {
+                assigned_[i] = c;
+                taken[c] = true;
+                break;
+            }
+        }
+    }
+
+    // The rest get new images, placed first fit into an existing block they fit in or into a new
+    // block sized for everything placed in it.
+    const std::size_t cached = transient_images_.size();
+    try {
+        for (std::size_t i = 0; i < n; ++i) {
+            if (assigned_[i] != UINT32_MAX) {
+                continue;
+            }
+            TransientImage ti{};
+            ti.desc = transients_[i];
+
+            VkImageCreateInfo ici{};
+            ici.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            ici.pNext = nullptr;
+            ici.flags = 0;
+            ici.imageType = VK_IMAGE_TYPE_2D;
+            ici.format = ti.desc.format;
+            ici.extent = VkExtent3D{ti.desc.extent.width, ti.desc.extent.height, 1u};
+            ici.mipLevels = 1;
+            ici.arrayLayers = 1;
+            ici.samples = ti.desc.samples;
+            ici.tiling = VK_IMAGE_TILING_OPTIMAL;
+            ici.usage = ti.desc.usage;
+            ici.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            ici.queueFamilyIndexCount = 0;
+            ici.pQueueFamilyIndices = nullptr;
+            ici.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            vk_check(vkCreateImage(device_, &ici, nullptr, &ti.image), "vkCreateImage(transient)");
+            transient_images_.push_back(ti);
+            const auto index = static_cast<std::uint32_t>(transient_images_.size() - 1u);
+
+            VkMemoryRequirements req{};
+            vkGetImageMemoryRequirements(device_, ti.image, &req);
+
+            const auto fits = [&](std::uint32_t b) {
+                const TransientBlock &blk = transient_blocks_[b];
+                if (blk.lazily_allocated != ti.desc.lazily_allocated) {
+                    return false;
+                }
+                if (blk.allocation) {
+                    // Already allocated: every memory type it may have must suit the image.
+                    if (req.size > blk.req.size || req.alignment > blk.req.alignment ||
+                        (blk.req.memoryTypeBits & ~req.memoryTypeBits) != 0u) {
+                        return false;
+                    }
+                } else if ((blk.req.memoryTypeBits & req.memoryTypeBits) == 0u) {
+                    return false;
+                }
+                return block_free(i, b);
+            };
+            std::uint32_t b = 0;
+            while (b < transient_blocks_.size() && !fits(b)) {
+                ++b;
+            }
+            if (b == transient_blocks_.size()) {
+                transient_blocks_.push_back(TransientBlock{nullptr, req, ti.desc.lazily_allocated});
+            } else if (!transient_blocks_[b].allocation) {
+                VkMemoryRequirements &r = transient_blocks_[b].req;
+                r.size = std::max(r.size, req.size);
+                r.alignment = std::max(r.alignment, req.alignment);
+                r.memoryTypeBits &= req.memoryTypeBits;
+            }
+            transient_images_[index].memory = b;
+            assigned_[i] = index;
+        }
+
+        for (TransientBlock &blk : transient_blocks_) {
+            if (blk.allocation) {
+                continue;
+            }
+            VmaAllocationCreateInfo aci{};
+            aci.flags = 0;
+            aci.usage = VMA_MEMORY_USAGE_UNKNOWN;
+            aci.requiredFlags = blk.lazily_allocated ? VkMemoryPropertyFlags{VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT}
+                                                     : VkMemoryPropertyFlags{0};
+            aci.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            aci.memoryTypeBits = 0;
+            aci.pool = nullptr;
+            aci.pUserData = nullptr;
+            aci.priority = 0.0f;
+
+            VkResult res = vmaAllocateMemory(allocator_, &blk.req, &aci, &blk.allocation, nullptr);
+            if (res != VK_SUCCESS && blk.lazily_allocated) {
+                // No lazily allocated type is compatible; plain device memory still works.
+                aci.requiredFlags = 0;
+                res = vmaAllocateMemory(allocator_, &blk.req, &aci, &blk.allocation, nullptr);
+            }
+            vk_check(res, "vmaAllocateMemory(transient)");
+        }
+
+        for (std::size_t c = cached; c < transient_images_.size(); ++c) {
+            TransientImage &ti = transient_images_[c];
+            vk_check(vmaBindImageMemory(allocator_, transient_blocks_[ti.memory].allocation, ti.image),
+                     "vmaBindImageMemory(transient)");
+
+            VkImageViewCreateInfo vi{};
+            vi.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            vi.pNext = nullptr;
+            vi.flags = 0;
+            vi.image = ti.image;
+            vi.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            vi.format = ti.desc.format;
+            vi.components = VkComponentMapping{};
+            vi.subresourceRange.aspectMask = ti.desc.aspect;
+            vi.subresourceRange.baseMipLevel = 0;
+            vi.subresourceRange.levelCount = 1;
+            vi.subresourceRange.baseArrayLayer = 0;
+            vi.subresourceRange.layerCount = 1;
+            vk_check(vkCreateImageView(device_, &vi, nullptr, &ti.view), "vkCreateImageView(transient)");
+        }
+    } catch (...) {
+        // Half-built images or blocks would poison later frames; start over from nothing.
+        destroy_transients();
+        throw;
+    }
+
+    for (std::size_t i = 0; i < n; ++i) {
+        transient_images_[assigned_[i]].last_used = transient_frame_;
+    }
+    evict_transients();
+
+    for (std::size_t i = 0; i < n; ++i) {
+        resources_[owner[i]].image = transient_images_[assigned_[i]].image;
+    }
+}
+
+void RenderGraph::evict_transients() {
+    std::vector<std::uint32_t> idle{};
+    for (std::uint32_t c = 0; c < static_cast<std::uint32_t>(transient_images_.size()); ++c) {
+        if (transient_images_[c].last_used != transient_frame_) {
+            idle.push_back(c);
+        }
+    }
+    std::sort(idle.begin(), idle.end(), [&](std::uint32_t a, std::uint32_t b) {
+        return transient_images_[a].last_used < transient_images_[b].last_used;
+    });
+
+    std::vector<bool> evict(transient_images_.size(), false);
+    bool any = false;
+    for (std::size_t k = 0; k < idle.size(); ++k) {
+        const TransientImage &ti = transient_images_[idle[k]];
+        if (k + k_max_idle_transients < idle.size() || transient_frame_ - ti.last_used > k_transient_idle_frames) {
+            evict[idle[k]] = true;
+            any = true;
+        }
+    }
+    if (!any) {
+        return;
+    }
+
+    // Compact the images, then drop blocks no image is bound to any more.
+    std::vector<std::uint32_t> image_remap(transient_images_.size(), UINT32_MAX);
+    std::vector<bool> block_used(transient_blocks_.size(), false);
+    std::size_t kept = 0;
+    for (std::size_t c = 0; c < transient_images_.size(); ++c) {
+        TransientImage &ti = transient_images_[c];
+        if (evict[c]) {
+            vkDestroyImageView(device_, ti.view, nullptr);
+            vkDestroyImage(device_, ti.image, nullptr);
+            continue;
+        }
+        block_used[ti.memory] = true;
+        image_remap[c] = static_cast<std::uint32_t>(kept);
+        transient_images_[kept++] = ti;
+    }
+    transient_images_.resize(kept);
+
+    std::vector<std::uint32_t> block_remap(transient_blocks_.size(), UINT32_MAX);
+    kept = 0;
+    for (std::size_t b = 0; b < transient_blocks_.size(); ++b) {
+        if (!block_used[b]) {
+            vmaFreeMemory(allocator_, transient_blocks_[b].allocation);
+            continue;
+        }
+        block_remap[b] = static_cast<std::uint32_t>(kept);
+        transient_blocks_[kept++] = transient_blocks_[b];
+    }
+    transient_blocks_.resize(kept);
+
+    for (TransientImage &ti : transient_images_) {
+        ti.memory = block_remap[ti.memory];
+    }
+    for (std::uint32_t &a : assigned_) {
+        a = image_remap[a];
+    }
+    // A later view may reuse a destroyed view's handle.
+    ++transient_generation_;
+}
+
+void RenderGraph::destroy_transients() {
+    for (TransientImage &ti : transient_images_) {
+        if (ti.view) {
+            vkDestroyImageView(device_, ti.view, nullptr);
+        }
+        if (ti.image) {
+            vkDestroyImage(device_, ti.image, nullptr);
+        }
+    }
+    for (TransientBlock &blk : transient_blocks_) {
+        if (blk.allocation) {
+            vmaFreeMemory(allocator_, blk.allocation);
+        }
+    }
+    if (!transient_images_.empty()) {
+        ++transient_generation_;
+    }
+    transient_images_.clear();
+    transient_blocks_.clear();
+    assigned_.clear();
+}
+
+} // namespace ds_pba
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+// Matches VK_DEFINE_HANDLE in vk_mem_alloc.h, which only the .cpp needs.
+typedef struct VmaAllocator_T *VmaAllocator;
+typedef struct VmaAllocation_T *VmaAllocation;
+
+namespace ds_pba {
+
+// Where and how a pass touches a resource. Each usage maps to one pipeline stage/access/layout
+// triple, so passes only state what they do and the graph works out the barriers.
+enum class RgUsage : std::uint8_t {
+    color_attachment,      // read/write, COLOR_ATTACHMENT_OPTIMAL
+    depth_attachment,      // read/write, DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+    sampled_fragment,      // read, SHADER_READ_ONLY_OPTIMAL
+    storage_read_compute,  // read
+    storage_write_compute, // read/write (atomics)
+    storage_read_vertex,   // read
+    storage_read_mesh,     // read, task + mesh shaders (VK_EXT_mesh_shader)
+    indirect_read,         // read
+    transfer_read,         // read, TRANSFER_SRC_OPTIMAL
+    transfer_write,        // write, TRANSFER_DST_OPTIMAL
+};
+
+// A point in the frame a resource is synchronized against. A zero state means "don't care".
+struct RgState {
+    VkPipelineStageFlags stages{0};
+    VkAccessFlags access{0};
+    VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+};
+
+struct RgResource {
+    std::uint32_t index{UINT32_MAX};
+    [[nodiscard]] bool valid() const noexcept { return index != UINT32_MAX; }
+};
+
+struct RgUse {
+    RgResource resource{};
+    RgUsage usage{RgUsage::transfer_read};
+    // The pass overwrites the whole resource (e.g. loadOp CLEAR), so the previous contents may
+    // be dropped in the layout transition.
+    bool discard{false};
+};
+
+// A graph-owned image that only lives within the frame. Transients whose lifetimes do not
+// overlap share memory.
+struct RgImageDesc {
+    VkFormat format{VK_FORMAT_UNDEFINED};
+    VkExtent2D extent{1, 1};
+    VkImageUsageFlags usage{0};
+    VkImageAspectFlags aspect{VK_IMAGE_ASPECT_COLOR_BIT};
+    VkSampleCountFlagBits samples{VK_SAMPLE_COUNT_1_BIT};
+    // Prefer LAZILY_ALLOCATED memory (usage must then include TRANSIENT_ATTACHMENT).
+    bool lazily_allocated{false};
+};
+
+// A per-frame list of passes with declared reads and writes.
+//
+// compile() walks the passes in submission order, tracking each resource's last write, its
+// readers and its layout, and emits a barrier only on a hazard (RAW, WAR, WAW) or a layout
+// change, batched into one vkCmdPipelineBarrier per pass. Imported resources start and end
+// in caller-provided states (e.g. a swapchain image from the acquire wait to PRESENT_SRC).
+//
+// Transient images are pooled across frames by description: each transient takes a cached image
+// with the same description if one is free and only the rest are created, so a frame that
+// declares a subset of last frame's transients (or none) allocates nothing. Images no frame has
+// used for a while are freed, and compile() may do that immediately, so use one graph per frame
+// slot and build it only after that slot's frame wait.
+class RenderGraph final {
+public:
+    using RecordFn = std::function<void(VkCommandBuffer)>;
+
+    RenderGraph() = default;
+    ~RenderGraph();
+
+    RenderGraph(const RenderGraph &) = delete;
+    RenderGraph &operator=(const RenderGraph &) = delete;
+
+    // Needed before the first create_image().
+    void init(VkDevice device, VmaAllocator allocator);
+    // Wraps every pass that uses resources, its barriers included, in a VK_EXT_debug_utils label
+    // named after it. Null functions (the default) record no labels.
+    void set_debug_labels(PFN_vkCmdBeginDebugUtilsLabelEXT begin, PFN_vkCmdEndDebugUtilsLabelEXT end) noexcept {
+        begin_label_ = begin;
+        end_label_ = end;
+    }
+    // Frees the transient cache; the GPU must be done with it.
+    void destroy();
+
+    // Drops the previous frame's passes and resources; the transient cache survives.
+    void reset();
+
+    RgResource import_image(const char *name, VkImage image, VkImageAspectFlags aspect, const RgState &initial,
+                            const RgState &final_state = {});
+    RgResource import_buffer(const char *name, VkBuffer buffer, const RgState &initial = {},
+                             const RgState &final_state = {});
+    RgResource create_image(const char *name, const RgImageDesc &desc);
+
+    // Passes run in the order they are added. A pass without uses is a plain marker (e.g. a
+    // timestamp write) and never gets barriers of its own.
+    void add_pass(const char *name, std::initializer_list<RgUse> uses, RecordFn record);
+    void add_pass(const char *name, std::span<const RgUse> uses, RecordFn record);
+
+    // Derives the barriers and resolves transient images. Throws std::runtime_error on failure.
+    void compile();
+    void execute(VkCommandBuffer cb) const;
+
+    // Valid after compile().
+    [[nodiscard]] VkImage image(RgResource r) const;
+    [[nodiscard]] VkImageView image_view(RgResource r) const;
+
+    [[nodiscard]] std::uint32_t pass_count() const noexcept { return static_cast<std::uint32_t>(passes_.size()); }
+    [[nodiscard]] std::uint32_t barrier_count() const noexcept {
+        return static_cast<std::uint32_t>(image_barriers_.size() + buffer_barriers_.size());
+    }
+    [[nodiscard]] std::uint32_t transient_memory_blocks() const noexcept {
+        return static_cast<std::uint32_t>(transient_blocks_.size());
+    }
+    // Bumped whenever transient images are destroyed. A transient may get a different cached
+    // image from one frame to the next, so anything built from image_view() (e.g. a framebuffer)
+    // is keyed on the view handles and this, since a new view may reuse a destroyed one's handle.
+    [[nodiscard]] std::uint64_t transient_generation() const noexcept { return transient_generation_; }
+
+private:
+    struct Resource {
+        const char *name{""};
+        bool is_image{false};
+        VkImage image{VK_NULL_HANDLE};
+        VkBuffer buffer{VK_NULL_HANDLE};
+        VkImageAspectFlags aspect{0};
+        RgState initial{};
+        RgState final_state{};
+
+        // Index into transients_ / the transient cache; UINT32_MAX for imported resources.
+        std::uint32_t transient{UINT32_MAX};
+        std::uint32_t first_pass{UINT32_MAX};
+        std::uint32_t last_pass{0};
+    };
+
+    struct Pass {
+        const char *name{""};
+        std::uint32_t first_use{0};
+        std::uint32_t use_count{0};
+        RecordFn record{};
+    };
+
+    // Barriers recorded before a pass (or, for the last batch, after every pass).
+    struct Batch {
+        std::uint32_t first_image{0};
+        std::uint32_t image_count{0};
+        std::uint32_t first_buffer{0};
+        std::uint32_t buffer_count{0};
+        VkPipelineStageFlags src_stages{0};
+        VkPipelineStageFlags dst_stages{0};
+    };
+
+    // Hazard tracking for one resource while compiling.
+    struct Tracker {
+        VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+        VkPipelineStageFlags write_stages{0};
+        VkAccessFlags write_access{0};
+        // Stages/accesses the last write has been made visible to.
+        VkPipelineStageFlags visible_stages{0};
+        VkAccessFlags visible_access{0};
+        // Stages that read since the last write; a later write has to wait for them.
+        VkPipelineStageFlags read_stages{0};
+    };
+
+    struct TransientImage {
+        RgImageDesc desc{};
+        std::uint32_t memory{0}; // index into transient_blocks_
+        VkImage image{VK_NULL_HANDLE};
+        VkImageView view{VK_NULL_HANDLE};
+        std::uint64_t last_used{0}; // transient_frame_ of the last compile that used it
+    };
+
+    // One allocation shared by images whose lifetimes never overlap within a frame.
+    struct TransientBlock {
+        VmaAllocation allocation{nullptr};
+        VkMemoryRequirements req{};
+        bool lazily_allocated{false};
+    };
+
+    void access(std::uint32_t resource, const RgState &need, bool write, bool discard, Batch &batch);
+    void resolve_transients();
+    // Frees cached images unused for too long (or beyond the idle limit) and empty blocks.
+    void evict_transients();
+    void destroy_transients();
+
+    VkDevice device_{VK_NULL_HANDLE};
+    VmaAllocator allocator_{nullptr};
+    PFN_vkCmdBeginDebugUtilsLabelEXT begin_label_{nullptr};
+    PFN_vkCmdEndDebugUtilsLabelEXT end_label_{nullptr};
+
+    std::vector<Resource> resources_{};
+    std::vector<Pass> passes_{};
+    std::vector<RgUse> uses_{};
+
+    // This frame's transient descriptions, in create_image() order.
+    std::vector<RgImageDesc> transients_{};
+
+    std::vector<Tracker> trackers_{};
+    std::vector<Batch> batches_{}; // passes_.size() + 1 after compile()
+    std::vector<VkImageMemoryBarrier> image_barriers_{};
+    std::vector<VkBufferMemoryBarrier> buffer_barriers_{};
+
+    // Transient pool. Images sharing a block are only handed to transients whose lifetimes do
+    // not overlap.
+    std::vector<TransientImage> transient_images_{};
+    std::vector<TransientBlock> transient_blocks_{};
+    // This frame's transient -> index into transient_images_.
+    std::vector<std::uint32_t> assigned_{};
+    // Counts compiles that declared transients; idle frames do not age the pool.
+    std::uint64_t transient_frame_{0};
+    std::uint64_t transient_generation_{0};
+};
+
+} // namespace ds_pba
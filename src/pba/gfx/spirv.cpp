@@ -0,0 +1,67 @@
+#include "pba/gfx/spirv.hpp"
+
+#include "pba/core/paths.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#if defined(PBA_EMBED_SPIRV)
+// Generated at build time by cmake/embed_spirv.cmake.
+#include "embedded_spirv.hpp"
+#endif
+
+namespace ds_pba {
+namespace {
+
+[[nodiscard]] std::vector<std::uint32_t> read_spirv(const std::filesystem::path &path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open SPIR-V file: " + path.string());
+    }
+
+    const std::streamsize size_bytes = file.tellg();
+    if (size_bytes <= 0) {
+        throw std::runtime_error("Empty SPIR-V file: " + path.string());
+    }
+    if ((size_bytes % 4) != 0) {
+        throw std::runtime_error("SPIR-V file size not multiple of 4: " + path.string());
+    }
+
+    const std::size_t words = static_cast<std::size_t>(size_bytes) / 4u;
+    std::vector<std::uint32_t> data(words);
+
+    file.seekg(0, std::ios::beg);
+    file.read(reinterpret_cast<char *>(data.data()), size_bytes);
+    if (!file) {
+        throw std::runtime_error("Failed to read SPIR-V file: " + path.string());
+    }
+
+    return data;
+}
+
+} // namespace
+
+SpirvCode load_spirv(std::string_view name) {
+#if defined(PBA_EMBED_SPIRV)
+    for (const embedded_spirv::Entry &e : embedded_spirv::k_entries) {
+        if (e.name == name) {
+            return SpirvCode{e.words};
+        }
+    }
+    throw std::runtime_error("SPIR-V not embedded in this build: " + std::string{name});
+#else
+    return SpirvCode{read_spirv(asset_root() / "shaders" / name)};
+#endif
+}
+
+bool spirv_is_embedded() noexcept {
+#if defined(PBA_EMBED_SPIRV)
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace ds_pba
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ds_pba {
+
+// SPIR-V words for one shader. Either views a copy embedded in the binary (PBA_EMBED_SPIRV) or
+// owns the words read from disk; move-only so the view can never outlive its storage.
+class SpirvCode final {
+public:
+    SpirvCode() = default;
+    explicit SpirvCode(std::span<const std::uint32_t> embedded) noexcept : words_{embedded} {}
+    explicit SpirvCode(std::vector<std::uint32_t> owned) noexcept
+        : storage_{std::move(owned)}, words_{storage_} {}
+
+    SpirvCode(const SpirvCode &) = delete;
+    SpirvCode &operator=(const SpirvCode &) = delete;
+    // Moving a vector keeps its heap buffer, so words_ stays valid.
+    SpirvCode(SpirvCode &&) noexcept = default;
+    SpirvCode &operator=(SpirvCode &&) noexcept = default;
+
+    [[nodiscard]] std::span<const std::uint32_t> words() const noexcept { return words_; }
+    [[nodiscard]] std::size_t size_bytes() const noexcept { return words_.size_bytes(); }
+
+private:
+    std::vector<std::uint32_t> storage_{};
+    std::span<const std::uint32_t> words_{};
+};
+
+// Loads a compiled shader by file name, e.g. "cube.vert.spv". Uses the embedded copy when the
+// build embeds SPIR-V, otherwise reads asset_root()/shaders/<name>. Throws std::runtime_error.
+[[nodiscard]] SpirvCode load_spirv(std::string_view name);
+
+// True when shaders were compiled into the binary.
+[[nodiscard]] bool spirv_is_embedded() noexcept;
+
+} // namespace ds_pba
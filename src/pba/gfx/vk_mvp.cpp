@@ -1,5 +1,21 @@
 #include "pba/gfx/vk_mvp.hpp"
 
+#include "pba/asset/mesh_file.hpp"
+#include "pba/asset/mesh_streamer.hpp"
+#include "pba/core/job_system.hpp"
+#include "pba/core/paths.hpp"
+#include "pba/core/profiler.hpp"
+#include "pba/core/transform_batch.hpp"
+#include "pba/gfx/bindless_heap.hpp"
+#include "pba/gfx/deletion_queue.hpp"
+#include "pba/gfx/dynamic_resolution.hpp"
+#include "pba/gfx/frame_capture.hpp"
+#include "pba/gfx/frame_pacer.hpp"
+#include "pba/gfx/frame_stats.hpp"
+#include "pba/gfx/meshlet_builder.hpp"
+#include "pba/gfx/render_graph.hpp"
+#include "pba/gfx/spirv.hpp"
+
 //
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/glm.hpp>
@@ -7,19 +23,28 @@
 //
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <chrono>
 #include <cmath>
 #include <cstddef>
+#include <cfloat>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <ctime>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <memory>
 #include <optional>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 //
@@ -184,41 +209,128 @@ void destroy_debug_messenger(VkInstance instance, VkDebugUtilsMessengerEXT messe
     return false;
 }
 
-[[nodiscard]] std::vector<std::uint32_t> read_spirv(const std::filesystem::path &path) {
+// Returns the family with `required` and none of `excluded` that has the fewest other
+// capabilities, i.e. the one most likely to map to a dedicated hardware engine (DMA / async
+// compute). Returns std::nullopt when there is none so callers can share the graphics queue.
+[[nodiscard]] std::optional<std::uint32_t> find_dedicated_queue_family(
+    const std::vector<VkQueueFamilyProperties> &qfs, VkQueueFlags required, VkQueueFlags excluded) {
+    std::optional<std::uint32_t> best{};
+    int best_extra = 0;
+    for (std::uint32_t i = 0; i < qfs.size(); ++i) {
+        const VkQueueFlags flags = qfs[i].queueFlags;
+        if (qfs[i].queueCount == 0u || (flags & required) != required || (flags & excluded) != 0u) {
+            continue;
+        }
+        const int extra = std::popcount(flags & ~required);
+        if (!best.has_value() || extra < best_extra) {
+            best = i;
+            best_extra = extra;
+        }
+    }
+    return best;
+}
+
+[[nodiscard]] std::vector<std::uint8_t> read_binary_file(const std::filesystem::path &path) {
     std::ifstream file(path, std::ios::binary | std::ios::ate);
     if (!file.is_open()) {
-        throw std::runtime_error("Failed to open SPIR-V file: " + path.string());
+        return {};
     }
 
     const std::streamsize size_bytes = file.tellg();
     if (size_bytes <= 0) {
-        throw std::runtime_error("Empty SPIR-V file: " + path.string());
+        return {};
     }
-    if ((size_bytes % 4) != 0) {
-        throw std::runtime_error("SPIR-V file size not multiple of 4: " + path.string());
-    }
-
-    const std::size_t words = static_cast<std::size_t>(size_bytes) / 4u;
-    std::vector<std::uint32_t> data(words);
 
+    std::vector<std::uint8_t> data(static_cast<std::size_t>(size_bytes));
     file.seekg(0, std::ios::beg);
     file.read(reinterpret_cast<char *>(data.data()), size_bytes);
     if (!file) {
-        throw std::runtime_error("Failed to read SPIR-V file: " + path.string());
+        return {};
     }
 
     return data;
 }
 
-[[nodiscard]] VkShaderModule create_shader_module(VkDevice device, const std::filesystem::path &spv) {
-    const std::vector<std::uint32_t> code = read_spirv(spv);
+// Writes to a sibling temp file first so a crash mid-write never leaves a truncated blob behind.
+[[nodiscard]] bool write_binary_file(const std::filesystem::path &path, const void *data, std::size_t size) {
+    std::filesystem::path tmp = path;
+    tmp += ".tmp";
+
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+        if (!file) {
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    return !ec;
+}
+
+[[nodiscard]] std::filesystem::path pipeline_cache_path() {
+    // Lives next to assets/shaders so it travels with the SPIR-V it was built from.
+    return asset_root() / "pipeline_cache.bin";
+}
+
+[[nodiscard]] std::string local_time_stamp() {
+    const std::time_t now = std::time(nullptr);
+    std::array<char, 32> stamp{};
+    std::strftime(stamp.data(), stamp.size(), "%Y%m%d-%H%M%S", std::localtime(&now));
+    return stamp.data();
+}
+
+// captures/<YYYYmmdd-HHMMSS> next to the executable, one directory per capture session.
+[[nodiscard]] std::filesystem::path capture_session_dir() {
+    return executable_dir() / "captures" / local_time_stamp();
+}
+
+// traces/<YYYYmmdd-HHMMSS>.json next to the executable, for traces saved from the UI.
+[[nodiscard]] std::filesystem::path trace_file_path() {
+    return executable_dir() / "traces" / (local_time_stamp() + ".json");
+}
+
+// The Vulkan time domain profiler::now_ns() reads, where there is one: steady_clock is
+// CLOCK_MONOTONIC on Linux. Elsewhere GPU zones are anchored at submit time instead.
+[[nodiscard]] std::optional<VkTimeDomainEXT> host_time_domain() noexcept {
+#if defined(__linux__)
+    return VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+#else
+    return std::nullopt;
+#endif
+}
+
+// Drivers reject foreign blobs on their own, but some crash or silently recompile everything,
+// so only hand over data whose header matches this exact device.
+[[nodiscard]] bool pipeline_cache_matches_device(const std::vector<std::uint8_t> &blob,
+                                                 const VkPhysicalDeviceProperties &props) {
+    VkPipelineCacheHeaderVersionOne hdr{};
+    if (blob.size() < sizeof(hdr)) {
+        return false;
+    }
+    std::memcpy(&hdr, blob.data(), sizeof(hdr));
+
+    return hdr.headerSize >= sizeof(hdr) &&
+           hdr.headerSize <= blob.size() &&
+           hdr.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           hdr.vendorID == props.vendorID &&
+           hdr.deviceID == props.deviceID &&
+           std::memcmp(hdr.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+[[nodiscard]] VkShaderModule create_shader_module(VkDevice device, std::string_view spv_name) {
+    const SpirvCode code = load_spirv(spv_name);
 
     VkShaderModuleCreateInfo ci{};
     ci.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
     ci.pNext = nullptr;
     ci.flags = 0;
-    ci.codeSize = code.size() * sizeof(std::uint32_t);
-    ci.pCode = code.data();
+    ci.codeSize = code.size_bytes();
+    ci.pCode = code.words().data();
 
     VkShaderModule mod{VK_NULL_HANDLE};
     vk_check(vkCreateShaderModule(device, &ci, nullptr, &mod), "vkCreateShaderModule");
@@ -246,57 +358,203 @@ struct Vertex {
     glm::vec3 pos;
     glm::vec3 color;
 };
+static_assert(sizeof(Vertex) == 24, "Vertex must match the float[6] stride in cube.mesh");
+static_assert(sizeof(Vertex) == sizeof(MeshVertex) && offsetof(Vertex, color) == offsetof(MeshVertex, color),
+              "Streamed .pbamesh vertices are uploaded as Vertex");
+
+// Bandwidth-friendly alternative to Vertex: snorm16 position (w unused, keeps 4-byte alignment)
+// and unorm8 color, 12 bytes instead of 24. Positions must lie within [-1, 1].
+struct CompactVertex {
+    std::array<std::int16_t, 4> pos;
+    std::array<std::uint8_t, 4> color;
+};
+static_assert(sizeof(CompactVertex) == 12, "CompactVertex must stay tightly packed");
+
+[[nodiscard]] std::int16_t quantize_snorm16(float v) noexcept {
+    return static_cast<std::int16_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * 32767.0f));
+}
+
+[[nodiscard]] std::uint8_t quantize_unorm8(float v) noexcept {
+    return static_cast<std::uint8_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f));
+}
+
+[[nodiscard]] CompactVertex to_compact_vertex(const Vertex &v) noexcept {
+    CompactVertex c{};
+    c.pos = {quantize_snorm16(v.pos.x), quantize_snorm16(v.pos.y), quantize_snorm16(v.pos.z), 0};
+    c.color = {quantize_unorm8(v.color.x), quantize_unorm8(v.color.y), quantize_unorm8(v.color.z), 255};
+    return c;
+}
 
-static constexpr std::array<Vertex, 36> k_cube_vertices = {
+// 4 unique corners per face (colors are per face, so corners cannot be shared between faces),
+// drawn through k_cube_indices.
+static constexpr std::array<Vertex, 24> k_cube_vertices = {
     // +X
     Vertex{{+0.5f, -0.5f, -0.5f}, {1.0f, 0.2f, 0.2f}},
     Vertex{{+0.5f, +0.5f, -0.5f}, {1.0f, 0.2f, 0.2f}},
     Vertex{{+0.5f, +0.5f, +0.5f}, {1.0f, 0.2f, 0.2f}},
-    Vertex{{+0.5f, -0.5f, -0.5f}, {1.0f, 0.2f, 0.2f}},
-    Vertex{{+0.5f, +0.5f, +0.5f}, {1.0f, 0.2f, 0.2f}},
     Vertex{{+0.5f, -0.5f, +0.5f}, {1.0f, 0.2f, 0.2f}},
 
     // -X
     Vertex{{-0.5f, -0.5f, +0.5f}, {0.2f, 1.0f, 0.2f}},
     Vertex{{-0.5f, +0.5f, +0.5f}, {0.2f, 1.0f, 0.2f}},
     Vertex{{-0.5f, +0.5f, -0.5f}, {0.2f, 1.0f, 0.2f}},
-    Vertex{{-0.5f, -0.5f, +0.5f}, {0.2f, 1.0f, 0.2f}},
-    Vertex{{-0.5f, +0.5f, -0.5f}, {0.2f, 1.0f, 0.2f}},
     Vertex{{-0.5f, -0.5f, -0.5f}, {0.2f, 1.0f, 0.2f}},
 
     // +Y
     Vertex{{-0.5f, +0.5f, -0.5f}, {0.2f, 0.2f, 1.0f}},
     Vertex{{-0.5f, +0.5f, +0.5f}, {0.2f, 0.2f, 1.0f}},
     Vertex{{+0.5f, +0.5f, +0.5f}, {0.2f, 0.2f, 1.0f}},
-    Vertex{{-0.5f, +0.5f, -0.5f}, {0.2f, 0.2f, 1.0f}},
-    Vertex{{+0.5f, +0.5f, +0.5f}, {0.2f, 0.2f, 1.0f}},
     Vertex{{+0.5f, +0.5f, -0.5f}, {0.2f, 0.2f, 1.0f}},
 
     // -Y
     Vertex{{-0.5f, -0.5f, +0.5f}, {1.0f, 1.0f, 0.2f}},
     Vertex{{-0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 0.2f}},
     Vertex{{+0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 0.2f}},
-    Vertex{{-0.5f, -0.5f, +0.5f}, {1.0f, 1.0f, 0.2f}},
-    Vertex{{+0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 0.2f}},
     Vertex{{+0.5f, -0.5f, +0.5f}, {1.0f, 1.0f, 0.2f}},
 
     // +Z
     Vertex{{-0.5f, -0.5f, +0.5f}, {1.0f, 0.2f, 1.0f}},
     Vertex{{+0.5f, -0.5f, +0.5f}, {1.0f, 0.2f, 1.0f}},
     Vertex{{+0.5f, +0.5f, +0.5f}, {1.0f, 0.2f, 1.0f}},
-    Vertex{{-0.5f, -0.5f, +0.5f}, {1.0f, 0.2f, 1.0f}},
-    Vertex{{+0.5f, +0.5f, +0.5f}, {1.0f, 0.2f, 1.0f}},
     Vertex{{-0.5f, +0.5f, +0.5f}, {1.0f, 0.2f, 1.0f}},
 
     // -Z
     Vertex{{+0.5f, -0.5f, -0.5f}, {0.2f, 1.0f, 1.0f}},
     Vertex{{-0.5f, -0.5f, -0.5f}, {0.2f, 1.0f, 1.0f}},
     Vertex{{-0.5f, +0.5f, -0.5f}, {0.2f, 1.0f, 1.0f}},
-    Vertex{{+0.5f, -0.5f, -0.5f}, {0.2f, 1.0f, 1.0f}},
-    Vertex{{-0.5f, +0.5f, -0.5f}, {0.2f, 1.0f, 1.0f}},
     Vertex{{+0.5f, +0.5f, -0.5f}, {0.2f, 1.0f, 1.0f}},
 };
 
+static constexpr std::array<std::uint16_t, 36> k_cube_indices = [] {
+    std::array<std::uint16_t, 36> idx{};
+    constexpr std::array<std::uint16_t, 6> k_quad = {0, 1, 2, 0, 2, 3};
+    for (std::size_t face = 0; face < 6; ++face) {
+        for (std::size_t i = 0; i < k_quad.size(); ++i) {
+            idx[face * 6 + i] = static_cast<std::uint16_t>(face * 4 + k_quad[i]);
+        }
+    }
+    return idx;
+}();
+
+[[nodiscard]] const char *present_mode_name(VkPresentModeKHR mode) noexcept {
+    switch (mode) {
+    case VK_PRESENT_MODE_IMMEDIATE_KHR:
+        return "IMMEDIATE";
+    case VK_PRESENT_MODE_MAILBOX_KHR:
+        return "MAILBOX";
+    case VK_PRESENT_MODE_FIFO_KHR:
+        return "FIFO";
+    case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+        return "FIFO_RELAXED";
+    default:
+        return "other";
+    }
+}
+
+[[nodiscard]] const char *sample_count_name(VkSampleCountFlagBits samples) noexcept {
+    switch (samples) {
+    case VK_SAMPLE_COUNT_1_BIT:
+        return "off";
+    case VK_SAMPLE_COUNT_2_BIT:
+        return "2x";
+    case VK_SAMPLE_COUNT_4_BIT:
+        return "4x";
+    case VK_SAMPLE_COUNT_8_BIT:
+        return "8x";
+    default:
+        return "other";
+    }
+}
+
+// Per-instance data read by cube.vert through gl_InstanceIndex: the model matrix as three rows
+// of a row-major 3x4 affine transform (the implicit last row is 0 0 0 1).
+struct InstanceData {
+    glm::vec4 model_rows[3];
+};
+static_assert(sizeof(InstanceData) == 48, "InstanceData must match the std430 layout in cube.vert");
+static_assert(sizeof(InstanceData) == 12 * sizeof(float), "compose_transforms() writes 12 floats per instance");
+
+// Bounding sphere of the unit cube in model space.
+constexpr float k_cube_bounding_radius = 0.8660254f;
+constexpr glm::vec4 k_cube_bounding_sphere{0.0f, 0.0f, 0.0f, k_cube_bounding_radius};
+
+// A per-instance tint; instance i uses material i % material_count.
+struct MaterialData {
+    glm::vec4 tint;
+};
+
+constexpr std::array<MaterialData, 4> k_materials = {
+    MaterialData{{1.0f, 1.0f, 1.0f, 1.0f}},
+    MaterialData{{1.0f, 0.85f, 0.7f, 1.0f}},
+    MaterialData{{0.75f, 0.85f, 1.0f, 1.0f}},
+    MaterialData{{0.85f, 1.0f, 0.8f, 1.0f}},
+};
+
+// The *_slot members are BindlessHeap buffer slots.
+struct CubePushConstants {
+    glm::mat4 view_proj;
+    std::uint32_t culled; // index instances through the cull pass's visible list
+    std::uint32_t instance_slot;
+    std::uint32_t visible_slot;
+    std::uint32_t material_slot;
+    std::uint32_t material_count;
+};
+static_assert(sizeof(CubePushConstants) == 84, "CubePushConstants must match the push block in cube.vert");
+
+struct CullPushConstants {
+    std::array<glm::vec4, 6> planes;
+    glm::vec4 sphere; // model-space bounding sphere: xyz center, w radius
+    std::uint32_t instance_count;
+    std::uint32_t instance_slot;
+    std::uint32_t visible_slot;
+    std::uint32_t draw_args_slot;
+};
+static_assert(sizeof(CullPushConstants) == 128, "CullPushConstants must match the push block in cull.comp");
+
+// Items are (instance, meshlet) pairs numbered instance * meshlet_count + meshlet; each draw covers
+// [first_item, item_end).
+struct MeshletPushConstants {
+    glm::mat4 view_proj;
+    glm::vec4 eye; // xyz camera position, for the backface cone test
+    std::uint32_t first_item;
+    std::uint32_t item_end;
+    std::uint32_t meshlet_count;
+    std::uint32_t culled; // frustum and cone cull meshlets in cube.task
+    std::uint32_t instance_slot;
+    std::uint32_t vertex_slot;
+    std::uint32_t meshlet_slot;
+    std::uint32_t meshlet_vertex_slot;
+    std::uint32_t meshlet_triangle_slot;
+    std::uint32_t material_slot;
+    std::uint32_t material_count;
+};
+static_assert(sizeof(MeshletPushConstants) == 124,
+              "MeshletPushConstants must match the push block in cube.task/cube.mesh");
+
+// Written by cull.comp and consumed by vkCmdDrawIndexedIndirectCount; matches DrawArgs in cull.comp.
+struct IndirectArgs {
+    std::uint32_t draw_count;
+    std::array<std::uint32_t, 3> pad;
+    VkDrawIndexedIndirectCommand cmd;
+};
+static_assert(offsetof(IndirectArgs, cmd) == 16 && sizeof(IndirectArgs) == 36,
+              "IndirectArgs must match DrawArgs in cull.comp");
+
+// Gribb/Hartmann plane extraction for a [0, 1] depth clip space. The planes are normalized and
+// point inwards, so a sphere is outside when dot(n, c) + d < -r for any of them.
+[[nodiscard]] std::array<glm::vec4, 6> frustum_planes(const glm::mat4 &vp) noexcept {
+    const auto row = [&vp](int r) { return glm::vec4(vp[0][r], vp[1][r], vp[2][r], vp[3][r]); };
+    std::array<glm::vec4, 6> planes = {
+        row(3) + row(0), row(3) - row(0), // left, right
+        row(3) + row(1), row(3) - row(1), // bottom, top
+        row(2), row(3) - row(2),          // near, far
+    };
+    for (glm::vec4 &p : planes) {
+        p /= glm::length(glm::vec3(p));
+    }
+    return planes;
+}
+
 template <class T>
 [[nodiscard]] ImTextureID to_imgui_texture_id(T handle) noexcept {
     // Works with either ImTextureID = void* or ImTextureID = ImU64 (default in newer ImGui).
@@ -309,20 +567,66 @@ template <class T>
 
 } // namespace
 
+const char *to_string(FramePacing pacing) noexcept {
+    switch (pacing) {
+    case FramePacing::late:
+        return "late";
+    case FramePacing::early:
+        return "early";
+    }
+    return "unknown";
+}
+
+const char *to_string(PresentPolicy policy) noexcept {
+    switch (policy) {
+    case PresentPolicy::low_latency:
+        return "low-latency";
+    case PresentPolicy::vsync:
+        return "vsync";
+    case PresentPolicy::adaptive_vsync:
+        return "adaptive-vsync";
+    case PresentPolicy::uncapped:
+        return "uncapped";
+    }
+    return "unknown";
+}
+
 struct VulkanMvp::Impl final {
-    static constexpr std::uint32_t k_frames_in_flight = 2;
+    static constexpr std::uint32_t k_max_frames_in_flight = VulkanMvpOptions::k_max_frames_in_flight;
+
+    // Per-slot arrays are sized for the maximum; only the first frames_in_flight are live.
+    std::uint32_t frames_in_flight{2};
+    PresentPolicy present_policy{PresentPolicy::low_latency};
+    VkPresentModeKHR present_mode{VK_PRESENT_MODE_FIFO_KHR};
+    bool present_policy_changed{false};
+
+    // No window, surface, swapchain or ImGui; set by run_benchmark() before init_all().
+    bool headless{false};
+    // While set, read_timestamps() also appends every GPU frame time here.
+    std::vector<float> *gpu_frame_log{nullptr};
+    std::string device_name{};
 
     GLFWwindow *window{nullptr};
     bool framebuffer_resized{false};
 
     VkInstance instance{VK_NULL_HANDLE};
     VkDebugUtilsMessengerEXT debug_messenger{VK_NULL_HANDLE};
+    // VK_EXT_debug_utils; the render graph labels its passes with these for capture tools.
+    bool debug_utils_ext{false};
+    PFN_vkCmdBeginDebugUtilsLabelEXT cmd_begin_label{nullptr};
+    PFN_vkCmdEndDebugUtilsLabelEXT cmd_end_label{nullptr};
     VkSurfaceKHR surface{VK_NULL_HANDLE};
 
     VkPhysicalDevice phys{VK_NULL_HANDLE};
     VkDevice device{VK_NULL_HANDLE};
     VkQueue graphics_queue{VK_NULL_HANDLE};
     std::uint32_t graphics_queue_family{0};
+    // Dedicated transfer / async compute queues. When the device has no such family these alias
+    // graphics_queue / graphics_queue_family, so callers can always use them unconditionally.
+    VkQueue transfer_queue{VK_NULL_HANDLE};
+    std::uint32_t transfer_queue_family{0};
+    VkQueue compute_queue{VK_NULL_HANDLE};
+    std::uint32_t compute_queue_family{0};
 
     VkSwapchainKHR swapchain{VK_NULL_HANDLE};
     VkFormat swapchain_format{VK_FORMAT_UNDEFINED};
@@ -332,24 +636,193 @@ struct VulkanMvp::Impl final {
     VkRenderPass swapchain_render_pass{VK_NULL_HANDLE};
     std::vector<VkFramebuffer> swapchain_framebuffers{};
 
-    VkCommandPool cmd_pool{VK_NULL_HANDLE};
+    // One secondary command buffer and the pool it comes from, owned by a single recording task.
+    struct Recorder {
+        VkCommandPool pool{VK_NULL_HANDLE};
+        VkCommandBuffer cmd{VK_NULL_HANDLE};
+    };
 
     struct Frame {
+        // Each slot owns its pools outright, so they are reset wholesale once the slot's last
+        // submission has completed rather than buffer by buffer.
+        VkCommandPool cmd_pool{VK_NULL_HANDLE};
         VkCommandBuffer cmd{VK_NULL_HANDLE};
+        std::vector<Recorder> recorders{};
         VkSemaphore image_acquired{VK_NULL_HANDLE};
         VkSemaphore render_complete{VK_NULL_HANDLE};
-        VkFence in_flight{VK_NULL_HANDLE};
+
+        // Frame timeline value signaled by the last submission made from this slot.
+        std::uint64_t serial{0};
+
+        // Set when the last submission from this slot wrote its timestamp queries.
+        bool timestamps_pending{false};
+        // profiler::now_ns() right before that submission.
+        std::uint64_t submit_ns{0};
+        // Whether that submission rendered the offscreen pass or reused the previous image.
+        bool offscreen_rendered{false};
+
+        // Capture readback: filled by this slot's submission, read back after its timeline wait.
+        VkBuffer readback{VK_NULL_HANDLE};
+        VmaAllocation readback_alloc{VK_NULL_HANDLE};
+        const std::uint8_t *readback_mapped{nullptr};
+        VkDeviceSize readback_capacity{0};
+        bool readback_pending{false};
+        std::uint32_t readback_width{0};
+        std::uint32_t readback_height{0};
+        std::uint64_t readback_index{0};
     };
 
-    std::array<Frame, k_frames_in_flight> frames{};
+    std::array<Frame, k_max_frames_in_flight> frames{};
     std::uint32_t frame_index{0};
 
+    // Every graphics submission signals the next value on frame_pacer's timeline; that value is
+    // the submission's serial. Retired objects are destroyed by the deletion queue once their
+    // serial completes.
+    FramePacer frame_pacer{};
+    std::uint64_t completed_serial{0};
+    FramePacing frame_pacing{FramePacing::late};
+    // Frames the GPU may have queued once a new one is submitted, in [1, frames_in_flight].
+    std::uint32_t max_frame_latency{2};
+    DeletionQueue deletion_queue{};
+
     VmaAllocator allocator{VK_NULL_HANDLE};
 
+    // Memory budget: refreshed every k_memory_stats_interval frames, since
+    // vmaCalculateStatistics walks every block. Usage above k_memory_budget_warn of a heap's
+    // budget is flagged in the UI and logged once per crossing.
+    static constexpr std::uint32_t k_memory_stats_interval = 30;
+    static constexpr float k_memory_budget_warn = 0.9f;
+
+    bool memory_budget_ext{false};
+    std::uint32_t memory_heap_count{0};
+    std::array<VkMemoryHeapFlags, VK_MAX_MEMORY_HEAPS> memory_heap_flags{};
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> memory_budgets{};
+    std::array<bool, VK_MAX_MEMORY_HEAPS> memory_heap_over{};
+    VmaTotalStatistics memory_stats{};
+    std::uint32_t memory_stats_age{k_memory_stats_interval};
+
+    // Lives for the whole device lifetime; persisted to disk at shutdown. A cache that started
+    // cold is also written once the startup pipelines exist, so a launch killed before a clean
+    // shutdown still leaves the next one warm.
+    VkPipelineCache pipeline_cache{VK_NULL_HANDLE};
+    bool pipeline_cache_warm{false};
+    std::future<void> pipeline_cache_writer{};
+
+    // Uploads: a persistently mapped staging ring feeding vkCmdCopyBuffer into DEVICE_LOCAL
+    // buffers. Copies are batched into one command buffer per submit; each submit signals
+    // upload_timeline, and a batch's ring range is reused only once that value is reached.
+    static constexpr VkDeviceSize k_staging_ring_size = VkDeviceSize{32} << 20;
+    static constexpr VkDeviceSize k_staging_alignment = 16;
+    static constexpr std::uint32_t k_upload_batches = 4;
+
+    struct UploadBatch {
+        VkCommandBuffer cmd{VK_NULL_HANDLE};
+        std::uint64_t timeline_value{0};
+        // Virtual ring offset just past this batch's data.
+        VkDeviceSize ring_end{0};
+        bool recording{false};
+        bool pending{false};
+    };
+
+    VkBuffer staging_buffer{VK_NULL_HANDLE};
+    VmaAllocation staging_alloc{VK_NULL_HANDLE};
+    std::uint8_t *staging_mapped{nullptr};
+    // Monotonic virtual offsets into the ring; the physical offset is `% k_staging_ring_size`.
+    VkDeviceSize staging_head{0};
+    VkDeviceSize staging_tail{0};
+
+    // When the upload queue is on a different family than graphics, each uploaded range is
+    // released by the transfer queue and must be acquired by the next graphics command buffer.
+    struct PendingAcquire {
+        VkBuffer buffer{VK_NULL_HANDLE};
+        VkDeviceSize offset{0};
+        VkDeviceSize size{0};
+        VkAccessFlags dst_access{0};
+        VkPipelineStageFlags dst_stage{0};
+    };
+
+    VkCommandPool upload_cmd_pool{VK_NULL_HANDLE};
+    std::vector<PendingAcquire> pending_acquires{};
+    std::array<UploadBatch, k_upload_batches> upload_batches{};
+    std::uint32_t upload_batch_index{0};
+    VkSemaphore upload_timeline{VK_NULL_HANDLE};
+    std::uint64_t upload_timeline_value{0}; // last value submitted
+    std::uint64_t upload_value_waited{0};   // last value a graphics submit has waited on
+
+    // GPU timestamps: k_timestamps_per_frame queries per slot. A slot's results are read back
+    // right after its timeline wait, i.e. frames_in_flight frames later, so reading never stalls.
+    static constexpr std::uint32_t k_ts_offscreen_begin = 0;
+    static constexpr std::uint32_t k_ts_offscreen_end = 1;
+    static constexpr std::uint32_t k_ts_swapchain_begin = 2;
+    static constexpr std::uint32_t k_ts_swapchain_end = 3;
+    static constexpr std::uint32_t k_timestamps_per_frame = 4;
+
+    VkQueryPool timestamp_pool{VK_NULL_HANDLE};
+    double timestamp_period_ns{1.0};
+    std::uint64_t timestamp_mask{~0ull};
+
+    // The profiler's GPU track: timestamps map onto profiler::now_ns() through an anchor pair
+    // (tick, ns). VK_EXT_calibrated_timestamps samples both clocks at once, about once a second;
+    // without it the anchor is moved whenever a frame would start before its submit.
+    static constexpr std::uint64_t k_calibration_interval_ns = 1'000'000'000;
+    PFN_vkGetCalibratedTimestampsEXT get_calibrated_timestamps{nullptr};
+    bool gpu_anchor_valid{false};
+    std::uint64_t gpu_anchor_tick{0};
+    std::uint64_t gpu_anchor_ns{0};
+    std::uint64_t last_calibration_ns{0};
+    std::string trace_path{};
+    std::string trace_status{};
+
+    RollingStats gpu_offscreen_ms{};
+    RollingStats gpu_swapchain_ms{};
+    RollingStats gpu_frame_ms{};
+    RollingStats cpu_frame_ms{};
+    RollingStats cpu_work_ms{};
+
+    RollingStats cpu_wait_ms{};
+
+    // Low-latency mode: block until the newest frame is on screen (VK_KHR_present_wait) or at
+    // least rendered (frame timeline) *before* polling input, run with one frame queued, and
+    // optionally sleep until the latest start that still makes the target frame period.
+    static constexpr std::uint64_t k_present_wait_timeout_ns = 100'000'000;
+    static constexpr float k_latency_slack_ms = 1.0f;
+
+    bool low_latency{false};
+    bool latency_sleep{false};
+    float latency_target_hz{60.0f};
+    bool present_wait_ext{false};
+    PFN_vkWaitForPresentKHR wait_for_present{nullptr};
+    // Present ids are frame serials; 0 = nothing presented on the current swapchain yet.
+    std::uint64_t last_present_id{0};
+    // When each frame's input was polled, indexed by serial.
+    std::array<std::chrono::steady_clock::time_point, 8> input_sample_times{};
+    RollingStats input_latency_ms{};
+    bool latency_to_present{false}; // last sample ended at present rather than GPU completion
+    float latency_sleep_ms{0.0f};
+
+    std::chrono::steady_clock::time_point last_frame_begin{};
+    // This frame's pacing and acquire waits; pacing_wait_ms is the timeline part of it.
+    float frame_wait_ms{0.0f};
+    float pacing_wait_ms{0.0f};
+    // While set, begin_frame() also appends every frame's pacing wait here.
+    std::vector<float> *cpu_wait_log{nullptr};
+
+    // Frame capture: each frame's offscreen color is copied into its slot's readback buffer and
+    // handed to the writer thread frames_in_flight frames later, after the slot's timeline wait.
+    // `capturing` gates the copies; the writer is stopped once every pending readback is drained.
+    FrameCapture frame_capture{};
+    CaptureFormat capture_format{CaptureFormat::png};
+    bool capture_on_start{false};
+    bool capturing{false};
+    std::uint64_t captured_frames{0};
+    std::string capture_error{};
+
     // ImGui
     VkDescriptorPool imgui_desc_pool{VK_NULL_HANDLE};
 
-    // Offscreen (per frame-in-flight)
+    // Offscreen (per viewport and frame-in-flight)
+    static constexpr std::uint32_t k_max_viewports = VulkanMvpOptions::k_max_viewports;
+
     VkRenderPass offscreen_render_pass{VK_NULL_HANDLE};
     VkSampler offscreen_sampler{VK_NULL_HANDLE};
     VkFormat offscreen_color_format{VK_FORMAT_R8G8B8A8_UNORM};
@@ -358,30 +831,329 @@ struct VulkanMvp::Impl final {
     struct OffscreenFrame {
         VkImage color_image{VK_NULL_HANDLE};
         VmaAllocation color_alloc{VK_NULL_HANDLE};
+        VmaPool color_pool{VK_NULL_HANDLE};
         VkImageView color_view{VK_NULL_HANDLE};
 
-        VkImage depth_image{VK_NULL_HANDLE};
-        VmaAllocation depth_alloc{VK_NULL_HANDLE};
-        VkImageView depth_view{VK_NULL_HANDLE};
-
+        // Depth and the MSAA color are transients of the slot's render graph; the framebuffer is
+        // rebuilt whenever the graph hands this frame other images or destroys any of its own.
         VkFramebuffer framebuffer{VK_NULL_HANDLE};
+        VkImageView framebuffer_msaa_view{VK_NULL_HANDLE};
+        VkImageView framebuffer_depth_view{VK_NULL_HANDLE};
+        std::uint64_t framebuffer_generation{0};
 
         VkDescriptorSet imgui_texture_set{VK_NULL_HANDLE};
 
         std::uint32_t width{1};
         std::uint32_t height{1};
+        // The dynamic-resolution area this frame draws into, anchored at the top-left corner.
+        std::uint32_t render_width{1};
+        std::uint32_t render_height{1};
     };
 
-    std::array<OffscreenFrame, k_frames_in_flight> offscreen{};
+    // Offscreen images come from VmaPools keyed by format, usage and a resolution bucket, each
+    // block sized for one image at the bucket's upper bound. Resizing within a bucket reuses the
+    // pool's blocks instead of calling vkAllocateMemory. A pool outlives its last image so a resize
+    // back across a bucket boundary finds it again; empty pools are evicted, oldest first, once
+    // idle for k_render_target_idle_frames or beyond k_max_idle_render_target_pools.
+    static constexpr std::uint32_t k_render_target_bucket = 256;
+    static constexpr std::uint64_t k_render_target_idle_frames = 240;
+    static constexpr std::size_t k_max_idle_render_target_pools = 4;
+
+    struct RenderTargetPool {
+        VkFormat format{VK_FORMAT_UNDEFINED};
+        VkImageUsageFlags usage{0};
+        std::uint32_t bucket_width{0};
+        std::uint32_t bucket_height{0};
+        VmaPool pool{VK_NULL_HANDLE};
+        std::uint32_t live{0};
+        // Submission serial at which live last dropped to zero.
+        std::uint64_t idle_since{0};
+    };
+
+    std::vector<RenderTargetPool> render_target_pools{};
+    // Depth and the MSAA color are never sampled or stored: with LAZILY_ALLOCATED memory
+    // (tilers) they stay in tile memory and never get backing pages.
+    bool lazy_attachments{false};
+
+    // One graph per frame slot: its transient images are reused until the slot's next turn.
+    // Every viewport's depth and MSAA color only live within its own pass, so the graph places
+    // them all in the same memory.
+    std::array<RenderGraph, k_max_frames_in_flight> render_graphs{};
+
+    // With MSAA the pass draws into a multisampled transient that the subpass resolves into
+    // color_image. The render pass, the framebuffers and the cube pipeline all depend on the
+    // sample count, so changing it retires and rebuilds them.
+    std::uint32_t requested_msaa_samples{1};
+    VkSampleCountFlags supported_offscreen_samples{VK_SAMPLE_COUNT_1_BIT};
+    VkSampleCountFlagBits offscreen_samples{VK_SAMPLE_COUNT_1_BIT};
+
+    // Dynamic resolution: offscreen images keep the viewport size and each frame renders a
+    // scaled top-left area of them, which the viewport samples back up through
+    // offscreen_sampler. The scale follows the measured offscreen GPU time.
+    DynamicResolution dynamic_resolution{};
+    float dynamic_resolution_target_ms{8.0f};
+
+    // Lazy resize: each slot is reallocated on its own turn once the requested viewport size
+    // has stopped changing, so dragging a splitter never stalls the GPU.
+    static constexpr std::uint32_t k_resize_settle_frames = 4;
+    static constexpr std::chrono::milliseconds k_resize_settle_time{66};
+
+    bool lazy_offscreen_resize{true};
 
     // Cube pipeline + vertex buffer (rendered into offscreen)
-    VkPipelineLayout cube_pipeline_layout{VK_NULL_HANDLE};
     VkPipeline cube_pipeline{VK_NULL_HANDLE};
 
+    // Frustum culling compute pass; binds the same bindless heap as the cube pipeline.
+    static constexpr std::uint32_t k_cull_group_size = 64;
+    VkPipeline cull_pipeline{VK_NULL_HANDLE};
+    bool gpu_culling{true};
+    // Core in 1.2 but optional; without it the draw is issued with vkCmdDrawIndexedIndirect,
+    // which still draws nothing when the cull pass leaves instanceCount at zero.
+    bool draw_indirect_count{false};
+
+    // Task/mesh shader path (VK_EXT_mesh_shader). cube.task culls each meshlet against the
+    // frustum and its normal cone and only emits the survivors, so the cull pass is skipped.
+    // mesh_shaders is the user's choice; it only takes effect when mesh_shader_ext is set.
+    static constexpr std::uint32_t k_task_group_size = 32;
+    // The spec minimum for maxTaskWorkGroupCount[0]; larger draws are split.
+    static constexpr std::uint32_t k_max_task_groups_per_draw = 65535;
+    bool mesh_shader_ext{false};
+    bool mesh_shaders{true};
+    PFN_vkCmdDrawMeshTasksEXT draw_mesh_tasks{nullptr};
+    VkPipeline meshlet_pipeline{VK_NULL_HANDLE};
+
+    // Indexed cube mesh; the vertex format is fixed for the lifetime of the pipeline.
+    bool compact_vertices{false};
     VkBuffer cube_vbo{VK_NULL_HANDLE};
     VmaAllocation cube_vbo_alloc{VK_NULL_HANDLE};
+    VkBuffer cube_ibo{VK_NULL_HANDLE};
+    VmaAllocation cube_ibo_alloc{VK_NULL_HANDLE};
+
+    // With mesh_path set, cube_vbo/cube_ibo hold a .pbamesh instead, streamed in a budget per
+    // frame straight out of the file mapping; every triangle that has arrived is drawn. The mesh
+    // is fitted into the cube's bounding sphere so the instance grid and culling stay unchanged.
+    // Streamed meshes always use float32 vertices and never take the mesh shader path.
+    static constexpr VkDeviceSize k_mesh_stream_budget = k_staging_ring_size / 2u;
+    std::string mesh_path{};
+    MeshFile mesh_file{};
+    MeshStreamer mesh_streamer{};
+    glm::mat4 mesh_fit{1.0f};
+    // The instance matrices include mesh_fit, so the cull pass tests the mesh's own (pre-fit)
+    // bounding sphere rather than the cube's.
+    glm::vec4 mesh_sphere{k_cube_bounding_sphere};
+
+    // The same mesh split into meshlets at load, for the mesh shader path: float vertices,
+    // meshlets, meshlet vertices and packed triangles, each in its own bindless slot.
+    static constexpr std::uint32_t k_meshlet_buffers = 4;
+    std::array<VkBuffer, k_meshlet_buffers> meshlet_buffers{};
+    std::array<VmaAllocation, k_meshlet_buffers> meshlet_buffer_allocs{};
+    std::array<std::uint32_t, k_meshlet_buffers> meshlet_slots{
+        BindlessHeap::k_invalid_slot, BindlessHeap::k_invalid_slot, BindlessHeap::k_invalid_slot,
+        BindlessHeap::k_invalid_slot};
+    std::uint32_t meshlet_count{0};
+    // Built by a startup job, uploaded and released once the upload context exists.
+    MeshletMesh startup_meshlets{};
+
+    // Every shader resource lives in one global descriptor set bound once per command buffer;
+    // draws select buffers by slot through push constants. Sized from the device limits.
+    static constexpr std::uint32_t k_bindless_max_buffers = 4096;
+    static constexpr std::uint32_t k_bindless_max_images = 4096;
+    BindlessHeap bindless{};
+    std::uint32_t bindless_buffer_capacity{0};
+    std::uint32_t bindless_image_capacity{0};
+    // Shared by every bindless pipeline so the heap binding survives pipeline switches.
+    VkPipelineLayout bindless_pipeline_layout{VK_NULL_HANDLE};
+    VkShaderStageFlags bindless_push_stages{0};
+
+    VkBuffer material_buffer{VK_NULL_HANDLE};
+    VmaAllocation material_buffer_alloc{VK_NULL_HANDLE};
+    std::uint32_t material_slot{BindlessHeap::k_invalid_slot};
+
+    // Instancing: one persistently mapped SSBO of InstanceData per frame slot. A slot's buffer
+    // is only written after its timeline wait, so the CPU never races the GPU reading it.
+    static constexpr std::uint32_t k_max_instances = 1'000'000;
+    static constexpr float k_instance_spacing = 1.6f;
+
+    // One viewport's GPU culling outputs: compacted visible instance indices and the indirect
+    // draw, with their bindless slots.
+    struct CullOutput {
+        VkBuffer visible{VK_NULL_HANDLE};
+        VmaAllocation visible_alloc{VK_NULL_HANDLE};
+        VkBuffer draw_args{VK_NULL_HANDLE};
+        VmaAllocation draw_args_alloc{VK_NULL_HANDLE};
+
+        std::uint32_t visible_slot{BindlessHeap::k_invalid_slot};
+        std::uint32_t draw_args_slot{BindlessHeap::k_invalid_slot};
+    };
+
+    struct InstanceBuffer {
+        VkBuffer buffer{VK_NULL_HANDLE};
+        VmaAllocation alloc{VK_NULL_HANDLE};
+
+        // Only used when VMA could not give us host-visible device memory (no ReBAR/UMA):
+        // the CPU writes here and the frame's command buffer copies into `buffer`.
+        VkBuffer staging{VK_NULL_HANDLE};
+        VmaAllocation staging_alloc{VK_NULL_HANDLE};
+
+        // The instances are shared by every viewport; each one culls them into its own output.
+        // Only the first cull_count entries exist.
+        std::array<CullOutput, k_max_viewports> culls{};
+        std::uint32_t cull_count{0};
+
+        InstanceData *mapped{nullptr};
+        std::uint32_t capacity{0};
+        std::uint32_t count{0};
 
+        // Bindless slot of buffer.
+        std::uint32_t instance_slot{BindlessHeap::k_invalid_slot};
+    };
+
+    std::array<InstanceBuffer, k_max_frames_in_flight> instance_buffers{};
+
+    int instance_count{1};
+
+    // Instance transforms in SoA form, packed straight into the mapped instance buffer by
+    // compose_transforms(). Positions and scales only change with the grid; rotations are
+    // animated every frame.
+    TransformBatch instance_transforms{};
+    std::uint32_t instance_transforms_side{0};
+
+    // Per-frame CPU work (instance transforms, offscreen recording, later the simulation step)
+    // runs on one work-stealing job system with a thread per core. A job updates this many
+    // instances; below that splitting costs more than it saves.
+    static constexpr std::uint32_t k_instances_per_job = 4096;
+    std::unique_ptr<JobSystem> jobs{};
+
+    // Parallel recording of the viewports' offscreen passes, one secondary command buffer each.
+    // With one record thread or one viewport every pass is recorded inline.
+    static constexpr std::uint32_t k_max_record_threads = 16;
+    std::uint32_t record_threads{1};
+    // Whether this frame's offscreen passes were recorded into secondaries.
+    bool offscreen_secondaries{false};
+
+    // Animation clock. While paused the scene time stays at paused_at; resuming moves start_time
+    // forward by the pause so the rotation continues where it stopped.
     std::chrono::steady_clock::time_point start_time{std::chrono::steady_clock::now()};
+    std::chrono::steady_clock::time_point paused_at{};
+    bool scene_paused{false};
+
+    // Cold launch time matters for kiosk restarts: logged once the first frame is presented.
+    std::chrono::steady_clock::time_point launch_time{std::chrono::steady_clock::now()};
+    double init_ms{0.0};
+    bool first_frame_logged{false};
+
+    // On-demand rendering: a viewport renders its offscreen pass only if what it would draw
+    // differs from the image it rendered last; otherwise it keeps sampling that image (from
+    // whichever slot drew it). Once no viewport renders, the loop waits for events instead of
+    // spinning.
+    static constexpr double k_idle_event_timeout_s = 0.1;
+
+    struct OffscreenContent {
+        std::uint64_t revision{0};
+        float time{0.0f};
+        glm::mat4 view_proj{1.0f};
+    };
+
+    bool on_demand_render{true};
+    // Bumped by anything that changes the scene but not the animation time or camera.
+    std::uint64_t scene_revision{0};
+    // Whether any viewport renders this frame.
+    bool render_offscreen{true};
+    bool offscreen_idle{false};
+    std::uint64_t reused_offscreen_frames{0};
+
+    // An orbit around the grid center, Z up. `distance` is in units of the grid zoom, so the
+    // whole grid stays in view as the instance count changes.
+    struct OrbitCamera {
+        float yaw_deg{0.0f};
+        float pitch_deg{0.0f};
+        float distance{1.0f};
+    };
+
+    // Dragging a viewport orbits its camera, the wheel moves it in and out.
+    static constexpr float k_orbit_deg_per_px = 0.3f;
+    static constexpr float k_max_pitch_deg = 89.0f;
+    static constexpr float k_wheel_zoom_step = 0.9f;
+    // The original fixed camera position, before viewports could orbit.
+    static constexpr glm::vec3 k_default_eye{2.4f, -3.2f, 1.8f};
+    static constexpr std::array<const char *, k_max_viewports> k_viewport_windows{
+        "Viewport", "Viewport 2", "Viewport 3", "Viewport 4", "Viewport 5", "Viewport 6"};
+    static constexpr std::array<const char *, k_max_viewports> k_viewport_passes{
+        "offscreen", "offscreen 2", "offscreen 3", "offscreen 4", "offscreen 5", "offscreen 6"};
+
+    // One camera view of the shared scene: its own camera, offscreen images, lazy resize and
+    // on-demand state. Pipelines, meshes and instance data are shared by all of them.
+    struct Viewport {
+        OrbitCamera camera{};
+        std::array<OffscreenFrame, k_max_frames_in_flight> frames{};
+
+        std::uint32_t requested_width{0};
+        std::uint32_t requested_height{0};
+        std::uint32_t requested_stable_frames{0};
+        std::chrono::steady_clock::time_point requested_since{};
+
+        // Decided in build_ui() (always true when headless), committed in record_frame().
+        bool render{true};
+        std::uint32_t shown{0};
+        bool shown_valid{false};
+        OffscreenContent shown_content{};
+    };
+
+    // Only the first viewport_count entries have images.
+    std::array<Viewport, k_max_viewports> viewports{};
+    std::uint32_t viewport_count{1};
+
+    // What one viewport's offscreen pass draws this frame; filled while building the frame graph
+    // and read by the recording tasks. Its secondary, if any, is fr.recorders[index].
+    struct ViewDraw {
+        OffscreenFrame *frame{nullptr};
+        const CullOutput *cull{nullptr};
+        glm::mat4 view_proj{1.0f};
+        glm::vec3 eye{0.0f};
+        RgResource depth{};
+        RgResource msaa_color{};
+    };
+
+    std::array<ViewDraw, k_max_viewports> view_draws{};
+    std::uint32_t view_draw_count{0};
+
+    explicit Impl(const VulkanMvpOptions &options)
+        : frames_in_flight{options.frames_in_flight},
+          present_policy{options.present_policy},
+          compact_vertices{options.compact_vertices && options.mesh_path.empty()},
+          mesh_path{options.mesh_path},
+          trace_path{options.trace_path} {
+        if (frames_in_flight < 1u || frames_in_flight > k_max_frames_in_flight) {
+            throw std::runtime_error("frames_in_flight must be in [1, " +
+                                     std::to_string(k_max_frames_in_flight) + "]");
+        }
+        if (options.viewports < 1u || options.viewports > k_max_viewports) {
+            throw std::runtime_error("viewports must be in [1, " + std::to_string(k_max_viewports) + "]");
+        }
+        viewport_count = options.viewports;
+        for (std::uint32_t i = 0; i < k_max_viewports; ++i) {
+            viewports[i].camera = initial_camera(i);
+        }
+        record_threads = (options.record_threads != 0u)
+                             ? options.record_threads
+                             : std::max(1u, std::thread::hardware_concurrency());
+        record_threads = std::min(record_threads, k_max_record_threads);
+        capture_format = options.capture_format;
+        capture_on_start = options.capture;
+        frame_pacing = options.frame_pacing;
+        low_latency = options.low_latency;
+        max_frame_latency = (options.max_frame_latency != 0u)
+                                ? std::min(options.max_frame_latency, frames_in_flight)
+                                : frames_in_flight;
+        requested_msaa_samples = options.msaa_samples;
+        on_demand_render = options.on_demand_render;
+        mesh_shaders = options.mesh_shaders;
+        scene_paused = options.start_paused;
+        if (options.dynamic_resolution_ms > 0.0f) {
+            dynamic_resolution_target_ms = options.dynamic_resolution_ms;
+            dynamic_resolution.set_target_ms(options.dynamic_resolution_ms);
+        }
+    }
 
     static void imgui_check_vk_result(VkResult err) {
         if (err != VK_SUCCESS) {
@@ -413,22 +1185,41 @@ struct VulkanMvp::Impl final {
 
         glfwSetWindowUserPointer(window, this);
         glfwSetFramebufferSizeCallback(window, framebuffer_resize_callback);
-    }
 
-    [[nodiscard]] std::vector<const char *> get_instance_extensions() const {
-        std::uint32_t glfw_count = 0;
-        const char **glfw_exts = glfwGetRequiredInstanceExtensions(&glfw_count);
-        if (!glfw_exts || glfw_count == 0) {
-            throw std::runtime_error("glfwGetRequiredInstanceExtensions returned none");
+        // The deadline sleep aims at the primary monitor's refresh until the UI says otherwise.
+        if (GLFWmonitor *monitor = glfwGetPrimaryMonitor()) {
+            if (const GLFWvidmode *mode = glfwGetVideoMode(monitor); mode && mode->refreshRate > 0) {
+                latency_target_hz = static_cast<float>(mode->refreshRate);
+            }
         }
+    }
 
+    [[nodiscard]] std::vector<const char *> get_instance_extensions() {
         std::vector<const char *> exts;
-        exts.reserve(static_cast<std::size_t>(glfw_count) + 4u);
-        for (std::uint32_t i = 0; i < glfw_count; ++i) {
-            exts.push_back(glfw_exts[i]);
+        if (!headless) {
+            std::uint32_t glfw_count = 0;
+            const char **glfw_exts = glfwGetRequiredInstanceExtensions(&glfw_count);
+            if (!glfw_exts || glfw_count == 0) {
+                throw std::runtime_error("glfwGetRequiredInstanceExtensions returned none");
+            }
+
+            exts.reserve(static_cast<std::size_t>(glfw_count) + 4u);
+            for (std::uint32_t i = 0; i < glfw_count; ++i) {
+                exts.push_back(glfw_exts[i]);
+            }
         }
 
-        if constexpr (k_enable_validation) {
+        std::uint32_t available_count = 0;
+        vk_check(vkEnumerateInstanceExtensionProperties(nullptr, &available_count, nullptr),
+                 "vkEnumerateInstanceExtensionProperties(count)");
+        std::vector<VkExtensionProperties> available(available_count);
+        vk_check(vkEnumerateInstanceExtensionProperties(nullptr, &available_count, available.data()),
+                 "vkEnumerateInstanceExtensionProperties(list)");
+
+        // Validation needs it for the messenger. Otherwise it only carries the command buffer
+        // labels, so it is enabled whenever the loader offers it.
+        debug_utils_ext = k_enable_validation || has_extension(available, VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+        if (debug_utils_ext) {
             exts.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
         }
 
@@ -487,6 +1278,12 @@ struct VulkanMvp::Impl final {
         if constexpr (k_enable_validation) {
             debug_messenger = create_debug_messenger(instance);
         }
+        if (debug_utils_ext) {
+            cmd_begin_label = reinterpret_cast<PFN_vkCmdBeginDebugUtilsLabelEXT>(
+                vkGetInstanceProcAddr(instance, "vkCmdBeginDebugUtilsLabelEXT"));
+            cmd_end_label = reinterpret_cast<PFN_vkCmdEndDebugUtilsLabelEXT>(
+                vkGetInstanceProcAddr(instance, "vkCmdEndDebugUtilsLabelEXT"));
+        }
     }
 
     void create_surface() {
@@ -499,6 +1296,9 @@ struct VulkanMvp::Impl final {
     struct DeviceChoice {
         VkPhysicalDevice dev{VK_NULL_HANDLE};
         std::uint32_t gfx_qfam{0};
+        std::uint32_t transfer_qfam{0};
+        std::uint32_t compute_qfam{0};
+        bool mesh_shader{false}; // VK_EXT_mesh_shader is available; its features are checked later
     };
 
     [[nodiscard]] DeviceChoice pick_physical_device() {
@@ -524,9 +1324,10 @@ struct VulkanMvp::Impl final {
                      "vkEnumerateDeviceExtensionProperties(list)");
 
             const bool has_swapchain = has_extension(exts, VK_KHR_SWAPCHAIN_EXTENSION_NAME);
-            if (!has_swapchain) {
+            if (!has_swapchain && !headless) {
                 continue;
             }
+            const bool mesh_shader = has_extension(exts, VK_EXT_MESH_SHADER_EXTENSION_NAME);
 
             // Find a queue family that supports graphics + present
             std::uint32_t qf_count = 0;
@@ -537,18 +1338,31 @@ struct VulkanMvp::Impl final {
             for (std::uint32_t i = 0; i < qf_count; ++i) {
                 const bool gfx = (qfs[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0u;
 
-                VkBool32 present = VK_FALSE;
-                vk_check(vkGetPhysicalDeviceSurfaceSupportKHR(d, i, surface, &present),
-                         "vkGetPhysicalDeviceSurfaceSupportKHR");
+                // Headless runs only need graphics; there is no surface to present to.
+                VkBool32 present = headless ? VK_TRUE : VK_FALSE;
+                if (!headless) {
+                    vk_check(vkGetPhysicalDeviceSurfaceSupportKHR(d, i, surface, &present),
+                             "vkGetPhysicalDeviceSurfaceSupportKHR");
+                }
 
                 if (gfx && (present == VK_TRUE)) {
                     VkPhysicalDeviceProperties props{};
                     vkGetPhysicalDeviceProperties(d, &props);
 
+                    // Transfer-only first (copy engine), then anything without graphics.
+                    const std::uint32_t transfer =
+                        find_dedicated_queue_family(qfs, VK_QUEUE_TRANSFER_BIT,
+                                                    VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)
+                            .value_or(find_dedicated_queue_family(qfs, VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT)
+                                          .value_or(i));
+                    const std::uint32_t compute =
+                        find_dedicated_queue_family(qfs, VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT).value_or(i);
+                    const DeviceChoice choice{d, i, transfer, compute, mesh_shader};
+
                     if (!best.has_value()) {
-                        best = DeviceChoice{d, i};
+                        best = choice;
                     } else if (props.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
-                        best = DeviceChoice{d, i};
+                        best = choice;
                     }
                     break;
                 }
@@ -566,6 +1380,8 @@ struct VulkanMvp::Impl final {
         const DeviceChoice choice = pick_physical_device();
         phys = choice.dev;
         graphics_queue_family = choice.gfx_qfam;
+        transfer_queue_family = choice.transfer_qfam;
+        compute_queue_family = choice.compute_qfam;
 
         std::uint32_t ext_count = 0;
         vk_check(vkEnumerateDeviceExtensionProperties(phys, nullptr, &ext_count, nullptr),
@@ -575,7 +1391,27 @@ struct VulkanMvp::Impl final {
                  "vkEnumerateDeviceExtensionProperties(list)");
 
         std::vector<const char *> dev_exts;
-        dev_exts.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        if (!headless) {
+            dev_exts.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        }
+
+        // Lets VMA report the driver's real per-process budget instead of guessing from heap sizes.
+        memory_budget_ext = has_extension(exts, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        if (memory_budget_ext) {
+            dev_exts.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
+
+        // Puts the profiler's GPU zones on its own clock; needs the host domain as well.
+        const bool calibrated_timestamps = profiler::k_enabled &&
+                                           has_extension(exts, VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME) &&
+                                           calibrateable_to_host();
+        if (calibrated_timestamps) {
+            dev_exts.push_back(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+        }
+
+        // present_wait needs present_id; both also need their features, checked below.
+        const bool present_wait_available = !headless && has_extension(exts, VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+                                            has_extension(exts, VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
 
 #if defined(__APPLE__)
         // Often required on MoltenVK
@@ -584,29 +1420,151 @@ struct VulkanMvp::Impl final {
         }
 #endif
 
+        // One queue per distinct family; the transfer/compute families may equal graphics.
         const float prio = 1.0f;
-        VkDeviceQueueCreateInfo qci{};
-        qci.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-        qci.pNext = nullptr;
-        qci.flags = 0;
-        qci.queueFamilyIndex = graphics_queue_family;
-        qci.queueCount = 1;
-        qci.pQueuePriorities = &prio;
+        std::vector<VkDeviceQueueCreateInfo> qcis;
+        for (std::uint32_t family : {graphics_queue_family, transfer_queue_family, compute_queue_family}) {
+            const bool seen = std::any_of(qcis.begin(), qcis.end(), [family](const VkDeviceQueueCreateInfo &q) {
+                return q.queueFamilyIndex == family;
+            });
+            if (seen) {
+                continue;
+            }
+            VkDeviceQueueCreateInfo qci{};
+            qci.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            qci.pNext = nullptr;
+            qci.flags = 0;
+            qci.queueFamilyIndex = family;
+            qci.queueCount = 1;
+            qci.pQueuePriorities = &prio;
+            qcis.push_back(qci);
+        }
 
         std::vector<const char *> layers;
         if constexpr (k_enable_validation) {
             layers.push_back(k_validation_layer);
         }
 
+        VkPhysicalDeviceProperties props{};
+        vkGetPhysicalDeviceProperties(phys, &props);
+        if (props.apiVersion < VK_API_VERSION_1_2) {
+            throw std::runtime_error("Vulkan 1.2 device required");
+        }
+        device_name = props.deviceName;
+
+        // Size the bindless heap within the update-after-bind limits; both of its arrays count
+        // against the per-stage resource limit.
+        VkPhysicalDeviceVulkan12Properties props12{};
+        props12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+        props12.pNext = nullptr;
+
+        VkPhysicalDeviceProperties2 props2{};
+        props2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        props2.pNext = &props12;
+        vkGetPhysicalDeviceProperties2(phys, &props2);
+
+        bindless_buffer_capacity = std::min({k_bindless_max_buffers,
+                                             props12.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+                                             props12.maxDescriptorSetUpdateAfterBindStorageBuffers,
+                                             props12.maxPerStageUpdateAfterBindResources / 2u});
+        bindless_image_capacity = std::min({k_bindless_max_images,
+                                            props12.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                                            props12.maxPerStageDescriptorUpdateAfterBindSamplers,
+                                            props12.maxDescriptorSetUpdateAfterBindSampledImages,
+                                            props12.maxDescriptorSetUpdateAfterBindSamplers,
+                                            props12.maxPerStageUpdateAfterBindResources - bindless_buffer_capacity});
+
+        VkPhysicalDevicePresentWaitFeaturesKHR supported_present_wait{};
+        supported_present_wait.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+        supported_present_wait.pNext = nullptr;
+
+        VkPhysicalDevicePresentIdFeaturesKHR supported_present_id{};
+        supported_present_id.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+        supported_present_id.pNext = &supported_present_wait;
+
+        VkPhysicalDeviceMeshShaderFeaturesEXT supported_mesh{};
+        supported_mesh.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+        supported_mesh.pNext = present_wait_available ? &supported_present_id : nullptr;
+
+        VkPhysicalDeviceVulkan12Features supported12{};
+        supported12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        supported12.pNext = choice.mesh_shader ? &supported_mesh : supported_mesh.pNext;
+
+        VkPhysicalDeviceFeatures2 supported{};
+        supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        supported.pNext = &supported12;
+        vkGetPhysicalDeviceFeatures2(phys, &supported);
+
+        if (supported12.timelineSemaphore != VK_TRUE) {
+            throw std::runtime_error("timelineSemaphore feature required");
+        }
+        if (supported12.runtimeDescriptorArray != VK_TRUE || supported12.descriptorBindingPartiallyBound != VK_TRUE ||
+            supported12.descriptorBindingVariableDescriptorCount != VK_TRUE ||
+            supported12.descriptorBindingStorageBufferUpdateAfterBind != VK_TRUE ||
+            supported12.descriptorBindingSampledImageUpdateAfterBind != VK_TRUE) {
+            throw std::runtime_error("descriptor indexing features required for the bindless heap (runtime arrays, "
+                                     "partially bound, variable count, update-after-bind)");
+        }
+
         VkPhysicalDeviceFeatures feats{};
         feats.samplerAnisotropy = VK_TRUE;
 
+        VkPhysicalDeviceVulkan12Features feats12{};
+        feats12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        feats12.pNext = nullptr;
+        feats12.timelineSemaphore = VK_TRUE;
+        feats12.runtimeDescriptorArray = VK_TRUE;
+        feats12.descriptorBindingPartiallyBound = VK_TRUE;
+        feats12.descriptorBindingVariableDescriptorCount = VK_TRUE;
+        feats12.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+        feats12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        // Slots are dynamically uniform today; non-uniform indexing is enabled for materials that
+        // pick resources per instance.
+        feats12.shaderStorageBufferArrayNonUniformIndexing = supported12.shaderStorageBufferArrayNonUniformIndexing;
+        feats12.shaderSampledImageArrayNonUniformIndexing = supported12.shaderSampledImageArrayNonUniformIndexing;
+        feats12.drawIndirectCount = supported12.drawIndirectCount;
+        draw_indirect_count = (supported12.drawIndirectCount == VK_TRUE);
+
+        present_wait_ext = present_wait_available && supported_present_id.presentId == VK_TRUE &&
+                           supported_present_wait.presentWait == VK_TRUE;
+
+        VkPhysicalDevicePresentWaitFeaturesKHR present_wait_feats{};
+        present_wait_feats.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+        present_wait_feats.pNext = nullptr;
+        present_wait_feats.presentWait = VK_TRUE;
+
+        VkPhysicalDevicePresentIdFeaturesKHR present_id_feats{};
+        present_id_feats.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+        present_id_feats.pNext = &present_wait_feats;
+        present_id_feats.presentId = VK_TRUE;
+
+        if (present_wait_ext) {
+            dev_exts.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+            dev_exts.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+            feats12.pNext = &present_id_feats;
+        }
+
+        // Only task and mesh shaders; the multiview/query/shading-rate extras stay off.
+        mesh_shader_ext = choice.mesh_shader && supported_mesh.taskShader == VK_TRUE &&
+                          supported_mesh.meshShader == VK_TRUE;
+
+        VkPhysicalDeviceMeshShaderFeaturesEXT mesh_feats{};
+        mesh_feats.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+        mesh_feats.pNext = feats12.pNext;
+        mesh_feats.taskShader = VK_TRUE;
+        mesh_feats.meshShader = VK_TRUE;
+
+        if (mesh_shader_ext) {
+            dev_exts.push_back(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+            feats12.pNext = &mesh_feats;
+        }
+
         VkDeviceCreateInfo dci{};
         dci.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-        dci.pNext = nullptr;
+        dci.pNext = &feats12;
         dci.flags = 0;
-        dci.queueCreateInfoCount = 1;
-        dci.pQueueCreateInfos = &qci;
+        dci.queueCreateInfoCount = static_cast<std::uint32_t>(qcis.size());
+        dci.pQueueCreateInfos = qcis.data();
         dci.enabledExtensionCount = static_cast<std::uint32_t>(dev_exts.size());
         dci.ppEnabledExtensionNames = dev_exts.data();
         dci.enabledLayerCount = static_cast<std::uint32_t>(layers.size());
@@ -616,14 +1574,59 @@ struct VulkanMvp::Impl final {
         vk_check(vkCreateDevice(phys, &dci, nullptr, &device), "vkCreateDevice");
 
         vkGetDeviceQueue(device, graphics_queue_family, 0, &graphics_queue);
-        if (!graphics_queue) {
+        vkGetDeviceQueue(device, transfer_queue_family, 0, &transfer_queue);
+        vkGetDeviceQueue(device, compute_queue_family, 0, &compute_queue);
+        if (!graphics_queue || !transfer_queue || !compute_queue) {
             throw std::runtime_error("vkGetDeviceQueue returned null");
         }
+
+        if (present_wait_ext) {
+            wait_for_present =
+                reinterpret_cast<PFN_vkWaitForPresentKHR>(vkGetDeviceProcAddr(device, "vkWaitForPresentKHR"));
+            present_wait_ext = (wait_for_present != nullptr);
+        }
+        if (mesh_shader_ext) {
+            draw_mesh_tasks =
+                reinterpret_cast<PFN_vkCmdDrawMeshTasksEXT>(vkGetDeviceProcAddr(device, "vkCmdDrawMeshTasksEXT"));
+            mesh_shader_ext = (draw_mesh_tasks != nullptr);
+        }
+        if (calibrated_timestamps) {
+            get_calibrated_timestamps = reinterpret_cast<PFN_vkGetCalibratedTimestampsEXT>(
+                vkGetDeviceProcAddr(device, "vkGetCalibratedTimestampsEXT"));
+        }
+    }
+
+    // Whether the device can sample its timestamp counter together with host_time_domain().
+    [[nodiscard]] bool calibrateable_to_host() const {
+        const std::optional<VkTimeDomainEXT> host = host_time_domain();
+        const auto get_domains = reinterpret_cast<PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT>(
+            vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceCalibrateableTimeDomainsEXT"));
+        if (!host.has_value() || !get_domains) {
+            return false;
+        }
+
+        std::uint32_t count = 0;
+        if (get_domains(phys, &count, nullptr) != VK_SUCCESS) {
+            return false;
+        }
+        std::vector<VkTimeDomainEXT> domains(count);
+        if (get_domains(phys, &count, domains.data()) != VK_SUCCESS) {
+            return false;
+        }
+        const auto has = [&domains](VkTimeDomainEXT d) {
+            return std::find(domains.begin(), domains.end(), d) != domains.end();
+        };
+        return has(VK_TIME_DOMAIN_DEVICE_EXT) && has(*host);
     }
 
     void create_allocator() {
+        // Dedicated allocation and bind-memory2 are core at vulkanApiVersion 1.2, so VMA uses them
+        // without their KHR flags; only the budget extension is optional.
         VmaAllocatorCreateInfo ci{};
         ci.flags = 0;
+        if (memory_budget_ext) {
+            ci.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+        }
         ci.physicalDevice = phys;
         ci.device = device;
         ci.preferredLargeHeapBlockSize = 0;
@@ -636,15 +1639,127 @@ struct VulkanMvp::Impl final {
         ci.pTypeExternalMemoryHandleTypes = nullptr;
 
         vk_check(vmaCreateAllocator(&ci, &allocator), "vmaCreateAllocator");
+
+        const VkPhysicalDeviceMemoryProperties *mem_props = nullptr;
+        vmaGetMemoryProperties(allocator, &mem_props);
+        memory_heap_count = mem_props->memoryHeapCount;
+        for (std::uint32_t i = 0; i < memory_heap_count; ++i) {
+            memory_heap_flags[i] = mem_props->memoryHeaps[i].flags;
+        }
     }
 
-    void create_command_pool() {
-        VkCommandPoolCreateInfo ci{};
-        ci.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    void update_memory_stats() {
+        // Budget queries are cached by VMA and refreshed as the frame index advances.
+        vmaSetCurrentFrameIndex(allocator, static_cast<std::uint32_t>(frame_pacer.submitted()));
+        if (++memory_stats_age < k_memory_stats_interval) {
+            return;
+        }
+        memory_stats_age = 0;
+
+        vmaGetHeapBudgets(allocator, memory_budgets.data());
+        vmaCalculateStatistics(allocator, &memory_stats);
+
+        for (std::uint32_t i = 0; i < memory_heap_count; ++i) {
+            const VmaBudget &b = memory_budgets[i];
+            const bool over = b.budget > 0u &&
+                              static_cast<double>(b.usage) >= static_cast<double>(b.budget) * k_memory_budget_warn;
+            if (over && !memory_heap_over[i]) {
+                std::fprintf(stderr, "[Vulkan] Memory heap %u at %.0f of %.0f MiB budget\n", i,
+                             static_cast<double>(b.usage) / 1048576.0, static_cast<double>(b.budget) / 1048576.0);
+            }
+            memory_heap_over[i] = over;
+        }
+    }
+
+    void draw_memory_panel() const {
+        constexpr double k_mib = 1024.0 * 1024.0;
+        ImGui::Text("Budget: %s", memory_budget_ext ? "VK_EXT_memory_budget" : "estimated (80%% of heap size)");
+        for (std::uint32_t i = 0; i < memory_heap_count; ++i) {
+            const VmaBudget &b = memory_budgets[i];
+            const VmaDetailedStatistics &s = memory_stats.memoryHeap[i];
+            const bool device_local = (memory_heap_flags[i] & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0u;
+
+            char overlay[64];
+            std::snprintf(overlay, sizeof(overlay), "%.0f / %.0f MiB", static_cast<double>(b.usage) / k_mib,
+                          static_cast<double>(b.budget) / k_mib);
+            const float frac = b.budget > 0u ? static_cast<float>(static_cast<double>(b.usage) /
+                                                                  static_cast<double>(b.budget))
+                                             : 0.0f;
+            ImGui::Text("Heap %u%s", i, device_local ? " (device local)" : "");
+            ImGui::ProgressBar(std::min(frac, 1.0f), ImVec2(-FLT_MIN, 0.0f), overlay);
+            ImGui::Text("  ours: %u allocs %.1f MiB in %u blocks %.1f MiB", s.statistics.allocationCount,
+                        static_cast<double>(s.statistics.allocationBytes) / k_mib, s.statistics.blockCount,
+                        static_cast<double>(s.statistics.blockBytes) / k_mib);
+            if (memory_heap_over[i]) {
+                ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "  Near budget: the driver may start paging");
+            }
+        }
+    }
+
+    void create_pipeline_cache() {
+        VkPhysicalDeviceProperties props{};
+        vkGetPhysicalDeviceProperties(phys, &props);
+
+        std::vector<std::uint8_t> blob = read_binary_file(pipeline_cache_path());
+        if (!blob.empty() && !pipeline_cache_matches_device(blob, props)) {
+            std::fprintf(stderr, "[Vulkan] Ignoring pipeline cache from a different device/driver\n");
+            blob.clear();
+        }
+
+        VkPipelineCacheCreateInfo ci{};
+        ci.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
         ci.pNext = nullptr;
-        ci.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-        ci.queueFamilyIndex = graphics_queue_family;
-        vk_check(vkCreateCommandPool(device, &ci, nullptr, &cmd_pool), "vkCreateCommandPool");
+        ci.flags = 0;
+        ci.initialDataSize = blob.size();
+        ci.pInitialData = blob.empty() ? nullptr : blob.data();
+
+        if (vkCreatePipelineCache(device, &ci, nullptr, &pipeline_cache) != VK_SUCCESS && !blob.empty()) {
+            // A blob that passed the header check can still be rejected; start cold instead.
+            ci.initialDataSize = 0;
+            ci.pInitialData = nullptr;
+            vk_check(vkCreatePipelineCache(device, &ci, nullptr, &pipeline_cache),
+                     "vkCreatePipelineCache");
+            blob.clear();
+        }
+        pipeline_cache_warm = !blob.empty();
+    }
+
+    void save_pipeline_cache() noexcept {
+        if (!pipeline_cache) {
+            return;
+        }
+
+        try {
+            std::size_t size = 0;
+            if (vkGetPipelineCacheData(device, pipeline_cache, &size, nullptr) != VK_SUCCESS || size == 0) {
+                return;
+            }
+
+            std::vector<std::uint8_t> blob(size);
+            if (vkGetPipelineCacheData(device, pipeline_cache, &size, blob.data()) != VK_SUCCESS) {
+                return;
+            }
+
+            if (!write_binary_file(pipeline_cache_path(), blob.data(), size)) {
+                std::fprintf(stderr, "[Vulkan] Failed to write pipeline cache: %s\n",
+                             pipeline_cache_path().string().c_str());
+            }
+        } catch (...) {
+            std::fprintf(stderr, "[Vulkan] Failed to serialize pipeline cache\n");
+        }
+    }
+
+    void destroy_pipeline_cache() {
+        if (pipeline_cache) {
+            vkDestroyPipelineCache(device, pipeline_cache, nullptr);
+            pipeline_cache = VK_NULL_HANDLE;
+        }
+    }
+
+    // Destroys `destroy` once every submission that may reference the object has completed;
+    // this includes the frame currently being recorded.
+    void retire(std::function<void()> destroy) {
+        deletion_queue.push(frame_pacer.submitted() + 1u, std::move(destroy));
     }
 
     struct SwapchainSupport {
@@ -686,8 +1801,30 @@ struct VulkanMvp::Impl final {
     }
 
     [[nodiscard]] VkPresentModeKHR choose_present_mode(const std::vector<VkPresentModeKHR> &modes) const {
-        for (VkPresentModeKHR m : modes) {
-            if (m == VK_PRESENT_MODE_MAILBOX_KHR) {
+        static constexpr std::array<VkPresentModeKHR, 2> k_low_latency = {
+            VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR};
+        static constexpr std::array<VkPresentModeKHR, 1> k_adaptive_vsync = {
+            VK_PRESENT_MODE_FIFO_RELAXED_KHR};
+        static constexpr std::array<VkPresentModeKHR, 3> k_uncapped = {
+            VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR};
+
+        std::span<const VkPresentModeKHR> preferred{};
+        switch (present_policy) {
+        case PresentPolicy::low_latency:
+            preferred = k_low_latency;
+            break;
+        case PresentPolicy::vsync:
+            break;
+        case PresentPolicy::adaptive_vsync:
+            preferred = k_adaptive_vsync;
+            break;
+        case PresentPolicy::uncapped:
+            preferred = k_uncapped;
+            break;
+        }
+
+        for (VkPresentModeKHR m : preferred) {
+            if (std::find(modes.begin(), modes.end(), m) != modes.end()) {
                 return m;
             }
         }
@@ -741,7 +1878,51 @@ struct VulkanMvp::Impl final {
         swapchain_extent = VkExtent2D{};
     }
 
-    void create_swapchain() {
+    void create_swapchain_render_pass() {
+        VkAttachmentDescription color{};
+        color.flags = 0;
+        color.format = swapchain_format;
+        color.samples = VK_SAMPLE_COUNT_1_BIT;
+        color.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        color.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        color.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        color.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        // Acquire -> attachment -> PRESENT_SRC transitions come from the render graph.
+        color.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        color.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkAttachmentReference color_ref{};
+        color_ref.attachment = 0;
+        color_ref.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription sub{};
+        sub.flags = 0;
+        sub.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        sub.inputAttachmentCount = 0;
+        sub.pInputAttachments = nullptr;
+        sub.colorAttachmentCount = 1;
+        sub.pColorAttachments = &color_ref;
+        sub.pResolveAttachments = nullptr;
+        sub.pDepthStencilAttachment = nullptr;
+        sub.preserveAttachmentCount = 0;
+        sub.pPreserveAttachments = nullptr;
+
+        VkRenderPassCreateInfo rp{};
+        rp.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        rp.pNext = nullptr;
+        rp.flags = 0;
+        rp.attachmentCount = 1;
+        rp.pAttachments = &color;
+        rp.subpassCount = 1;
+        rp.pSubpasses = &sub;
+        rp.dependencyCount = 0;
+        rp.pDependencies = nullptr;
+
+        vk_check(vkCreateRenderPass(device, &rp, nullptr, &swapchain_render_pass),
+                 "vkCreateRenderPass(swapchain)");
+    }
+
+    void create_swapchain(VkSwapchainKHR old_swapchain = VK_NULL_HANDLE) {
         const SwapchainSupport s = query_swapchain_support();
 
         const VkSurfaceFormatKHR sf = choose_surface_format(s.formats);
@@ -770,8 +1951,9 @@ struct VulkanMvp::Impl final {
         ci.preTransform = s.caps.currentTransform;
         ci.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
         ci.presentMode = pm;
+        present_mode = pm;
         ci.clipped = VK_TRUE;
-        ci.oldSwapchain = VK_NULL_HANDLE;
+        ci.oldSwapchain = old_swapchain;
 
         vk_check(vkCreateSwapchainKHR(device, &ci, nullptr, &swapchain), "vkCreateSwapchainKHR");
 
@@ -806,56 +1988,11 @@ struct VulkanMvp::Impl final {
                      "vkCreateImageView(swapchain)");
         }
 
-        // Render pass (swapchain)
-        VkAttachmentDescription color{};
-        color.flags = 0;
-        color.format = swapchain_format;
-        color.samples = VK_SAMPLE_COUNT_1_BIT;
-        color.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        color.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-        color.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        color.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        color.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        color.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-        VkAttachmentReference color_ref{};
-        color_ref.attachment = 0;
-        color_ref.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-        VkSubpassDescription sub{};
-        sub.flags = 0;
-        sub.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        sub.inputAttachmentCount = 0;
-        sub.pInputAttachments = nullptr;
-        sub.colorAttachmentCount = 1;
-        sub.pColorAttachments = &color_ref;
-        sub.pResolveAttachments = nullptr;
-        sub.pDepthStencilAttachment = nullptr;
-        sub.preserveAttachmentCount = 0;
-        sub.pPreserveAttachments = nullptr;
-
-        VkSubpassDependency dep{};
-        dep.srcSubpass = VK_SUBPASS_EXTERNAL;
-        dep.dstSubpass = 0;
-        dep.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dep.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dep.srcAccessMask = 0;
-        dep.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        dep.dependencyFlags = 0;
-
-        VkRenderPassCreateInfo rp{};
-        rp.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        rp.pNext = nullptr;
-        rp.flags = 0;
-        rp.attachmentCount = 1;
-        rp.pAttachments = &color;
-        rp.subpassCount = 1;
-        rp.pSubpasses = &sub;
-        rp.dependencyCount = 1;
-        rp.pDependencies = &dep;
-
-        vk_check(vkCreateRenderPass(device, &rp, nullptr, &swapchain_render_pass),
-                 "vkCreateRenderPass(swapchain)");
+        // The render pass only depends on the surface format, which does not change across
+        // resizes, so it outlives individual swapchains.
+        if (!swapchain_render_pass) {
+            create_swapchain_render_pass();
+        }
 
         // Framebuffers
         swapchain_framebuffers.resize(swapchain_views.size());
@@ -879,6 +2016,7 @@ struct VulkanMvp::Impl final {
     }
 
     void recreate_swapchain() {
+        PBA_PROFILE_ZONE("recreate_swapchain");
         int fb_w = 0;
         int fb_h = 0;
         glfwGetFramebufferSize(window, &fb_w, &fb_h);
@@ -887,52 +2025,240 @@ struct VulkanMvp::Impl final {
             glfwGetFramebufferSize(window, &fb_w, &fb_h);
         }
 
-        vkDeviceWaitIdle(device);
+        // The old swapchain is handed to the driver as oldSwapchain and, together with its
+        // views and framebuffers, destroyed once the frames that used it have retired.
+        const VkSwapchainKHR old_swapchain = swapchain;
+        std::vector<VkImageView> old_views = std::move(swapchain_views);
+        std::vector<VkFramebuffer> old_framebuffers = std::move(swapchain_framebuffers);
+        swapchain_views.clear();
+        swapchain_framebuffers.clear();
+        swapchain_images.clear();
+        swapchain = VK_NULL_HANDLE;
+
+        create_swapchain(old_swapchain);
 
-        destroy_swapchain_resources();
-        create_swapchain();
+        retire([this, old_swapchain, old_views, old_framebuffers]() {
+            for (VkFramebuffer fb : old_framebuffers) {
+                vkDestroyFramebuffer(device, fb, nullptr);
+            }
+            for (VkImageView iv : old_views) {
+                vkDestroyImageView(device, iv, nullptr);
+            }
+            if (old_swapchain) {
+                vkDestroySwapchainKHR(device, old_swapchain, nullptr);
+            }
+        });
 
         ImGui_ImplVulkan_SetMinImageCount(static_cast<std::uint32_t>(swapchain_images.size()));
 
         framebuffer_resized = false;
+        last_present_id = 0; // ids are per swapchain
     }
 
-    void create_sync_and_cmd_buffers() {
-        // Allocate command buffers (one per frame-in-flight)
-        std::vector<VkCommandBuffer> cmds(static_cast<std::size_t>(k_frames_in_flight), VK_NULL_HANDLE);
+    [[nodiscard]] VkCommandPool create_transient_command_pool() {
+        VkCommandPoolCreateInfo ci{};
+        ci.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        ci.pNext = nullptr;
+        ci.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        ci.queueFamilyIndex = graphics_queue_family;
+
+        VkCommandPool pool{VK_NULL_HANDLE};
+        vk_check(vkCreateCommandPool(device, &ci, nullptr, &pool), "vkCreateCommandPool");
+        return pool;
+    }
 
+    [[nodiscard]] VkCommandBuffer allocate_command_buffer(VkCommandPool pool, VkCommandBufferLevel level) {
         VkCommandBufferAllocateInfo ai{};
         ai.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
         ai.pNext = nullptr;
-        ai.commandPool = cmd_pool;
-        ai.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        ai.commandBufferCount = k_frames_in_flight;
+        ai.commandPool = pool;
+        ai.level = level;
+        ai.commandBufferCount = 1;
+
+        VkCommandBuffer cb{VK_NULL_HANDLE};
+        vk_check(vkAllocateCommandBuffers(device, &ai, &cb), "vkAllocateCommandBuffers");
+        return cb;
+    }
 
-        vk_check(vkAllocateCommandBuffers(device, &ai, cmds.data()),
-                 "vkAllocateCommandBuffers");
+    // Grows the slot's recorders to `count`; existing ones are kept, so this is safe mid-frame
+    // as long as no task is recording.
+    void ensure_recorders(Frame &f, std::uint32_t count) {
+        while (f.recorders.size() < count) {
+            Recorder r{};
+            r.pool = create_transient_command_pool();
+            r.cmd = allocate_command_buffer(r.pool, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+            f.recorders.push_back(r);
+        }
+    }
 
-        for (std::uint32_t i = 0; i < k_frames_in_flight; ++i) {
-            frames[i].cmd = cmds[i];
+    void create_sync_and_cmd_buffers() {
+        // Per slot: a primary command buffer. Secondaries for multi-viewport frames are added
+        // on demand.
+        for (std::uint32_t i = 0; i < frames_in_flight; ++i) {
+            Frame &f = frames[i];
+            f.cmd_pool = create_transient_command_pool();
+            f.cmd = allocate_command_buffer(f.cmd_pool, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
         }
 
-        // Semaphores + fences
+        jobs = std::make_unique<JobSystem>(std::max(record_threads, std::thread::hardware_concurrency()));
+
+        // Acquire and present still need binary semaphores; CPU-side waits all go through the
+        // frame timeline.
         VkSemaphoreCreateInfo sci{};
         sci.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
         sci.pNext = nullptr;
         sci.flags = 0;
 
-        VkFenceCreateInfo fci{};
-        fci.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fci.pNext = nullptr;
-        fci.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-        for (std::uint32_t i = 0; i < k_frames_in_flight; ++i) {
+        for (std::uint32_t i = 0; i < frames_in_flight; ++i) {
             vk_check(vkCreateSemaphore(device, &sci, nullptr, &frames[i].image_acquired),
                      "vkCreateSemaphore(image_acquired)");
             vk_check(vkCreateSemaphore(device, &sci, nullptr, &frames[i].render_complete),
                      "vkCreateSemaphore(render_complete)");
-            vk_check(vkCreateFence(device, &fci, nullptr, &frames[i].in_flight),
-                     "vkCreateFence(in_flight)");
+        }
+        frame_pacer.init(device);
+    }
+
+    void create_timestamp_pool() {
+        VkPhysicalDeviceProperties props{};
+        vkGetPhysicalDeviceProperties(phys, &props);
+
+        std::uint32_t qf_count = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(phys, &qf_count, nullptr);
+        std::vector<VkQueueFamilyProperties> qfs(qf_count);
+        vkGetPhysicalDeviceQueueFamilyProperties(phys, &qf_count, qfs.data());
+
+        const std::uint32_t valid_bits = qfs.at(graphics_queue_family).timestampValidBits;
+        if (valid_bits == 0u || props.limits.timestampPeriod <= 0.0f) {
+            std::fprintf(stderr, "[Vulkan] Timestamps unsupported on graphics queue; GPU timing disabled\n");
+            return;
+        }
+
+        timestamp_period_ns = static_cast<double>(props.limits.timestampPeriod);
+        timestamp_mask = (valid_bits >= 64u) ? ~0ull : ((1ull << valid_bits) - 1ull);
+
+        VkQueryPoolCreateInfo ci{};
+        ci.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        ci.pNext = nullptr;
+        ci.flags = 0;
+        ci.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        ci.queryCount = k_timestamps_per_frame * k_max_frames_in_flight;
+        ci.pipelineStatistics = 0;
+
+        vk_check(vkCreateQueryPool(device, &ci, nullptr, &timestamp_pool), "vkCreateQueryPool(timestamps)");
+    }
+
+    void destroy_timestamp_pool() {
+        if (timestamp_pool) {
+            vkDestroyQueryPool(device, timestamp_pool, nullptr);
+            timestamp_pool = VK_NULL_HANDLE;
+        }
+    }
+
+    void write_timestamp(VkCommandBuffer cb, VkPipelineStageFlagBits stage, std::uint32_t query) {
+        if (timestamp_pool) {
+            vkCmdWriteTimestamp(cb, stage, timestamp_pool, frame_index * k_timestamps_per_frame + query);
+        }
+    }
+
+    // Called after the slot's timeline wait; never blocks (no WAIT_BIT) and simply drops the sample
+    // if the driver has not made the results available yet.
+    void read_timestamps(Frame &fr, std::uint32_t slot) {
+        if (!timestamp_pool || !fr.timestamps_pending) {
+            return;
+        }
+        fr.timestamps_pending = false;
+
+        std::array<std::uint64_t, k_timestamps_per_frame> ticks{};
+        const VkResult r = vkGetQueryPoolResults(
+            device, timestamp_pool, slot * k_timestamps_per_frame, k_timestamps_per_frame,
+            sizeof(ticks), ticks.data(), sizeof(std::uint64_t), VK_QUERY_RESULT_64_BIT);
+        if (r != VK_SUCCESS) {
+            return;
+        }
+
+        const auto to_ms = [this, &ticks](std::uint32_t begin, std::uint32_t end) {
+            const std::uint64_t delta = ((ticks[end] & timestamp_mask) - (ticks[begin] & timestamp_mask)) & timestamp_mask;
+            return static_cast<float>(static_cast<double>(delta) * timestamp_period_ns * 1e-6);
+        };
+
+        // A reused frame's offscreen span is empty and says nothing about the pass's cost.
+        if (fr.offscreen_rendered) {
+            gpu_offscreen_ms.push(to_ms(k_ts_offscreen_begin, k_ts_offscreen_end));
+            dynamic_resolution.update(gpu_offscreen_ms.latest());
+        }
+        gpu_swapchain_ms.push(to_ms(k_ts_swapchain_begin, k_ts_swapchain_end));
+        gpu_frame_ms.push(to_ms(k_ts_offscreen_begin, k_ts_swapchain_end));
+        if (gpu_frame_log) {
+            gpu_frame_log->push_back(gpu_frame_ms.latest());
+        }
+        if constexpr (profiler::k_enabled) {
+            record_gpu_zones(fr, ticks);
+        }
+    }
+
+    // Signed distance in ticks from `from` to `to`, modulo the counter's valid bits.
+    [[nodiscard]] std::int64_t tick_delta(std::uint64_t from, std::uint64_t to) const noexcept {
+        const std::uint64_t d = ((to & timestamp_mask) - (from & timestamp_mask)) & timestamp_mask;
+        return (d > (timestamp_mask >> 1u)) ? -static_cast<std::int64_t>(timestamp_mask - d + 1u)
+                                            : static_cast<std::int64_t>(d);
+    }
+
+    [[nodiscard]] std::uint64_t gpu_tick_to_ns(std::uint64_t tick) const noexcept {
+        const double ns = static_cast<double>(tick_delta(gpu_anchor_tick, tick)) * timestamp_period_ns;
+        return static_cast<std::uint64_t>(static_cast<std::int64_t>(gpu_anchor_ns) + std::llround(ns));
+    }
+
+    // Re-samples both clocks at most every k_calibration_interval_ns; they drift apart by a few
+    // ppm. A no-op without VK_EXT_calibrated_timestamps.
+    void calibrate_gpu_clock() {
+        const std::uint64_t now = profiler::now_ns();
+        const std::optional<VkTimeDomainEXT> host = host_time_domain();
+        if (!get_calibrated_timestamps || !host.has_value() ||
+            (gpu_anchor_valid && now - last_calibration_ns < k_calibration_interval_ns)) {
+            return;
+        }
+        last_calibration_ns = now;
+
+        std::array<VkCalibratedTimestampInfoEXT, 2> infos{};
+        infos[0].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+        infos[0].pNext = nullptr;
+        infos[0].timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+        infos[1].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+        infos[1].pNext = nullptr;
+        infos[1].timeDomain = *host;
+        std::array<std::uint64_t, 2> values{};
+        std::uint64_t max_deviation = 0;
+        if (get_calibrated_timestamps(device, 2, infos.data(), values.data(), &max_deviation) == VK_SUCCESS) {
+            gpu_anchor_tick = values[0];
+            gpu_anchor_ns = values[1];
+            gpu_anchor_valid = true;
+        }
+    }
+
+    // Puts the slot's GPU spans on the profiler's GPU track, next to the CPU zones of the frame
+    // that recorded them.
+    void record_gpu_zones(const Frame &fr, const std::array<std::uint64_t, k_timestamps_per_frame> &ticks) {
+        calibrate_gpu_clock();
+        // Uncalibrated, the track lags the truth by at most the shortest submit-to-start gap.
+        if (!get_calibrated_timestamps &&
+            (!gpu_anchor_valid || gpu_tick_to_ns(ticks[k_ts_offscreen_begin]) < fr.submit_ns)) {
+            gpu_anchor_tick = ticks[k_ts_offscreen_begin];
+            gpu_anchor_ns = fr.submit_ns;
+            gpu_anchor_valid = true;
+        }
+        if (!gpu_anchor_valid) {
+            return;
+        }
+
+        const auto zone = [this, &ticks](const char *name, std::uint32_t begin, std::uint32_t end) {
+            profiler::record_gpu(name, gpu_tick_to_ns(ticks[begin]), gpu_tick_to_ns(ticks[end]));
+        };
+        zone("gpu frame", k_ts_offscreen_begin, k_ts_swapchain_end);
+        if (fr.offscreen_rendered) {
+            zone("gpu offscreen", k_ts_offscreen_begin, k_ts_offscreen_end);
+        }
+        if (!headless) {
+            zone("gpu imgui", k_ts_swapchain_begin, k_ts_swapchain_end);
         }
     }
 
@@ -984,6 +2310,8 @@ struct VulkanMvp::Impl final {
         init_info.QueueFamily = graphics_queue_family;
         init_info.Queue = graphics_queue;
         init_info.DescriptorPool = imgui_desc_pool;
+        // Created earlier in init_all(), so the ImGui pipeline is cached across runs as well.
+        init_info.PipelineCache = pipeline_cache;
         init_info.Allocator = nullptr;
         init_info.CheckVkResultFn = imgui_check_vk_result;
         init_info.MinImageCount = static_cast<std::uint32_t>(swapchain_images.size());
@@ -1010,9 +2338,11 @@ struct VulkanMvp::Impl final {
     }
 
     void destroy_imgui() {
-        ImGui_ImplVulkan_Shutdown();
-        ImGui_ImplGlfw_Shutdown();
-        ImGui::DestroyContext();
+        if (ImGui::GetCurrentContext()) {
+            ImGui_ImplVulkan_Shutdown();
+            ImGui_ImplGlfw_Shutdown();
+            ImGui::DestroyContext();
+        }
 
         if (imgui_desc_pool) {
             vkDestroyDescriptorPool(device, imgui_desc_pool, nullptr);
@@ -1020,39 +2350,114 @@ struct VulkanMvp::Impl final {
         }
     }
 
+    // Highest count the device supports that does not exceed `requested`.
+    [[nodiscard]] static VkSampleCountFlagBits pick_sample_count(std::uint32_t requested,
+                                                                 VkSampleCountFlags supported) noexcept {
+        for (std::uint32_t s = std::bit_floor(std::clamp(requested, 1u, 64u)); s > 1u; s >>= 1u) {
+            if ((supported & s) != 0u) {
+                return static_cast<VkSampleCountFlagBits>(s);
+            }
+        }
+        return VK_SAMPLE_COUNT_1_BIT;
+    }
+
     void create_offscreen_render_pass_and_sampler() {
         offscreen_depth_format = pick_depth_stencil_format(phys);
 
+        const VkPhysicalDeviceMemoryProperties *mem_props = nullptr;
+        vmaGetMemoryProperties(allocator, &mem_props);
+        lazy_attachments = false;
+        for (std::uint32_t i = 0; i < mem_props->memoryTypeCount; ++i) {
+            if ((mem_props->memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0u) {
+                lazy_attachments = true;
+            }
+        }
+
+        VkPhysicalDeviceProperties props{};
+        vkGetPhysicalDeviceProperties(phys, &props);
+        supported_offscreen_samples =
+            props.limits.framebufferColorSampleCounts & props.limits.framebufferDepthSampleCounts;
+        offscreen_samples = pick_sample_count(requested_msaa_samples, supported_offscreen_samples);
+
+        create_offscreen_render_pass();
+
+        VkSamplerCreateInfo si{};
+        si.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        si.pNext = nullptr;
+        si.flags = 0;
+        si.magFilter = VK_FILTER_LINEAR;
+        si.minFilter = VK_FILTER_LINEAR;
+        si.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        si.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        si.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        si.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        si.mipLodBias = 0.0f;
+        si.anisotropyEnable = VK_FALSE;
+        si.maxAnisotropy = 1.0f;
+        si.compareEnable = VK_FALSE;
+        si.compareOp = VK_COMPARE_OP_ALWAYS;
+        si.minLod = 0.0f;
+        si.maxLod = 1.0f;
+        si.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+        si.unnormalizedCoordinates = VK_FALSE;
+
+        vk_check(vkCreateSampler(device, &si, nullptr, &offscreen_sampler),
+                 "vkCreateSampler(offscreen)");
+    }
+
+    // Attachments: 0 = color (the multisampled transient with MSAA, else color_image), 1 = depth,
+    // 2 = color_image as the resolve target (MSAA only).
+    void create_offscreen_render_pass() {
+        const bool msaa = offscreen_samples != VK_SAMPLE_COUNT_1_BIT;
+
         VkAttachmentDescription color{};
         color.flags = 0;
         color.format = offscreen_color_format;
-        color.samples = VK_SAMPLE_COUNT_1_BIT;
+        color.samples = offscreen_samples;
         color.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        color.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        // The samples only need to survive until the end-of-subpass resolve.
+        color.storeOp = msaa ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
         color.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         color.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        color.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        color.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        // The render graph transitions every attachment around the pass and orders it against
+        // its neighbours, so the pass itself neither changes layouts nor declares dependencies.
+        color.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        color.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
         VkAttachmentDescription depth{};
         depth.flags = 0;
         depth.format = offscreen_depth_format;
-        depth.samples = VK_SAMPLE_COUNT_1_BIT;
+        depth.samples = offscreen_samples;
         depth.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
         depth.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
         depth.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
         depth.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        depth.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        depth.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
         depth.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
         VkAttachmentReference color_ref{};
         color_ref.attachment = 0;
         color_ref.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
+        VkAttachmentDescription resolve{};
+        resolve.flags = 0;
+        resolve.format = offscreen_color_format;
+        resolve.samples = VK_SAMPLE_COUNT_1_BIT;
+        resolve.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        resolve.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        resolve.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        resolve.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        resolve.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        resolve.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
         VkAttachmentReference depth_ref{};
         depth_ref.attachment = 1;
         depth_ref.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
+        VkAttachmentReference resolve_ref{};
+        resolve_ref.attachment = 2;
+        resolve_ref.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
         VkSubpassDescription sub{};
         sub.flags = 0;
         sub.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
@@ -1060,104 +2465,236 @@ struct VulkanMvp::Impl final {
         sub.pInputAttachments = nullptr;
         sub.colorAttachmentCount = 1;
         sub.pColorAttachments = &color_ref;
-        sub.pResolveAttachments = nullptr;
+        sub.pResolveAttachments = msaa ? &resolve_ref : nullptr;
         sub.pDepthStencilAttachment = &depth_ref;
         sub.preserveAttachmentCount = 0;
         sub.pPreserveAttachments = nullptr;
 
-        VkSubpassDependency deps[2]{};
-
-        deps[0].srcSubpass = VK_SUBPASS_EXTERNAL;
-        deps[0].dstSubpass = 0;
-        deps[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-        deps[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        deps[0].srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        deps[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        deps[0].dependencyFlags = 0;
-
-        deps[1].srcSubpass = 0;
-        deps[1].dstSubpass = VK_SUBPASS_EXTERNAL;
-        deps[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        deps[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-        deps[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        deps[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        deps[1].dependencyFlags = 0;
-
-        VkAttachmentDescription atts[2] = {color, depth};
+        VkAttachmentDescription atts[3] = {color, depth, resolve};
 
         VkRenderPassCreateInfo rp{};
         rp.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
         rp.pNext = nullptr;
         rp.flags = 0;
-        rp.attachmentCount = 2;
+        rp.attachmentCount = msaa ? 3u : 2u;
         rp.pAttachments = atts;
         rp.subpassCount = 1;
         rp.pSubpasses = &sub;
-        rp.dependencyCount = 2;
-        rp.pDependencies = deps;
+        rp.dependencyCount = 0;
+        rp.pDependencies = nullptr;
 
         vk_check(vkCreateRenderPass(device, &rp, nullptr, &offscreen_render_pass),
                  "vkCreateRenderPass(offscreen)");
+    }
 
-        VkSamplerCreateInfo si{};
-        si.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-        si.pNext = nullptr;
-        si.flags = 0;
-        si.magFilter = VK_FILTER_LINEAR;
-        si.minFilter = VK_FILTER_LINEAR;
-        si.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-        si.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-        si.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-        si.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-        si.mipLodBias = 0.0f;
-        si.anisotropyEnable = VK_FALSE;
-        si.maxAnisotropy = 1.0f;
-        si.compareEnable = VK_FALSE;
-        si.compareOp = VK_COMPARE_OP_ALWAYS;
-        si.minLod = 0.0f;
-        si.maxLod = 1.0f;
-        si.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-        si.unnormalizedCoordinates = VK_FALSE;
+    // Runs between frames (from the UI); frames still in flight keep the retired objects alive.
+    void set_offscreen_samples(VkSampleCountFlagBits samples) {
+        if (samples == offscreen_samples) {
+            return;
+        }
 
-        vk_check(vkCreateSampler(device, &si, nullptr, &offscreen_sampler),
-                 "vkCreateSampler(offscreen)");
+        const VkRenderPass old_pass = offscreen_render_pass;
+        retire([this, old_pass]() { vkDestroyRenderPass(device, old_pass, nullptr); });
+        for (Viewport &vp : viewports) {
+            for (OffscreenFrame &f : vp.frames) {
+                if (f.framebuffer) {
+                    const VkFramebuffer old = f.framebuffer;
+                    retire([this, old]() { vkDestroyFramebuffer(device, old, nullptr); });
+                    f.framebuffer = VK_NULL_HANDLE;
+                }
+            }
+        }
+        retire_pipeline(cube_pipeline);
+        if (mesh_shader_ext) {
+            retire_pipeline(meshlet_pipeline);
+        }
+
+        offscreen_samples = samples;
+        ++scene_revision;
+        create_offscreen_render_pass();
+        create_cube_pipeline();
+        if (mesh_shader_ext) {
+            create_meshlet_pipeline();
+        }
     }
 
-    void destroy_offscreen() {
-        for (OffscreenFrame &f : offscreen) {
-            if (f.imgui_texture_set) {
-                ImGui_ImplVulkan_RemoveTexture(f.imgui_texture_set);
-                f.imgui_texture_set = VK_NULL_HANDLE;
-            }
+    [[nodiscard]] static VkImageCreateInfo render_target_info(VkFormat format, VkImageUsageFlags usage,
+                                                              std::uint32_t w, std::uint32_t h) {
+        VkImageCreateInfo ici{};
+        ici.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        ici.pNext = nullptr;
+        ici.flags = 0;
+        ici.imageType = VK_IMAGE_TYPE_2D;
+        ici.format = format;
+        ici.extent = VkExtent3D{w, h, 1u};
+        ici.mipLevels = 1;
+        ici.arrayLayers = 1;
+        ici.samples = VK_SAMPLE_COUNT_1_BIT;
+        ici.tiling = VK_IMAGE_TILING_OPTIMAL;
+        ici.usage = usage;
+        ici.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        ici.queueFamilyIndexCount = 0;
+        ici.pQueueFamilyIndices = nullptr;
+        ici.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        return ici;
+    }
 
-            if (f.framebuffer) {
-                vkDestroyFramebuffer(device, f.framebuffer, nullptr);
-                f.framebuffer = VK_NULL_HANDLE;
-            }
+    [[nodiscard]] static std::uint32_t render_target_bucket(std::uint32_t extent) noexcept {
+        return (extent + k_render_target_bucket - 1u) / k_render_target_bucket * k_render_target_bucket;
+    }
 
-            if (f.depth_view) {
-                vkDestroyImageView(device, f.depth_view, nullptr);
-                f.depth_view = VK_NULL_HANDLE;
-            }
-            if (f.depth_image && f.depth_alloc) {
-                vmaDestroyImage(allocator, f.depth_image, f.depth_alloc);
-                f.depth_image = VK_NULL_HANDLE;
-                f.depth_alloc = VK_NULL_HANDLE;
+    [[nodiscard]] RenderTargetPool &render_target_pool(VkFormat format, VkImageUsageFlags usage, std::uint32_t w,
+                                                       std::uint32_t h) {
+        const std::uint32_t bw = render_target_bucket(w);
+        const std::uint32_t bh = render_target_bucket(h);
+        for (RenderTargetPool &p : render_target_pools) {
+            if (p.format == format && p.usage == usage && p.bucket_width == bw && p.bucket_height == bh) {
+                return p;
             }
+        }
+
+        const VkImageCreateInfo ici = render_target_info(format, usage, bw, bh);
+
+        VmaAllocationCreateInfo aci{};
+        aci.flags = 0;
+        aci.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+        aci.requiredFlags = 0;
+        aci.preferredFlags = 0;
+        aci.memoryTypeBits = 0;
+        aci.pool = VK_NULL_HANDLE;
+        aci.pUserData = nullptr;
+        aci.priority = 0.0f;
+
+        std::uint32_t memory_type = 0;
+        vk_check(vmaFindMemoryTypeIndexForImageInfo(allocator, &ici, &aci, &memory_type),
+                 "vmaFindMemoryTypeIndexForImageInfo(render target)");
+
+        // Every image in the bucket fits in one block the size of the bucket's largest image.
+        VkImage probe = VK_NULL_HANDLE;
+        vk_check(vkCreateImage(device, &ici, nullptr, &probe), "vkCreateImage(render target probe)");
+        VkMemoryRequirements req{};
+        vkGetImageMemoryRequirements(device, probe, &req);
+        vkDestroyImage(device, probe, nullptr);
+
+        // One block per slot up front, plus the one a lazy resize briefly needs while the old
+        // image waits in the deletion queue; VMA keeps a single empty block around for that.
+        VmaPoolCreateInfo pci{};
+        pci.memoryTypeIndex = memory_type;
+        pci.flags = 0;
+        pci.blockSize = req.size;
+        pci.minBlockCount = frames_in_flight;
+        pci.maxBlockCount = 0;
+        pci.priority = 0.0f;
+        pci.minAllocationAlignment = 0;
+        pci.pMemoryAllocateNext = nullptr;
+
+        RenderTargetPool p{};
+        p.format = format;
+        p.usage = usage;
+        p.bucket_width = bw;
+        p.bucket_height = bh;
+        vk_check(vmaCreatePool(allocator, &pci, &p.pool), "vmaCreatePool(render target)");
+        render_target_pools.push_back(p);
+        return render_target_pools.back();
+    }
+
+    void create_render_target(VkFormat format, VkImageUsageFlags usage, std::uint32_t w, std::uint32_t h,
+                              VkImage &image, VmaAllocation &alloc, VmaPool &pool, const char *what) {
+        RenderTargetPool &p = render_target_pool(format, usage, w, h);
+        const VkImageCreateInfo ici = render_target_info(format, usage, w, h);
+
+        VmaAllocationCreateInfo aci{};
+        aci.flags = 0;
+        aci.usage = VMA_MEMORY_USAGE_UNKNOWN; // implied by the pool's memory type
+        aci.requiredFlags = 0;
+        aci.preferredFlags = 0;
+        aci.memoryTypeBits = 0;
+        aci.pool = p.pool;
+        aci.pUserData = nullptr;
+        aci.priority = 0.0f;
+
+        vk_check(vmaCreateImage(allocator, &ici, &aci, &image, &alloc, nullptr), what);
+        pool = p.pool;
+        ++p.live;
+    }
 
-            if (f.color_view) {
-                vkDestroyImageView(device, f.color_view, nullptr);
-                f.color_view = VK_NULL_HANDLE;
+    void destroy_render_target(VkImage &image, VmaAllocation &alloc, VmaPool &pool) {
+        if (image && alloc) {
+            vmaDestroyImage(allocator, image, alloc);
+        }
+        image = VK_NULL_HANDLE;
+        alloc = VK_NULL_HANDLE;
+
+        const auto it = std::find_if(render_target_pools.begin(), render_target_pools.end(),
+                                     [pool](const RenderTargetPool &p) { return p.pool == pool; });
+        pool = VK_NULL_HANDLE;
+        if (it != render_target_pools.end() && --it->live == 0u) {
+            it->idle_since = frame_pacer.submitted();
+        }
+    }
+
+    // Destroys empty pools past their idle budget, or every empty pool with `all`. Runs between
+    // frames, when no reference from render_target_pool() is held.
+    void evict_render_target_pools(bool all) {
+        std::vector<std::size_t> idle{};
+        for (std::size_t i = 0; i < render_target_pools.size(); ++i) {
+            if (render_target_pools[i].live == 0u) {
+                idle.push_back(i);
             }
-            if (f.color_image && f.color_alloc) {
-                vmaDestroyImage(allocator, f.color_image, f.color_alloc);
-                f.color_image = VK_NULL_HANDLE;
-                f.color_alloc = VK_NULL_HANDLE;
+        }
+        std::sort(idle.begin(), idle.end(), [this](std::size_t a, std::size_t b) {
+            return render_target_pools[a].idle_since < render_target_pools[b].idle_since;
+        });
+
+        const std::uint64_t now = frame_pacer.submitted();
+        std::vector<bool> evict(render_target_pools.size(), false);
+        for (std::size_t k = 0; k < idle.size(); ++k) {
+            const RenderTargetPool &p = render_target_pools[idle[k]];
+            evict[idle[k]] = all || k + k_max_idle_render_target_pools < idle.size() ||
+                             now - p.idle_since > k_render_target_idle_frames;
+        }
+
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < render_target_pools.size(); ++i) {
+            if (evict[i]) {
+                vmaDestroyPool(allocator, render_target_pools[i].pool);
+            } else {
+                render_target_pools[kept++] = render_target_pools[i];
             }
+        }
+        render_target_pools.resize(kept);
+    }
+
+    void destroy_offscreen_frame_resources(OffscreenFrame &f) {
+        if (f.imgui_texture_set) {
+            ImGui_ImplVulkan_RemoveTexture(f.imgui_texture_set);
+            f.imgui_texture_set = VK_NULL_HANDLE;
+        }
+
+        if (f.framebuffer) {
+            vkDestroyFramebuffer(device, f.framebuffer, nullptr);
+            f.framebuffer = VK_NULL_HANDLE;
+        }
+
+        if (f.color_view) {
+            vkDestroyImageView(device, f.color_view, nullptr);
+            f.color_view = VK_NULL_HANDLE;
+        }
+        destroy_render_target(f.color_image, f.color_alloc, f.color_pool);
+
+        f.width = 1;
+        f.height = 1;
+        f.render_width = 1;
+        f.render_height = 1;
+    }
 
-            f.width = 1;
-            f.height = 1;
+    void destroy_offscreen() {
+        for (Viewport &vp : viewports) {
+            for (OffscreenFrame &f : vp.frames) {
+                destroy_offscreen_frame_resources(f);
+            }
         }
+        evict_render_target_pools(true);
 
         if (offscreen_sampler) {
             vkDestroySampler(device, offscreen_sampler, nullptr);
@@ -1173,37 +2710,15 @@ struct VulkanMvp::Impl final {
     void create_offscreen_frame_resources(OffscreenFrame &f, std::uint32_t w, std::uint32_t h) {
         f.width = std::max(1u, w);
         f.height = std::max(1u, h);
+        f.render_width = f.width;
+        f.render_height = f.height;
 
         // Color image
-        VkImageCreateInfo ici{};
-        ici.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-        ici.pNext = nullptr;
-        ici.flags = 0;
-        ici.imageType = VK_IMAGE_TYPE_2D;
-        ici.format = offscreen_color_format;
-        ici.extent = VkExtent3D{f.width, f.height, 1u};
-        ici.mipLevels = 1;
-        ici.arrayLayers = 1;
-        ici.samples = VK_SAMPLE_COUNT_1_BIT;
-        ici.tiling = VK_IMAGE_TILING_OPTIMAL;
-        ici.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-        ici.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        ici.queueFamilyIndexCount = 0;
-        ici.pQueueFamilyIndices = nullptr;
-        ici.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-
-        VmaAllocationCreateInfo ainfo{};
-        ainfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
-        ainfo.usage = VMA_MEMORY_USAGE_AUTO;
-        ainfo.requiredFlags = 0;
-        ainfo.preferredFlags = 0;
-        ainfo.memoryTypeBits = 0;
-        ainfo.pool = VK_NULL_HANDLE;
-        ainfo.pUserData = nullptr;
-        ainfo.priority = 0.0f;
-
-        vk_check(vmaCreateImage(allocator, &ici, &ainfo, &f.color_image, &f.color_alloc, nullptr),
-                 "vmaCreateImage(color)");
+        create_render_target(offscreen_color_format,
+                             VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+                                 VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                             f.width, f.height, f.color_image, f.color_alloc, f.color_pool,
+                             "vmaCreateImage(color)");
 
         VkImageViewCreateInfo cvi{};
         cvi.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -1222,59 +2737,70 @@ struct VulkanMvp::Impl final {
         vk_check(vkCreateImageView(device, &cvi, nullptr, &f.color_view),
                  "vkCreateImageView(color)");
 
-        // Depth image
-        VkImageCreateInfo dici{};
-        dici.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-        dici.pNext = nullptr;
-        dici.flags = 0;
-        dici.imageType = VK_IMAGE_TYPE_2D;
-        dici.format = offscreen_depth_format;
-        dici.extent = VkExtent3D{f.width, f.height, 1u};
-        dici.mipLevels = 1;
-        dici.arrayLayers = 1;
-        dici.samples = VK_SAMPLE_COUNT_1_BIT;
-        dici.tiling = VK_IMAGE_TILING_OPTIMAL;
-        dici.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
-        dici.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        dici.queueFamilyIndexCount = 0;
-        dici.pQueueFamilyIndices = nullptr;
-        dici.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-
-        vk_check(vmaCreateImage(allocator, &dici, &ainfo, &f.depth_image, &f.depth_alloc, nullptr),
-                 "vmaCreateImage(depth)");
-
-        VkImageAspectFlags depth_aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+        // ImGui texture handle
+        if (!headless) {
+            f.imgui_texture_set = ImGui_ImplVulkan_AddTexture(
+                offscreen_sampler, f.color_view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        }
+    }
+
+    [[nodiscard]] VkImageAspectFlags offscreen_depth_aspect() const noexcept {
+        VkImageAspectFlags aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
         if (offscreen_depth_format == VK_FORMAT_D24_UNORM_S8_UINT ||
             offscreen_depth_format == VK_FORMAT_D32_SFLOAT_S8_UINT) {
-            depth_aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+            aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
         }
+        return aspect;
+    }
+
+    // Depth is sized to the render target bucket so resizes within a bucket keep the graph's
+    // cached image; attachments may be larger than the framebuffer.
+    [[nodiscard]] RgImageDesc offscreen_depth_desc(const OffscreenFrame &f) const noexcept {
+        RgImageDesc d{};
+        d.format = offscreen_depth_format;
+        d.extent = VkExtent2D{render_target_bucket(f.width), render_target_bucket(f.height)};
+        // TRANSIENT is valid everywhere since depth is only ever an attachment.
+        d.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        d.aspect = offscreen_depth_aspect();
+        d.samples = offscreen_samples;
+        d.lazily_allocated = lazy_attachments;
+        return d;
+    }
 
-        VkImageViewCreateInfo dvi{};
-        dvi.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-        dvi.pNext = nullptr;
-        dvi.flags = 0;
-        dvi.image = f.depth_image;
-        dvi.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        dvi.format = offscreen_depth_format;
-        dvi.components = VkComponentMapping{};
-        dvi.subresourceRange.aspectMask = depth_aspect;
-        dvi.subresourceRange.baseMipLevel = 0;
-        dvi.subresourceRange.levelCount = 1;
-        dvi.subresourceRange.baseArrayLayer = 0;
-        dvi.subresourceRange.layerCount = 1;
+    // Same sizing as depth; the samples never leave the pass, only the resolve is stored.
+    [[nodiscard]] RgImageDesc offscreen_msaa_color_desc(const OffscreenFrame &f) const noexcept {
+        RgImageDesc d{};
+        d.format = offscreen_color_format;
+        d.extent = VkExtent2D{render_target_bucket(f.width), render_target_bucket(f.height)};
+        d.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        d.aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+        d.samples = offscreen_samples;
+        d.lazily_allocated = lazy_attachments;
+        return d;
+    }
 
-        vk_check(vkCreateImageView(device, &dvi, nullptr, &f.depth_view),
-                 "vkCreateImageView(depth)");
+    // `msaa_view` is VK_NULL_HANDLE without MSAA; `generation` is the graph's transient generation
+    // the views belong to.
+    void ensure_offscreen_framebuffer(OffscreenFrame &f, VkImageView msaa_view, VkImageView depth_view,
+                                      std::uint64_t generation) {
+        if (f.framebuffer && f.framebuffer_generation == generation && f.framebuffer_msaa_view == msaa_view &&
+            f.framebuffer_depth_view == depth_view) {
+            return;
+        }
+        if (f.framebuffer) {
+            const VkFramebuffer old = f.framebuffer;
+            retire([this, old]() { vkDestroyFramebuffer(device, old, nullptr); });
+        }
 
-        // Framebuffer
-        VkImageView attachments[2] = {f.color_view, f.depth_view};
+        const bool msaa = msaa_view != VK_NULL_HANDLE;
+        VkImageView attachments[3] = {msaa ? msaa_view : f.color_view, depth_view, f.color_view};
 
         VkFramebufferCreateInfo fb{};
         fb.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
         fb.pNext = nullptr;
         fb.flags = 0;
         fb.renderPass = offscreen_render_pass;
-        fb.attachmentCount = 2;
+        fb.attachmentCount = msaa ? 3u : 2u;
         fb.pAttachments = attachments;
         fb.width = f.width;
         fb.height = f.height;
@@ -1282,43 +2808,109 @@ struct VulkanMvp::Impl final {
 
         vk_check(vkCreateFramebuffer(device, &fb, nullptr, &f.framebuffer),
                  "vkCreateFramebuffer(offscreen)");
+        f.framebuffer_msaa_view = msaa_view;
+        f.framebuffer_depth_view = depth_view;
+        f.framebuffer_generation = generation;
+    }
 
-        // ImGui texture handle
-        f.imgui_texture_set = ImGui_ImplVulkan_AddTexture(
-            offscreen_sampler, f.color_view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    // Fixes the area the slot renders into this frame from the current dynamic-resolution scale.
+    // The viewport's UVs are baked into the ImGui draw data before the frame is recorded, so both
+    // must see the same size: it is latched once per frame, in build_ui() (or before recording
+    // when headless), and controller updates later in the frame apply to the next one.
+    void latch_render_size(OffscreenFrame &f) const noexcept {
+        const float s = dynamic_resolution.scale();
+        const auto scaled = [s](std::uint32_t full) {
+            const auto n = static_cast<std::uint32_t>(std::lround(static_cast<float>(full) * s));
+            return std::clamp(n, 1u, full);
+        };
+        f.render_width = scaled(f.width);
+        f.render_height = scaled(f.height);
     }
 
-    void recreate_offscreen(std::uint32_t w, std::uint32_t h) {
-        vkDeviceWaitIdle(device);
+    // Only the images are size dependent: the render pass, sampler and cube pipeline survive
+    // every resize (viewport/scissor are dynamic state).
+    void recreate_offscreen(Viewport &vp, std::uint32_t w, std::uint32_t h) {
+        PBA_PROFILE_ZONE("recreate_offscreen");
+        for (std::uint32_t i = 0; i < frames_in_flight; ++i) {
+            resize_offscreen_frame(vp, i, w, h);
+        }
+    }
 
-        destroy_offscreen();
-        create_offscreen_render_pass_and_sampler();
+    // Tracks the viewport size requested by the UI; returns true once it has been stable for
+    // k_resize_settle_frames frames or k_resize_settle_time, whichever comes first.
+    [[nodiscard]] static bool offscreen_size_settled(Viewport &vp, std::uint32_t w, std::uint32_t h) {
+        const auto now = std::chrono::steady_clock::now();
+        if (w != vp.requested_width || h != vp.requested_height) {
+            vp.requested_width = w;
+            vp.requested_height = h;
+            vp.requested_stable_frames = 0;
+            vp.requested_since = now;
+            return false;
+        }
+
+        ++vp.requested_stable_frames;
+        return vp.requested_stable_frames >= k_resize_settle_frames ||
+               (now - vp.requested_since) >= k_resize_settle_time;
+    }
 
-        for (OffscreenFrame &f : offscreen) {
-            create_offscreen_frame_resources(f, w, h);
+    // Reallocates a single slot without waiting: the old images go through the deletion queue.
+    void resize_offscreen_frame(Viewport &vp, std::uint32_t slot, std::uint32_t w, std::uint32_t h) {
+        PBA_PROFILE_ZONE("resize_offscreen_frame");
+        OffscreenFrame &f = vp.frames[slot];
+        if (slot == vp.shown) {
+            vp.shown_valid = false;
         }
+        OffscreenFrame old = f;
+        retire([this, old]() mutable {
+            destroy_offscreen_frame_resources(old);
+        });
 
-        // Cube pipeline references the offscreen render pass.
-        destroy_cube_pipeline();
-        create_cube_pipeline();
+        f = OffscreenFrame{};
+        create_offscreen_frame_resources(f, w, h);
     }
 
-    void create_cube_vertex_buffer() {
-        const VkDeviceSize size = static_cast<VkDeviceSize>(k_cube_vertices.size() * sizeof(Vertex));
+    // Adds or removes viewports from the end, from the UI before the frame is recorded. A new
+    // viewport starts at the first one's size and its preset camera and renders this frame; a
+    // removed one's images go through the deletion queue, since this frame's UI may still show
+    // them.
+    void set_viewport_count(std::uint32_t count) {
+        count = std::clamp(count, 1u, k_max_viewports);
+        for (; viewport_count < count; ++viewport_count) {
+            Viewport &vp = viewports[viewport_count];
+            vp = Viewport{};
+            vp.camera = initial_camera(viewport_count);
+            const OffscreenFrame &like = viewports[0].frames[frame_index];
+            for (std::uint32_t i = 0; i < frames_in_flight; ++i) {
+                create_offscreen_frame_resources(vp.frames[i], like.width, like.height);
+            }
+            render_offscreen = true;
+        }
+        for (; viewport_count > count; --viewport_count) {
+            Viewport &vp = viewports[viewport_count - 1u];
+            for (std::uint32_t i = 0; i < frames_in_flight; ++i) {
+                OffscreenFrame old = vp.frames[i];
+                retire([this, old]() mutable {
+                    destroy_offscreen_frame_resources(old);
+                });
+            }
+            vp = Viewport{};
+        }
+    }
 
+    void create_upload_context() {
         VkBufferCreateInfo bci{};
         bci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
         bci.pNext = nullptr;
         bci.flags = 0;
-        bci.size = size;
-        bci.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+        bci.size = k_staging_ring_size;
+        bci.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
         bci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
         bci.queueFamilyIndexCount = 0;
         bci.pQueueFamilyIndices = nullptr;
 
         VmaAllocationCreateInfo aci{};
         aci.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
-        aci.usage = VMA_MEMORY_USAGE_AUTO;
+        aci.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
         aci.requiredFlags = 0;
         aci.preferredFlags = 0;
         aci.memoryTypeBits = 0;
@@ -1327,72 +2919,538 @@ struct VulkanMvp::Impl final {
         aci.priority = 0.0f;
 
         VmaAllocationInfo alloc_info{};
-        vk_check(vmaCreateBuffer(allocator, &bci, &aci, &cube_vbo, &cube_vbo_alloc, &alloc_info),
-                 "vmaCreateBuffer(cube_vbo)");
+        vk_check(vmaCreateBuffer(allocator, &bci, &aci, &staging_buffer, &staging_alloc, &alloc_info),
+                 "vmaCreateBuffer(staging)");
+        staging_mapped = static_cast<std::uint8_t *>(alloc_info.pMappedData);
+
+        VkCommandPoolCreateInfo pci{};
+        pci.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        pci.pNext = nullptr;
+        pci.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        pci.queueFamilyIndex = transfer_queue_family;
+        vk_check(vkCreateCommandPool(device, &pci, nullptr, &upload_cmd_pool), "vkCreateCommandPool(upload)");
+
+        std::array<VkCommandBuffer, k_upload_batches> cmds{};
+        VkCommandBufferAllocateInfo ai{};
+        ai.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        ai.pNext = nullptr;
+        ai.commandPool = upload_cmd_pool;
+        ai.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        ai.commandBufferCount = k_upload_batches;
+        vk_check(vkAllocateCommandBuffers(device, &ai, cmds.data()), "vkAllocateCommandBuffers(upload)");
+        for (std::uint32_t i = 0; i < k_upload_batches; ++i) {
+            upload_batches[i].cmd = cmds[i];
+        }
+
+        VkSemaphoreTypeCreateInfo tci{};
+        tci.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        tci.pNext = nullptr;
+        tci.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        tci.initialValue = 0;
+
+        VkSemaphoreCreateInfo sci{};
+        sci.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        sci.pNext = &tci;
+        sci.flags = 0;
+        vk_check(vkCreateSemaphore(device, &sci, nullptr, &upload_timeline), "vkCreateSemaphore(upload_timeline)");
+    }
+
+    void destroy_upload_context() {
+        if (upload_timeline) {
+            vkDestroySemaphore(device, upload_timeline, nullptr);
+            upload_timeline = VK_NULL_HANDLE;
+        }
+        if (upload_cmd_pool) {
+            vkDestroyCommandPool(device, upload_cmd_pool, nullptr);
+            upload_cmd_pool = VK_NULL_HANDLE;
+        }
+        for (UploadBatch &b : upload_batches) {
+            b = UploadBatch{};
+        }
+        pending_acquires.clear();
+        if (staging_buffer && staging_alloc) {
+            vmaDestroyBuffer(allocator, staging_buffer, staging_alloc);
+            staging_buffer = VK_NULL_HANDLE;
+            staging_alloc = VK_NULL_HANDLE;
+            staging_mapped = nullptr;
+        }
+    }
+
+    [[nodiscard]] std::uint64_t upload_completed_value() const {
+        std::uint64_t value = 0;
+        vk_check(vkGetSemaphoreCounterValue(device, upload_timeline, &value), "vkGetSemaphoreCounterValue(upload)");
+        return value;
+    }
+
+    void wait_upload_value(std::uint64_t value) const {
+        VkSemaphoreWaitInfo wi{};
+        wi.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        wi.pNext = nullptr;
+        wi.flags = 0;
+        wi.semaphoreCount = 1;
+        wi.pSemaphores = &upload_timeline;
+        wi.pValues = &value;
+        vk_check(vkWaitSemaphores(device, &wi, UINT64_MAX), "vkWaitSemaphores(upload)");
+    }
+
+    // Releases the ring space of every batch whose copies the GPU has finished. Timeline values
+    // complete in order, so the tail simply jumps to the newest completed batch.
+    void reclaim_uploads() {
+        const std::uint64_t done = upload_completed_value();
+        for (UploadBatch &b : upload_batches) {
+            if (b.pending && b.timeline_value <= done) {
+                b.pending = false;
+                staging_tail = std::max(staging_tail, b.ring_end);
+            }
+        }
+    }
+
+    [[nodiscard]] UploadBatch &current_upload_batch() {
+        UploadBatch &b = upload_batches[upload_batch_index];
+        if (b.recording) {
+            return b;
+        }
+
+        if (b.pending) {
+            wait_upload_value(b.timeline_value);
+            reclaim_uploads();
+        }
+
+        vk_check(vkResetCommandBuffer(b.cmd, 0), "vkResetCommandBuffer(upload)");
+
+        VkCommandBufferBeginInfo bi{};
+        bi.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        bi.pNext = nullptr;
+        bi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        bi.pInheritanceInfo = nullptr;
+        vk_check(vkBeginCommandBuffer(b.cmd, &bi), "vkBeginCommandBuffer(upload)");
+
+        b.recording = true;
+        return b;
+    }
+
+    // Reserves `size` (<= ring size) contiguous bytes and returns their physical offset. When the
+    // ring is full the pending copies are submitted and the oldest batch is waited on.
+    [[nodiscard]] VkDeviceSize reserve_staging(VkDeviceSize size) {
+        for (;;) {
+            VkDeviceSize start = (staging_head + k_staging_alignment - 1u) & ~(k_staging_alignment - 1u);
+            const VkDeviceSize phys_start = start % k_staging_ring_size;
+            if (phys_start + size > k_staging_ring_size) {
+                // Would straddle the end of the ring; continue at the start of the next lap.
+                start += k_staging_ring_size - phys_start;
+            }
+
+            if (start + size - staging_tail <= k_staging_ring_size) {
+                staging_head = start + size;
+                return start % k_staging_ring_size;
+            }
+
+            submit_uploads();
+
+            const UploadBatch *oldest = nullptr;
+            for (const UploadBatch &b : upload_batches) {
+                if (b.pending && (!oldest || b.timeline_value < oldest->timeline_value)) {
+                    oldest = &b;
+                }
+            }
+            if (!oldest) {
+                throw std::runtime_error("Staging ring exhausted with no pending uploads");
+            }
+            wait_upload_value(oldest->timeline_value);
+            reclaim_uploads();
+        }
+    }
+
+    // Records a copy of `size` bytes from host memory into `dst` (any size; large uploads are
+    // split into ring-sized chunks). Visible to graphics work submitted after submit_uploads(),
+    // at `dst_stage` / `dst_access`. `concurrent` must match how `dst` was created: a shared
+    // buffer skips the ownership transfer, and the graphics submit's wait on upload_timeline
+    // alone makes the copy visible.
+    void upload_buffer(VkBuffer dst, VkDeviceSize dst_offset, const void *src, VkDeviceSize size,
+                       VkAccessFlags dst_access, VkPipelineStageFlags dst_stage, bool concurrent = false) {
+        const auto *bytes = static_cast<const std::uint8_t *>(src);
+        const VkDeviceSize range_offset = dst_offset;
+        const VkDeviceSize range_size = size;
+        const VkDeviceSize max_chunk = k_staging_ring_size / 2u;
+
+        while (size > 0u) {
+            const VkDeviceSize chunk = std::min(size, max_chunk);
+            const VkDeviceSize offset = reserve_staging(chunk);
+
+            std::memcpy(staging_mapped + offset, bytes, static_cast<std::size_t>(chunk));
+            vk_check(vmaFlushAllocation(allocator, staging_alloc, offset, chunk), "vmaFlushAllocation(staging)");
+
+            UploadBatch &b = current_upload_batch();
+            const VkBufferCopy region{offset, dst_offset, chunk};
+            vkCmdCopyBuffer(b.cmd, staging_buffer, dst, 1, &region);
+
+            bytes += chunk;
+            dst_offset += chunk;
+            size -= chunk;
+        }
+
+        if (transfer_queue_family == graphics_queue_family || concurrent || range_size == 0u) {
+            return;
+        }
+
+        // Queue family ownership transfer, release half. Lands in the batch holding the last
+        // chunk; earlier chunks were submitted before it on the same queue.
+        VkBufferMemoryBarrier release{};
+        release.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        release.pNext = nullptr;
+        release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        release.dstAccessMask = 0;
+        release.srcQueueFamilyIndex = transfer_queue_family;
+        release.dstQueueFamilyIndex = graphics_queue_family;
+        release.buffer = dst;
+        release.offset = range_offset;
+        release.size = range_size;
+        vkCmdPipelineBarrier(current_upload_batch().cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &release, 0, nullptr);
+
+        pending_acquires.push_back(PendingAcquire{dst, range_offset, range_size, dst_access, dst_stage});
+    }
+
+    // Acquire half of the ownership transfers released in upload_buffer(). Must be recorded into
+    // a graphics command buffer whose submit waits on the current upload_timeline_value.
+    void record_upload_acquires(VkCommandBuffer cb) {
+        if (pending_acquires.empty()) {
+            return;
+        }
+
+        std::vector<VkBufferMemoryBarrier> barriers;
+        barriers.reserve(pending_acquires.size());
+        VkPipelineStageFlags dst_stages = 0;
+        for (const PendingAcquire &a : pending_acquires) {
+            VkBufferMemoryBarrier acquire{};
+            acquire.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            acquire.pNext = nullptr;
+            acquire.srcAccessMask = 0;
+            acquire.dstAccessMask = a.dst_access;
+            acquire.srcQueueFamilyIndex = transfer_queue_family;
+            acquire.dstQueueFamilyIndex = graphics_queue_family;
+            acquire.buffer = a.buffer;
+            acquire.offset = a.offset;
+            acquire.size = a.size;
+            barriers.push_back(acquire);
+            dst_stages |= a.dst_stage;
+        }
+        vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dst_stages, 0, 0, nullptr,
+                             static_cast<std::uint32_t>(barriers.size()), barriers.data(), 0, nullptr);
+        pending_acquires.clear();
+    }
+
+    // Submits the recorded copies to the transfer queue, where they run alongside in-flight
+    // frames. draw_frame() makes the next graphics submit wait on the resulting timeline value,
+    // so callers never have to wait themselves.
+    void submit_uploads() {
+        UploadBatch &b = upload_batches[upload_batch_index];
+        if (!b.recording) {
+            return;
+        }
+
+        vk_check(vkEndCommandBuffer(b.cmd), "vkEndCommandBuffer(upload)");
+        b.recording = false;
+        b.timeline_value = ++upload_timeline_value;
+        b.ring_end = staging_head;
+        b.pending = true;
+
+        VkTimelineSemaphoreSubmitInfo ts{};
+        ts.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        ts.pNext = nullptr;
+        ts.waitSemaphoreValueCount = 0;
+        ts.pWaitSemaphoreValues = nullptr;
+        ts.signalSemaphoreValueCount = 1;
+        ts.pSignalSemaphoreValues = &b.timeline_value;
+
+        VkSubmitInfo si{};
+        si.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        si.pNext = &ts;
+        si.waitSemaphoreCount = 0;
+        si.pWaitSemaphores = nullptr;
+        si.pWaitDstStageMask = nullptr;
+        si.commandBufferCount = 1;
+        si.pCommandBuffers = &b.cmd;
+        si.signalSemaphoreCount = 1;
+        si.pSignalSemaphores = &upload_timeline;
+        vk_check(vkQueueSubmit(transfer_queue, 1, &si, VK_NULL_HANDLE), "vkQueueSubmit(upload)");
+
+        upload_batch_index = (upload_batch_index + 1u) % k_upload_batches;
+    }
+
+    // With `concurrent`, the buffer is shared by the graphics and transfer families (when they
+    // differ), so uploads into it need no ownership transfer; see upload_buffer().
+    void create_device_buffer(VkDeviceSize size, VkBufferUsageFlags usage, VkBuffer &buffer, VmaAllocation &alloc,
+                              const char *what, bool concurrent = false) {
+        const std::array<std::uint32_t, 2> families = {graphics_queue_family, transfer_queue_family};
+        const bool shared = concurrent && transfer_queue_family != graphics_queue_family;
+
+        VkBufferCreateInfo bci{};
+        bci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bci.pNext = nullptr;
+        bci.flags = 0;
+        bci.size = size;
+        bci.usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bci.sharingMode = shared ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+        bci.queueFamilyIndexCount = shared ? static_cast<std::uint32_t>(families.size()) : 0u;
+        bci.pQueueFamilyIndices = shared ? families.data() : nullptr;
+
+        VmaAllocationCreateInfo aci{};
+        aci.flags = 0;
+        aci.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+        aci.requiredFlags = 0;
+        aci.preferredFlags = 0;
+        aci.memoryTypeBits = 0;
+        aci.pool = VK_NULL_HANDLE;
+        aci.pUserData = nullptr;
+        aci.priority = 0.0f;
 
-        const std::size_t nbytes = static_cast<std::size_t>(size);
+        vk_check(vmaCreateBuffer(allocator, &bci, &aci, &buffer, &alloc, nullptr), what);
+    }
 
-        if (!alloc_info.pMappedData) {
-            void *mapped = nullptr;
-            vk_check(vmaMapMemory(allocator, cube_vbo_alloc, &mapped), "vmaMapMemory(cube_vbo)");
-            std::memcpy(mapped, k_cube_vertices.data(), nbytes);
-            vmaUnmapMemory(allocator, cube_vbo_alloc);
+    void create_cube_mesh_buffers() {
+        if (streamed_mesh()) {
+            create_streamed_mesh_buffers();
+        } else if (compact_vertices) {
+            std::array<CompactVertex, k_cube_vertices.size()> packed{};
+            std::transform(k_cube_vertices.begin(), k_cube_vertices.end(), packed.begin(), to_compact_vertex);
+            create_device_buffer(sizeof(packed), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                 cube_vbo, cube_vbo_alloc, "vmaCreateBuffer(cube_vbo)");
+            upload_buffer(cube_vbo, 0, packed.data(), sizeof(packed),
+                          VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
         } else {
-            std::memcpy(alloc_info.pMappedData, k_cube_vertices.data(), nbytes);
+            create_device_buffer(sizeof(k_cube_vertices), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                 cube_vbo, cube_vbo_alloc, "vmaCreateBuffer(cube_vbo)");
+            upload_buffer(cube_vbo, 0, k_cube_vertices.data(), sizeof(k_cube_vertices),
+                          VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+        }
+
+        if (!streamed_mesh()) {
+            create_device_buffer(sizeof(k_cube_indices), VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                 cube_ibo, cube_ibo_alloc, "vmaCreateBuffer(cube_ibo)");
+            upload_buffer(cube_ibo, 0, k_cube_indices.data(), sizeof(k_cube_indices),
+                          VK_ACCESS_INDEX_READ_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
         }
+
+        // Read by cube.vert and, on the mesh path, cube.mesh.
+        const VkPipelineStageFlags material_stages =
+            VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+            (mesh_shader_ext ? VkPipelineStageFlags{VK_PIPELINE_STAGE_MESH_SHADER_BIT_EXT} : 0u);
+        create_device_buffer(sizeof(k_materials), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                             material_buffer, material_buffer_alloc, "vmaCreateBuffer(materials)");
+        upload_buffer(material_buffer, 0, k_materials.data(), sizeof(k_materials), VK_ACCESS_SHADER_READ_BIT,
+                      material_stages);
+        material_slot = bindless.add_buffer(material_buffer);
+
+        submit_uploads();
     }
 
-    void destroy_cube_vertex_buffer() {
+    void destroy_cube_mesh_buffers() {
         if (cube_vbo && cube_vbo_alloc) {
             vmaDestroyBuffer(allocator, cube_vbo, cube_vbo_alloc);
             cube_vbo = VK_NULL_HANDLE;
             cube_vbo_alloc = VK_NULL_HANDLE;
         }
+        if (cube_ibo && cube_ibo_alloc) {
+            vmaDestroyBuffer(allocator, cube_ibo, cube_ibo_alloc);
+            cube_ibo = VK_NULL_HANDLE;
+            cube_ibo_alloc = VK_NULL_HANDLE;
+        }
+        if (material_buffer && material_buffer_alloc) {
+            vmaDestroyBuffer(allocator, material_buffer, material_buffer_alloc);
+            material_buffer = VK_NULL_HANDLE;
+            material_buffer_alloc = VK_NULL_HANDLE;
+        }
+        bindless.release_buffer(material_slot);
+        material_slot = BindlessHeap::k_invalid_slot;
+        mesh_file.close();
+    }
+
+    [[nodiscard]] bool streamed_mesh() const noexcept { return !mesh_path.empty(); }
+
+    // Maps and validates the file and fits it into the scene; touches no Vulkan state, so it runs
+    // as a startup job.
+    void open_streamed_mesh() {
+        mesh_file.open(mesh_path);
+        const MeshFileHeader &h = mesh_file.header();
+        if (h.index_count > UINT32_MAX) {
+            throw std::runtime_error(mesh_path + ": more indices than a single draw can take");
+        }
+
+        const glm::vec3 center(h.bounds);
+        const float scale = h.bounds.w > 0.0f ? k_cube_bounding_radius / h.bounds.w : 1.0f;
+        mesh_fit = glm::scale(glm::mat4(1.0f), glm::vec3(scale)) * glm::translate(glm::mat4(1.0f), -center);
+        mesh_sphere = h.bounds;
+    }
+
+    // Sizes cube_vbo/cube_ibo for the whole file; stream_mesh() fills them over the next frames.
+    // The transfer queue keeps writing later ranges while graphics already draws from earlier
+    // ones, so both buffers are shared by the two families instead of passed back and forth.
+    void create_streamed_mesh_buffers() {
+        const MeshFileHeader &h = mesh_file.header();
+        create_device_buffer(static_cast<VkDeviceSize>(h.vertex_count) * sizeof(Vertex),
+                             VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, cube_vbo, cube_vbo_alloc, "vmaCreateBuffer(mesh_vbo)",
+                             true);
+        create_device_buffer(static_cast<VkDeviceSize>(h.index_count) * sizeof(std::uint32_t),
+                             VK_BUFFER_USAGE_INDEX_BUFFER_BIT, cube_ibo, cube_ibo_alloc, "vmaCreateBuffer(mesh_ibo)",
+                             true);
+        mesh_streamer.begin(mesh_file);
+    }
+
+    // Uploads the next k_mesh_stream_budget bytes of the streamed mesh. The next graphics submit
+    // waits for them, so the frame recorded next already draws the new triangles. The mapping is
+    // closed once everything is on the GPU.
+    void stream_mesh() {
+        PBA_PROFILE_ZONE("stream_mesh");
+        if (!mesh_file.is_open()) {
+            return;
+        }
+        mesh_streamer.pump(k_mesh_stream_budget, [this](MeshStreamer::Stream stream, std::uint64_t dst_offset,
+                                                        std::span<const std::byte> data) {
+            const bool vertices = (stream == MeshStreamer::Stream::vertices);
+            upload_buffer(vertices ? cube_vbo : cube_ibo, dst_offset, data.data(), data.size(),
+                          vertices ? VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT : VK_ACCESS_INDEX_READ_BIT,
+                          VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, true);
+        });
+        ++scene_revision;
+        if (mesh_streamer.done()) {
+            mesh_file.close();
+        }
+    }
+
+    [[nodiscard]] std::uint32_t draw_index_count() const noexcept {
+        return streamed_mesh() ? static_cast<std::uint32_t>(mesh_streamer.drawable_indices())
+                               : static_cast<std::uint32_t>(k_cube_indices.size());
+    }
+
+    [[nodiscard]] static MeshletMesh build_cube_meshlets() {
+        std::array<glm::vec3, k_cube_vertices.size()> positions{};
+        std::transform(k_cube_vertices.begin(), k_cube_vertices.end(), positions.begin(),
+                       [](const Vertex &v) { return v.pos; });
+        std::array<std::uint32_t, k_cube_indices.size()> indices{};
+        std::copy(k_cube_indices.begin(), k_cube_indices.end(), indices.begin());
+        return build_meshlets(positions, indices);
+    }
+
+    // Uploads the cube's meshlets and adds the buffers to the bindless heap. The mesh shader
+    // always reads float32 vertices; compact_vertices only affects the vertex path.
+    void create_meshlet_buffers(const MeshletMesh &mesh) {
+        meshlet_count = static_cast<std::uint32_t>(mesh.meshlets.size());
+
+        const std::array<std::span<const std::byte>, k_meshlet_buffers> data = {
+            std::as_bytes(std::span{k_cube_vertices}),
+            std::as_bytes(std::span{mesh.meshlets}),
+            std::as_bytes(std::span{mesh.vertices}),
+            std::as_bytes(std::span{mesh.triangles}),
+        };
+        constexpr std::array<const char *, k_meshlet_buffers> k_names = {
+            "vmaCreateBuffer(meshlet_vertex_data)", "vmaCreateBuffer(meshlets)",
+            "vmaCreateBuffer(meshlet_vertices)", "vmaCreateBuffer(meshlet_triangles)"};
+
+        for (std::uint32_t i = 0; i < k_meshlet_buffers; ++i) {
+            create_device_buffer(data[i].size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, meshlet_buffers[i],
+                                 meshlet_buffer_allocs[i], k_names[i]);
+            upload_buffer(meshlet_buffers[i], 0, data[i].data(), data[i].size(), VK_ACCESS_SHADER_READ_BIT,
+                          VK_PIPELINE_STAGE_TASK_SHADER_BIT_EXT | VK_PIPELINE_STAGE_MESH_SHADER_BIT_EXT);
+            meshlet_slots[i] = bindless.add_buffer(meshlet_buffers[i]);
+        }
+
+        submit_uploads();
+    }
+
+    void destroy_meshlet_buffers() {
+        for (std::uint32_t i = 0; i < k_meshlet_buffers; ++i) {
+            if (meshlet_buffers[i] && meshlet_buffer_allocs[i]) {
+                vmaDestroyBuffer(allocator, meshlet_buffers[i], meshlet_buffer_allocs[i]);
+            }
+            bindless.release_buffer(meshlet_slots[i]);
+            meshlet_buffers[i] = VK_NULL_HANDLE;
+            meshlet_buffer_allocs[i] = VK_NULL_HANDLE;
+            meshlet_slots[i] = BindlessHeap::k_invalid_slot;
+        }
+        meshlet_count = 0;
+    }
+
+    [[nodiscard]] static VkPipelineShaderStageCreateInfo shader_stage(VkShaderStageFlagBits stage,
+                                                                      VkShaderModule module) {
+        VkPipelineShaderStageCreateInfo s{};
+        s.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        s.pNext = nullptr;
+        s.flags = 0;
+        s.stage = stage;
+        s.module = module;
+        s.pName = "main";
+        s.pSpecializationInfo = nullptr;
+        return s;
+    }
+
+    [[nodiscard]] VkPipelineLayout create_pipeline_layout(std::span<const VkDescriptorSetLayout> set_layouts,
+                                                          VkShaderStageFlags push_stages, std::uint32_t push_size,
+                                                          const char *what) {
+        VkPushConstantRange pcr{};
+        pcr.stageFlags = push_stages;
+        pcr.offset = 0;
+        pcr.size = push_size;
+
+        VkPipelineLayoutCreateInfo pl{};
+        pl.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pl.pNext = nullptr;
+        pl.flags = 0;
+        pl.setLayoutCount = static_cast<std::uint32_t>(set_layouts.size());
+        pl.pSetLayouts = set_layouts.data();
+        pl.pushConstantRangeCount = 1;
+        pl.pPushConstantRanges = &pcr;
+
+        VkPipelineLayout layout{VK_NULL_HANDLE};
+        vk_check(vkCreatePipelineLayout(device, &pl, nullptr, &layout), what);
+        return layout;
     }
 
     void create_cube_pipeline() {
-        const std::filesystem::path base = std::filesystem::path{"assets"} / "shaders";
-        const VkShaderModule vs = create_shader_module(device, base / "cube.vert.spv");
-        const VkShaderModule fs = create_shader_module(device, base / "cube.frag.spv");
-
-        VkPipelineShaderStageCreateInfo stages[2]{};
-
-        stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        stages[0].pNext = nullptr;
-        stages[0].flags = 0;
-        stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
-        stages[0].module = vs;
-        stages[0].pName = "main";
-        stages[0].pSpecializationInfo = nullptr;
-
-        stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        stages[1].pNext = nullptr;
-        stages[1].flags = 0;
-        stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-        stages[1].module = fs;
-        stages[1].pName = "main";
-        stages[1].pSpecializationInfo = nullptr;
+        const VkShaderModule vs = create_shader_module(device, "cube.vert.spv");
+        const VkShaderModule fs = create_shader_module(device, "cube.frag.spv");
+
+        const std::array<VkPipelineShaderStageCreateInfo, 2> stages = {
+            shader_stage(VK_SHADER_STAGE_VERTEX_BIT, vs),
+            shader_stage(VK_SHADER_STAGE_FRAGMENT_BIT, fs),
+        };
 
         const VkVertexInputBindingDescription binding{
             .binding = 0,
-            .stride = static_cast<std::uint32_t>(sizeof(Vertex)),
+            .stride = static_cast<std::uint32_t>(compact_vertices ? sizeof(CompactVertex) : sizeof(Vertex)),
             .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
         };
 
-        const std::array<VkVertexInputAttributeDescription, 2> attrs = {
-            VkVertexInputAttributeDescription{
-                .location = 0,
-                .binding = 0,
-                .format = VK_FORMAT_R32G32B32_SFLOAT,
-                .offset = 0,
-            },
-            VkVertexInputAttributeDescription{
-                .location = 1,
-                .binding = 0,
-                .format = VK_FORMAT_R32G32B32_SFLOAT,
-                .offset = static_cast<std::uint32_t>(offsetof(Vertex, color)),
-            },
-        };
+        // cube.vert consumes vec3s either way; snorm/unorm formats expand to float in the fetch.
+        const std::array<VkVertexInputAttributeDescription, 2> attrs = compact_vertices
+            ? std::array<VkVertexInputAttributeDescription, 2>{
+                  VkVertexInputAttributeDescription{
+                      .location = 0,
+                      .binding = 0,
+                      .format = VK_FORMAT_R16G16B16A16_SNORM,
+                      .offset = static_cast<std::uint32_t>(offsetof(CompactVertex, pos)),
+                  },
+                  VkVertexInputAttributeDescription{
+                      .location = 1,
+                      .binding = 0,
+                      .format = VK_FORMAT_R8G8B8A8_UNORM,
+                      .offset = static_cast<std::uint32_t>(offsetof(CompactVertex, color)),
+                  },
+              }
+            : std::array<VkVertexInputAttributeDescription, 2>{
+                  VkVertexInputAttributeDescription{
+                      .location = 0,
+                      .binding = 0,
+                      .format = VK_FORMAT_R32G32B32_SFLOAT,
+                      .offset = 0,
+                  },
+                  VkVertexInputAttributeDescription{
+                      .location = 1,
+                      .binding = 0,
+                      .format = VK_FORMAT_R32G32B32_SFLOAT,
+                      .offset = static_cast<std::uint32_t>(offsetof(Vertex, color)),
+                  },
+              };
 
         VkPipelineVertexInputStateCreateInfo vi{};
         vi.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
@@ -1410,6 +3468,40 @@ struct VulkanMvp::Impl final {
         ia.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
         ia.primitiveRestartEnable = VK_FALSE;
 
+        cube_pipeline = create_offscreen_pipeline(stages, &vi, &ia, bindless_pipeline_layout,
+                                                  "vkCreateGraphicsPipelines(cube)");
+
+        vkDestroyShaderModule(device, fs, nullptr);
+        vkDestroyShaderModule(device, vs, nullptr);
+    }
+
+    // The task/mesh shaders generate the geometry, so there is no vertex input or input assembly.
+    void create_meshlet_pipeline() {
+        const VkShaderModule ts = create_shader_module(device, "cube.task.spv");
+        const VkShaderModule ms = create_shader_module(device, "cube.mesh.spv");
+        const VkShaderModule fs = create_shader_module(device, "cube.frag.spv");
+
+        const std::array<VkPipelineShaderStageCreateInfo, 3> stages = {
+            shader_stage(VK_SHADER_STAGE_TASK_BIT_EXT, ts),
+            shader_stage(VK_SHADER_STAGE_MESH_BIT_EXT, ms),
+            shader_stage(VK_SHADER_STAGE_FRAGMENT_BIT, fs),
+        };
+
+        meshlet_pipeline = create_offscreen_pipeline(stages, nullptr, nullptr, bindless_pipeline_layout,
+                                                     "vkCreateGraphicsPipelines(meshlet)");
+
+        vkDestroyShaderModule(device, fs, nullptr);
+        vkDestroyShaderModule(device, ms, nullptr);
+        vkDestroyShaderModule(device, ts, nullptr);
+    }
+
+    // The state every pipeline drawing into the offscreen pass shares: dynamic viewport/scissor,
+    // no culling, depth LESS, opaque, offscreen_samples. `vi`/`ia` are null for mesh pipelines.
+    [[nodiscard]] VkPipeline create_offscreen_pipeline(std::span<const VkPipelineShaderStageCreateInfo> stages,
+                                                       const VkPipelineVertexInputStateCreateInfo *vi,
+                                                       const VkPipelineInputAssemblyStateCreateInfo *ia,
+                                                       VkPipelineLayout layout, const char *what) {
+        PBA_PROFILE_ZONE("create_offscreen_pipeline");
         VkPipelineViewportStateCreateInfo vp{};
         vp.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
         vp.pNext = nullptr;
@@ -1438,7 +3530,7 @@ struct VulkanMvp::Impl final {
         ms.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
         ms.pNext = nullptr;
         ms.flags = 0;
-        ms.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+        ms.rasterizationSamples = offscreen_samples;
         ms.sampleShadingEnable = VK_FALSE;
         ms.minSampleShading = 0.0f;
         ms.pSampleMask = nullptr;
@@ -1495,31 +3587,14 @@ struct VulkanMvp::Impl final {
         dyn.dynamicStateCount = static_cast<std::uint32_t>(dyn_states.size());
         dyn.pDynamicStates = dyn_states.data();
 
-        VkPushConstantRange pcr{};
-        pcr.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-        pcr.offset = 0;
-        pcr.size = static_cast<std::uint32_t>(sizeof(glm::mat4));
-
-        VkPipelineLayoutCreateInfo pl{};
-        pl.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pl.pNext = nullptr;
-        pl.flags = 0;
-        pl.setLayoutCount = 0;
-        pl.pSetLayouts = nullptr;
-        pl.pushConstantRangeCount = 1;
-        pl.pPushConstantRanges = &pcr;
-
-        vk_check(vkCreatePipelineLayout(device, &pl, nullptr, &cube_pipeline_layout),
-                 "vkCreatePipelineLayout(cube)");
-
         VkGraphicsPipelineCreateInfo gp{};
         gp.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
         gp.pNext = nullptr;
         gp.flags = 0;
-        gp.stageCount = 2;
-        gp.pStages = stages;
-        gp.pVertexInputState = &vi;
-        gp.pInputAssemblyState = &ia;
+        gp.stageCount = static_cast<std::uint32_t>(stages.size());
+        gp.pStages = stages.data();
+        gp.pVertexInputState = vi;
+        gp.pInputAssemblyState = ia;
         gp.pTessellationState = nullptr;
         gp.pViewportState = &vp;
         gp.pRasterizationState = &rs;
@@ -1527,128 +3602,1070 @@ struct VulkanMvp::Impl final {
         gp.pDepthStencilState = &ds;
         gp.pColorBlendState = &cb;
         gp.pDynamicState = &dyn;
-        gp.layout = cube_pipeline_layout;
+        gp.layout = layout;
         gp.renderPass = offscreen_render_pass;
         gp.subpass = 0;
         gp.basePipelineHandle = VK_NULL_HANDLE;
         gp.basePipelineIndex = -1;
 
-        vk_check(vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &gp, nullptr, &cube_pipeline),
-                 "vkCreateGraphicsPipelines(cube)");
+        VkPipeline pipeline{VK_NULL_HANDLE};
+        vk_check(vkCreateGraphicsPipelines(device, pipeline_cache, 1, &gp, nullptr, &pipeline), what);
+        return pipeline;
+    }
 
-        vkDestroyShaderModule(device, fs, nullptr);
-        vkDestroyShaderModule(device, vs, nullptr);
+    void create_bindless_heap() {
+        // The mesh stages may only be named when the extension is enabled.
+        const VkShaderStageFlags mesh_stages =
+            mesh_shader_ext ? VkShaderStageFlags{VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT} : 0u;
+        const VkShaderStageFlags stages =
+            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT | mesh_stages;
+        bindless.init(device, stages, bindless_buffer_capacity, bindless_image_capacity);
+
+        // One push range over every stage that reads push constants, sized for the largest block.
+        bindless_push_stages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT | mesh_stages;
+        constexpr std::size_t k_push_size =
+            std::max({sizeof(CubePushConstants), sizeof(CullPushConstants), sizeof(MeshletPushConstants)});
+        static_assert(k_push_size <= 128, "push constants must fit the guaranteed maxPushConstantsSize");
+        const VkDescriptorSetLayout heap_layout = bindless.layout();
+        bindless_pipeline_layout = create_pipeline_layout({&heap_layout, 1}, bindless_push_stages,
+                                                          static_cast<std::uint32_t>(k_push_size),
+                                                          "vkCreatePipelineLayout(bindless)");
+    }
+
+    // Binds the heap for every pipeline built on bindless_pipeline_layout; they never disturb it,
+    // so this is needed once per command buffer (and bind point), not per draw or dispatch.
+    void bind_bindless_heap(VkCommandBuffer cb, bool compute) const {
+        const VkDescriptorSet heap = bindless.set();
+        vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, bindless_pipeline_layout, 0, 1, &heap, 0,
+                                nullptr);
+        if (compute) {
+            vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_COMPUTE, bindless_pipeline_layout, 0, 1, &heap, 0,
+                                    nullptr);
+        }
+    }
+
+    void destroy_instance_buffer(InstanceBuffer &ib) {
+        if (ib.buffer && ib.alloc) {
+            vmaDestroyBuffer(allocator, ib.buffer, ib.alloc);
+        }
+        if (ib.staging && ib.staging_alloc) {
+            vmaDestroyBuffer(allocator, ib.staging, ib.staging_alloc);
+        }
+        for (std::uint32_t v = 0; v < ib.cull_count; ++v) {
+            CullOutput &c = ib.culls[v];
+            if (c.visible && c.visible_alloc) {
+                vmaDestroyBuffer(allocator, c.visible, c.visible_alloc);
+            }
+            if (c.draw_args && c.draw_args_alloc) {
+                vmaDestroyBuffer(allocator, c.draw_args, c.draw_args_alloc);
+            }
+            bindless.release_buffer(c.visible_slot);
+            bindless.release_buffer(c.draw_args_slot);
+        }
+        bindless.release_buffer(ib.instance_slot);
+        ib = InstanceBuffer{};
+    }
+
+    // `capacity` is the instance buffer's, so every instance can be visible.
+    void create_cull_output(std::uint32_t capacity, CullOutput &c) {
+        create_device_buffer(static_cast<VkDeviceSize>(capacity) * sizeof(std::uint32_t),
+                             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, c.visible, c.visible_alloc,
+                             "vmaCreateBuffer(visible)");
+        create_device_buffer(sizeof(IndirectArgs),
+                             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                             c.draw_args, c.draw_args_alloc, "vmaCreateBuffer(draw_args)");
+        c.visible_slot = bindless.add_buffer(c.visible);
+        c.draw_args_slot = bindless.add_buffer(c.draw_args);
+    }
+
+    // Grows (never shrinks) the slot's instance buffer to hold `count` instances and its cull
+    // outputs to `views` viewports. Must only be called once the slot's last submission has
+    // completed, since it replaces the buffers the slot's draws reference. The old bindless slots
+    // are released with the old buffers.
+    //
+    // The buffer prefers DEVICE_LOCAL memory the CPU can write directly (ReBAR / UMA). Where VMA
+    // cannot provide that (ALLOW_TRANSFER_INSTEAD), a host staging buffer is added and the copy is
+    // recorded into the frame's own command buffer by record_instance_copy().
+    void ensure_instance_capacity(InstanceBuffer &ib, std::uint32_t count, std::uint32_t views) {
+        if (count <= ib.capacity) {
+            // Outputs for a viewport added since the last grow.
+            for (; ib.cull_count < views; ++ib.cull_count) {
+                create_cull_output(ib.capacity, ib.culls[ib.cull_count]);
+            }
+            return;
+        }
+
+        if (ib.buffer) {
+            InstanceBuffer old = ib;
+            retire([this, old]() mutable {
+                destroy_instance_buffer(old);
+            });
+            ib = InstanceBuffer{};
+        }
+
+        const std::uint32_t capacity = std::max(256u, std::bit_ceil(count));
+        const VkDeviceSize size = static_cast<VkDeviceSize>(capacity) * sizeof(InstanceData);
+
+        VkBufferCreateInfo bci{};
+        bci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bci.pNext = nullptr;
+        bci.flags = 0;
+        bci.size = size;
+        bci.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        bci.queueFamilyIndexCount = 0;
+        bci.pQueueFamilyIndices = nullptr;
+
+        VmaAllocationCreateInfo aci{};
+        aci.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+                    VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT |
+                    VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        aci.usage = VMA_MEMORY_USAGE_AUTO;
+        aci.requiredFlags = 0;
+        aci.preferredFlags = 0;
+        aci.memoryTypeBits = 0;
+        aci.pool = VK_NULL_HANDLE;
+        aci.pUserData = nullptr;
+        aci.priority = 0.0f;
+
+        VmaAllocationInfo alloc_info{};
+        vk_check(vmaCreateBuffer(allocator, &bci, &aci, &ib.buffer, &ib.alloc, &alloc_info),
+                 "vmaCreateBuffer(instances)");
+
+        VkMemoryPropertyFlags mem_flags = 0;
+        vmaGetAllocationMemoryProperties(allocator, ib.alloc, &mem_flags);
+
+        if ((mem_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0u) {
+            ib.mapped = static_cast<InstanceData *>(alloc_info.pMappedData);
+        } else {
+            bci.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+            aci.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+            VmaAllocationInfo staging_info{};
+            vk_check(vmaCreateBuffer(allocator, &bci, &aci, &ib.staging, &ib.staging_alloc, &staging_info),
+                     "vmaCreateBuffer(instance_staging)");
+            ib.mapped = static_cast<InstanceData *>(staging_info.pMappedData);
+        }
+        ib.capacity = capacity;
+
+        // Fresh slots, so frames in flight keep reading the old ones (update-after-bind).
+        ib.instance_slot = bindless.add_buffer(ib.buffer);
+        for (; ib.cull_count < views; ++ib.cull_count) {
+            create_cull_output(ib.capacity, ib.culls[ib.cull_count]);
+        }
+    }
+
+    void record_instance_copy(VkCommandBuffer cb, const InstanceBuffer &ib) {
+        if (!ib.staging || ib.count == 0u) {
+            return;
+        }
+
+        const VkBufferCopy region{0, 0, static_cast<VkDeviceSize>(ib.count) * sizeof(InstanceData)};
+        vkCmdCopyBuffer(cb, ib.staging, ib.buffer, 1, &region);
+    }
+
+    // Zeroes the indirect draw's instance count ahead of record_cull().
+    void record_cull_reset(VkCommandBuffer cb, const CullOutput &c) {
+        IndirectArgs init{};
+        init.draw_count = 0;
+        init.cmd.indexCount = draw_index_count();
+        init.cmd.instanceCount = 0;
+        init.cmd.firstIndex = 0;
+        init.cmd.vertexOffset = 0;
+        init.cmd.firstInstance = 0;
+        vkCmdUpdateBuffer(cb, c.draw_args, 0, sizeof(init), &init);
+    }
+
+    // Tests every instance's bounding sphere against one viewport's frustum and compacts the
+    // survivors into c.visible, building the indirect draw in c.draw_args. Recorded outside the
+    // render pass, before that viewport's offscreen pass.
+    void record_cull(VkCommandBuffer cb, const InstanceBuffer &ib, const CullOutput &c, const glm::mat4 &view_proj) {
+        CullPushConstants push{};
+        push.planes = frustum_planes(view_proj);
+        push.sphere = streamed_mesh() ? mesh_sphere : k_cube_bounding_sphere;
+        push.instance_count = static_cast<std::uint32_t>(instance_count);
+        push.instance_slot = ib.instance_slot;
+        push.visible_slot = c.visible_slot;
+        push.draw_args_slot = c.draw_args_slot;
+
+        vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_COMPUTE, cull_pipeline);
+        vkCmdPushConstants(cb, bindless_pipeline_layout, bindless_push_stages, 0,
+                           static_cast<std::uint32_t>(sizeof(push)), &push);
+        vkCmdDispatch(cb, (push.instance_count + k_cull_group_size - 1u) / k_cull_group_size, 1, 1);
+    }
+
+    // Lays the instances out on a centered cube-shaped grid, each spinning with its own phase.
+    void update_instances(InstanceBuffer &ib, float t) {
+        PBA_PROFILE_ZONE("update_instances");
+        const std::uint32_t count = static_cast<std::uint32_t>(instance_count);
+        ensure_instance_capacity(ib, count, viewport_count);
+
+        const std::uint32_t side = instance_grid_side();
+        if (instance_transforms.size() != count || instance_transforms_side != side) {
+            layout_instances(count, side);
+        }
+
+        // Each job writes its own range of the mapped buffer; the flush below covers them all.
+        float *rows = reinterpret_cast<float *>(ib.mapped);
+        jobs->parallel_for(0, count, k_instances_per_job, [&](std::uint32_t first, std::uint32_t last) {
+            TransformBatch &tb = instance_transforms;
+            for (std::uint32_t i = first; i < last; ++i) {
+                // Rz(ti) * Ry(0.6 ti) as a quaternion.
+                const float ti = t + 0.37f * static_cast<float>(i);
+                const float sa = std::sin(0.5f * ti), ca = std::cos(0.5f * ti);
+                const float sb = std::sin(0.3f * ti), cb = std::cos(0.3f * ti);
+                tb.qx[i] = -sa * sb;
+                tb.qy[i] = ca * sb;
+                tb.qz[i] = sa * cb;
+                tb.qw[i] = ca * cb;
+            }
+            compose_transforms(tb, first, last, mesh_fit, rows);
+        });
+
+        ib.count = count;
+        vk_check(vmaFlushAllocation(allocator, ib.staging ? ib.staging_alloc : ib.alloc, 0,
+                                    static_cast<VkDeviceSize>(count) * sizeof(InstanceData)),
+                 "vmaFlushAllocation(instances)");
+    }
+
+    // Centers `count` instances on a side^3 grid.
+    void layout_instances(std::uint32_t count, std::uint32_t side) {
+        const float half = 0.5f * static_cast<float>(side - 1u) * k_instance_spacing;
+
+        TransformBatch &tb = instance_transforms;
+        tb.resize(count);
+        for (std::uint32_t i = 0; i < count; ++i) {
+            tb.px[i] = static_cast<float>(i % side) * k_instance_spacing - half;
+            tb.py[i] = static_cast<float>((i / side) % side) * k_instance_spacing - half;
+            tb.pz[i] = static_cast<float>(i / (side * side)) * k_instance_spacing - half;
+            tb.sx[i] = 1.0f;
+            tb.sy[i] = 1.0f;
+            tb.sz[i] = 1.0f;
+        }
+        instance_transforms_side = side;
+    }
+
+    [[nodiscard]] std::uint32_t instance_grid_side() const {
+        const double n = static_cast<double>(std::max(1, instance_count));
+        std::uint32_t side = static_cast<std::uint32_t>(std::ceil(std::cbrt(n)));
+        // cbrt can land just below an exact cube; make sure side^3 covers every instance.
+        while (static_cast<double>(side) * side * side < n) {
+            ++side;
+        }
+        return std::max(1u, side);
+    }
+
+    void create_cull_pipeline() {
+        PBA_PROFILE_ZONE("create_cull_pipeline");
+        const VkShaderModule cs = create_shader_module(device, "cull.comp.spv");
+
+        VkComputePipelineCreateInfo cp{};
+        cp.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        cp.pNext = nullptr;
+        cp.flags = 0;
+        cp.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        cp.stage.pNext = nullptr;
+        cp.stage.flags = 0;
+        cp.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        cp.stage.module = cs;
+        cp.stage.pName = "main";
+        cp.stage.pSpecializationInfo = nullptr;
+        cp.layout = bindless_pipeline_layout;
+        cp.basePipelineHandle = VK_NULL_HANDLE;
+        cp.basePipelineIndex = -1;
+
+        vk_check(vkCreateComputePipelines(device, pipeline_cache, 1, &cp, nullptr, &cull_pipeline),
+                 "vkCreateComputePipelines(cull)");
+
+        vkDestroyShaderModule(device, cs, nullptr);
+    }
+
+    // Swaps the live pipeline out for destruction once in-flight frames stop using it. The shared
+    // bindless_pipeline_layout lives as long as the heap.
+    void retire_pipeline(VkPipeline &live_pipeline) {
+        const VkPipeline pipeline = live_pipeline;
+        live_pipeline = VK_NULL_HANDLE;
+
+        retire([this, pipeline]() {
+            if (pipeline) {
+                vkDestroyPipeline(device, pipeline, nullptr);
+            }
+        });
+    }
+
+    void destroy_pipeline(VkPipeline &pipeline) {
+        if (pipeline) {
+            vkDestroyPipeline(device, pipeline, nullptr);
+            pipeline = VK_NULL_HANDLE;
+        }
+    }
+
+    // Where each new viewport starts. The first looks from k_default_eye; the others are presets
+    // at the same distance.
+    [[nodiscard]] static OrbitCamera initial_camera(std::uint32_t index) {
+        const float distance = glm::length(k_default_eye);
+        const OrbitCamera home{glm::degrees(std::atan2(k_default_eye.y, k_default_eye.x)),
+                               glm::degrees(std::asin(k_default_eye.z / distance)), distance};
+        switch (index) {
+            case 0u:
+                return home;
+            case 1u:
+                return {-90.0f, 8.0f, distance}; // front
+            case 2u:
+                return {0.0f, 8.0f, distance}; // side
+            case 3u:
+                return {-90.0f, 85.0f, distance}; // top
+            case 4u:
+                return {home.yaw_deg + 180.0f, home.pitch_deg, distance}; // three-quarter, from behind
+            default:
+                return {home.yaw_deg, -30.0f, distance}; // below
+        }
+    }
+
+    [[nodiscard]] glm::vec3 offscreen_eye(const OrbitCamera &cam) const {
+        // Pull the camera back far enough to see the whole instance grid.
+        const float grid_extent = static_cast<float>(instance_grid_side() - 1u) * k_instance_spacing;
+        const float zoom = 1.0f + 0.6f * grid_extent;
+        const float yaw = glm::radians(cam.yaw_deg);
+        const float pitch = glm::radians(cam.pitch_deg);
+        return glm::vec3(std::cos(pitch) * std::cos(yaw), std::cos(pitch) * std::sin(yaw), std::sin(pitch)) *
+               (cam.distance * zoom);
+    }
+
+    [[nodiscard]] bool use_mesh_shaders() const noexcept {
+        return mesh_shader_ext && mesh_shaders && !streamed_mesh();
+    }
+
+    [[nodiscard]] glm::mat4 offscreen_view_proj(const OrbitCamera &cam, const OffscreenFrame &f) const {
+        const glm::vec3 eye = offscreen_eye(cam);
+        const glm::vec3 at = glm::vec3(0.0f, 0.0f, 0.0f);
+        const glm::vec3 up = glm::vec3(0.0f, 0.0f, 1.0f);
+
+        const glm::mat4 V = glm::lookAt(eye, at, up);
+
+        const float aspect = (f.render_height > 0u)
+                                 ? (static_cast<float>(f.render_width) / static_cast<float>(f.render_height))
+                                 : 1.0f;
+        const float far_plane = std::max(100.0f, 4.0f * glm::length(eye));
+        glm::mat4 P = glm::perspectiveRH_ZO(glm::radians(60.0f), aspect, 0.1f, far_plane);
+
+        // Vulkan NDC Y is inverted relative to typical camera expectations.
+        P[1][1] *= -1.0f;
+
+        return P * V;
+    }
+
+    // Records one viewport's offscreen pass into a secondary command buffer. Runs on a worker
+    // thread: only touches `cb` and state that is read-only while recording.
+    void record_offscreen_secondary(VkCommandBuffer cb, const ViewDraw &view) const {
+        PBA_PROFILE_ZONE("record_offscreen_secondary");
+        VkCommandBufferInheritanceInfo inherit{};
+        inherit.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inherit.pNext = nullptr;
+        inherit.renderPass = offscreen_render_pass;
+        inherit.subpass = 0;
+        inherit.framebuffer = view.frame->framebuffer;
+        inherit.occlusionQueryEnable = VK_FALSE;
+        inherit.queryFlags = 0;
+        inherit.pipelineStatistics = 0;
+
+        VkCommandBufferBeginInfo bi{};
+        bi.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        bi.pNext = nullptr;
+        bi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        bi.pInheritanceInfo = &inherit;
+        vk_check(vkBeginCommandBuffer(cb, &bi), "vkBeginCommandBuffer(secondary)");
+        // Secondaries inherit no bindings.
+        bind_bindless_heap(cb, false);
+        record_offscreen_draws(cb, view);
+        vk_check(vkEndCommandBuffer(cb), "vkEndCommandBuffer(secondary)");
+    }
+
+    // Every draw of one viewport's offscreen pass, inside its render pass. Sets up the full
+    // pipeline state, since a secondary inherits none. With GPU culling the vertex path issues the
+    // viewport's single GPU-built indirect draw; the mesh path culls meshlets in cube.task.
+    void record_offscreen_draws(VkCommandBuffer cb, const ViewDraw &view) const {
+        const OffscreenFrame &f = *view.frame;
+        const bool culled = gpu_culling;
+        VkViewport vp{};
+        vp.x = 0.0f;
+        vp.y = 0.0f;
+        vp.width = static_cast<float>(f.render_width);
+        vp.height = static_cast<float>(f.render_height);
+        vp.minDepth = 0.0f;
+        vp.maxDepth = 1.0f;
+        vkCmdSetViewport(cb, 0, 1, &vp);
+
+        VkRect2D sc{};
+        sc.offset = VkOffset2D{0, 0};
+        sc.extent = VkExtent2D{f.render_width, f.render_height};
+        vkCmdSetScissor(cb, 0, 1, &sc);
+
+        if (use_mesh_shaders()) {
+            record_meshlet_draws(cb, view, culled);
+            return;
+        }
+
+        vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, cube_pipeline);
+
+        VkDeviceSize off = 0;
+        vkCmdBindVertexBuffers(cb, 0, 1, &cube_vbo, &off);
+        vkCmdBindIndexBuffer(cb, cube_ibo, 0, streamed_mesh() ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16);
+
+        const InstanceBuffer &ib = instance_buffers[frame_index];
+
+        CubePushConstants push{};
+        push.view_proj = view.view_proj;
+        push.culled = culled ? 1u : 0u;
+        push.instance_slot = ib.instance_slot;
+        push.visible_slot = view.cull->visible_slot;
+        push.material_slot = material_slot;
+        push.material_count = static_cast<std::uint32_t>(k_materials.size());
+        vkCmdPushConstants(cb, bindless_pipeline_layout, bindless_push_stages, 0,
+                           static_cast<std::uint32_t>(sizeof(push)), &push);
+
+        if (culled) {
+            constexpr auto k_stride = static_cast<std::uint32_t>(sizeof(VkDrawIndexedIndirectCommand));
+            const VkBuffer args = view.cull->draw_args;
+            if (draw_indirect_count) {
+                vkCmdDrawIndexedIndirectCount(cb, args, offsetof(IndirectArgs, cmd), args,
+                                              offsetof(IndirectArgs, draw_count), 1, k_stride);
+            } else {
+                vkCmdDrawIndexedIndirect(cb, args, offsetof(IndirectArgs, cmd), 1, k_stride);
+            }
+        } else {
+            vkCmdDrawIndexed(cb, draw_index_count(), static_cast<std::uint32_t>(instance_count), 0, 0, 0);
+        }
+    }
+
+    // One task workgroup per k_task_group_size items, split into draws the device must accept.
+    void record_meshlet_draws(VkCommandBuffer cb, const ViewDraw &view, bool culled) const {
+        vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, meshlet_pipeline);
+
+        MeshletPushConstants push{};
+        push.view_proj = view.view_proj;
+        push.eye = glm::vec4(view.eye, 1.0f);
+        push.item_end = static_cast<std::uint32_t>(instance_count) * meshlet_count;
+        push.meshlet_count = meshlet_count;
+        push.culled = culled ? 1u : 0u;
+        push.instance_slot = instance_buffers[frame_index].instance_slot;
+        push.vertex_slot = meshlet_slots[0];
+        push.meshlet_slot = meshlet_slots[1];
+        push.meshlet_vertex_slot = meshlet_slots[2];
+        push.meshlet_triangle_slot = meshlet_slots[3];
+        push.material_slot = material_slot;
+        push.material_count = static_cast<std::uint32_t>(k_materials.size());
+
+        constexpr std::uint32_t k_max_items = k_max_task_groups_per_draw * k_task_group_size;
+        for (std::uint32_t item = 0; item < push.item_end; item += k_max_items) {
+            push.first_item = item;
+            vkCmdPushConstants(cb, bindless_pipeline_layout, bindless_push_stages, 0,
+                               static_cast<std::uint32_t>(sizeof(push)), &push);
+            const std::uint32_t items = std::min(k_max_items, push.item_end - item);
+            draw_mesh_tasks(cb, (items + k_task_group_size - 1u) / k_task_group_size, 1, 1);
+        }
+    }
+
+    // Parallel recording is per viewport only. A viewport's pass is a handful of instanced or
+    // indirect draws whatever the instance count, so splitting one pass across threads would cost
+    // more than it recorded: with a single viewport the record threads stay unused.
+    [[nodiscard]] bool records_in_parallel(std::uint32_t views) const noexcept {
+        return views > 1u && record_threads > 1u;
+    }
+
+    // With several viewports drawn this frame, records each one's pass into its own secondary,
+    // all in one parallel_for; otherwise every pass is recorded inline. Runs once the frame graph
+    // is compiled and the framebuffers exist, before the passes executing them are recorded.
+    void record_offscreen(Frame &fr) {
+        PBA_PROFILE_ZONE("record_offscreen");
+        offscreen_secondaries = records_in_parallel(view_draw_count);
+        if (!offscreen_secondaries) {
+            return;
+        }
+        ensure_recorders(fr, view_draw_count);
+
+        // Grain 1: every viewport is recorded by exactly one task, so its recorder's pool needs no
+        // locking.
+        jobs->parallel_for(0, view_draw_count, 1, [&](std::uint32_t first_view, std::uint32_t last_view) {
+            for (std::uint32_t v = first_view; v < last_view; ++v) {
+                record_offscreen_secondary(fr.recorders[v].cmd, view_draws[v]);
+            }
+        });
+    }
+
+    // One viewport's render pass, around the secondary record_offscreen() left for it or with its
+    // draws recorded inline.
+    void execute_offscreen(const Frame &fr, const ViewDraw &view, std::uint32_t index) const {
+        const OffscreenFrame &f = *view.frame;
+        VkClearValue clears[2]{};
+        clears[0].color = VkClearColorValue{{0.18f, 0.18f, 0.18f, 1.0f}};
+        clears[1].depthStencil = VkClearDepthStencilValue{1.0f, 0};
+
+        VkRenderPassBeginInfo rp{};
+        rp.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        rp.pNext = nullptr;
+        rp.renderPass = offscreen_render_pass;
+        rp.framebuffer = f.framebuffer;
+        rp.renderArea.offset = VkOffset2D{0, 0};
+        rp.renderArea.extent = VkExtent2D{f.render_width, f.render_height};
+        rp.clearValueCount = 2;
+        rp.pClearValues = clears;
+
+        if (offscreen_secondaries) {
+            vkCmdBeginRenderPass(fr.cmd, &rp, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+            vkCmdExecuteCommands(fr.cmd, 1, &fr.recorders[index].cmd);
+        } else {
+            vkCmdBeginRenderPass(fr.cmd, &rp, VK_SUBPASS_CONTENTS_INLINE);
+            record_offscreen_draws(fr.cmd, view);
+        }
+        vkCmdEndRenderPass(fr.cmd);
+    }
+
+    void record_swapchain(VkCommandBuffer cb, VkFramebuffer fb) {
+        PBA_PROFILE_ZONE("record_swapchain");
+        VkClearValue clear{};
+        clear.color = VkClearColorValue{{0.10f, 0.10f, 0.10f, 1.0f}};
+
+        VkRenderPassBeginInfo rp{};
+        rp.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        rp.pNext = nullptr;
+        rp.renderPass = swapchain_render_pass;
+        rp.framebuffer = fb;
+        rp.renderArea.offset = VkOffset2D{0, 0};
+        rp.renderArea.extent = swapchain_extent;
+        rp.clearValueCount = 1;
+        rp.pClearValues = &clear;
+
+        vkCmdBeginRenderPass(cb, &rp, VK_SUBPASS_CONTENTS_INLINE);
+
+        ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cb);
+
+        vkCmdEndRenderPass(cb);
+    }
+
+    void destroy_readback(Frame &fr) {
+        if (fr.readback && fr.readback_alloc) {
+            vmaDestroyBuffer(allocator, fr.readback, fr.readback_alloc);
+        }
+        fr.readback = VK_NULL_HANDLE;
+        fr.readback_alloc = VK_NULL_HANDLE;
+        fr.readback_mapped = nullptr;
+        fr.readback_capacity = 0;
+        fr.readback_pending = false;
+    }
+
+    // Only called after the slot's timeline wait, so the old buffer can go immediately.
+    void ensure_readback_capacity(Frame &fr, VkDeviceSize size) {
+        if (fr.readback_capacity >= size) {
+            return;
+        }
+        destroy_readback(fr);
+
+        VkBufferCreateInfo bci{};
+        bci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bci.pNext = nullptr;
+        bci.flags = 0;
+        bci.size = size;
+        bci.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        bci.queueFamilyIndexCount = 0;
+        bci.pQueueFamilyIndices = nullptr;
+
+        // RANDOM access prefers HOST_CACHED memory; reading uncached memory is painfully slow.
+        VmaAllocationCreateInfo aci{};
+        aci.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        aci.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+        aci.requiredFlags = 0;
+        aci.preferredFlags = 0;
+        aci.memoryTypeBits = 0;
+        aci.pool = VK_NULL_HANDLE;
+        aci.pUserData = nullptr;
+        aci.priority = 0.0f;
+
+        VmaAllocationInfo alloc_info{};
+        vk_check(vmaCreateBuffer(allocator, &bci, &aci, &fr.readback, &fr.readback_alloc, &alloc_info),
+                 "vmaCreateBuffer(readback)");
+        fr.readback_mapped = static_cast<const std::uint8_t *>(alloc_info.pMappedData);
+        fr.readback_capacity = size;
+    }
+
+    // The graph has the color image in TRANSFER_SRC and orders the host read after the copy;
+    // ensure_readback_capacity() must have run for this frame's size.
+    void record_capture(Frame &fr, VkCommandBuffer cb, const OffscreenFrame &f) {
+        VkBufferImageCopy region{};
+        region.bufferOffset = 0;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = VkOffset3D{0, 0, 0};
+        // Only the rendered area; with dynamic resolution its size may change between frames.
+        region.imageExtent = VkExtent3D{f.render_width, f.render_height, 1u};
+        vkCmdCopyImageToBuffer(cb, f.color_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, fr.readback, 1, &region);
+
+        fr.readback_pending = true;
+        fr.readback_width = f.render_width;
+        fr.readback_height = f.render_height;
+        fr.readback_index = captured_frames++;
+    }
+
+    // Hands a completed readback to the writer thread; the render thread only pays for the
+    // memcpy into a recycled buffer.
+    void consume_capture(Frame &fr) {
+        if (!fr.readback_pending) {
+            return;
+        }
+        fr.readback_pending = false;
+
+        vk_check(vmaInvalidateAllocation(allocator, fr.readback_alloc, 0, VK_WHOLE_SIZE),
+                 "vmaInvalidateAllocation(readback)");
+
+        CapturedFrame cf{};
+        cf.index = fr.readback_index;
+        cf.width = fr.readback_width;
+        cf.height = fr.readback_height;
+        cf.rgba = frame_capture.take_buffer();
+        const std::size_t size = static_cast<std::size_t>(cf.width) * cf.height * 4u;
+        cf.rgba.assign(fr.readback_mapped, fr.readback_mapped + size);
+        frame_capture.submit(std::move(cf));
+    }
+
+    void start_capture() {
+        capture_error.clear();
+        try {
+            frame_capture.start(capture_session_dir(), capture_format);
+        } catch (const std::exception &e) {
+            capture_error = e.what();
+            return;
+        }
+        captured_frames = 0;
+        capturing = true;
+    }
+
+    // Once copies have stopped, the writer is joined as soon as no slot holds an unread frame.
+    void finish_capture_if_drained() {
+        if (capturing || !frame_capture.active()) {
+            return;
+        }
+        for (std::uint32_t i = 0; i < frames_in_flight; ++i) {
+            if (frames[i].readback_pending) {
+                return;
+            }
+        }
+        frame_capture.stop();
+    }
+
+    // Blocks until the slot's previous submission has completed and at most max_frame_latency
+    // frames will be queued once this one is submitted. A no-op when already satisfied, so the
+    // early pacing mode can call it ahead of begin_frame().
+    void pace_frame(const Frame &fr) {
+        PBA_PROFILE_ZONE("wait frame timeline");
+        const std::uint32_t latency = low_latency ? 1u : max_frame_latency;
+        const float waited = frame_pacer.wait(std::max(fr.serial, frame_pacer.latency_target(latency)));
+        frame_wait_ms += waited;
+        pacing_wait_ms += waited;
+    }
+
+    // Waits for the slot's previous submission, retires what it kept alive and refreshes the
+    // slot's per-frame data. Everything here is shared by the windowed and headless paths.
+    void begin_frame(Frame &fr) {
+        PBA_PROFILE_ZONE("begin_frame");
+        pace_frame(fr);
+        cpu_wait_ms.push(pacing_wait_ms);
+        if (cpu_wait_log) {
+            cpu_wait_log->push_back(pacing_wait_ms);
+        }
+        pacing_wait_ms = 0.0f;
+
+        completed_serial = frame_pacer.completed();
+        deletion_queue.flush(completed_serial);
+        evict_render_target_pools(false);
+        read_timestamps(fr, frame_index);
+        consume_capture(fr);
+        finish_capture_if_drained();
+        reclaim_uploads();
+        update_memory_stats();
+    }
+
+    [[nodiscard]] float scene_time() const noexcept {
+        const auto now = scene_paused ? paused_at : std::chrono::steady_clock::now();
+        return std::chrono::duration<float>(now - start_time).count();
+    }
+
+    void set_scene_paused(bool paused) noexcept {
+        if (paused == scene_paused) {
+            return;
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (paused) {
+            paused_at = now;
+        } else {
+            start_time += now - paused_at;
+        }
+        scene_paused = paused;
+    }
+
+    // Whether rendering the viewport's current slot (with its latched size) would produce
+    // something other than the image it showed last. Captures need every frame, so they always
+    // render.
+    [[nodiscard]] bool offscreen_needs_render(const Viewport &vp) const {
+        if (!on_demand_render || capturing || !vp.shown_valid) {
+            return true;
+        }
+        const OffscreenFrame &cur = vp.frames[frame_index];
+        const OffscreenFrame &shown = vp.frames[vp.shown];
+        if (shown.width != cur.width || shown.height != cur.height || shown.render_width != cur.render_width ||
+            shown.render_height != cur.render_height) {
+            return true;
+        }
+        return vp.shown_content.revision != scene_revision || vp.shown_content.time != scene_time() ||
+               vp.shown_content.view_proj != offscreen_view_proj(vp.camera, cur);
     }
 
-    void destroy_cube_pipeline() {
-        if (cube_pipeline) {
-            vkDestroyPipeline(device, cube_pipeline, nullptr);
-            cube_pipeline = VK_NULL_HANDLE;
+    // Low-latency mode, called before input is polled: waits until the newest frame has been
+    // presented (or, without present_wait, rendered), records how long its input took to get
+    // there, then optionally sleeps so the next frame starts as late as its predicted cost allows.
+    void wait_for_latest_frame() {
+        const std::uint64_t latest = frame_pacer.submitted();
+        bool presented = false;
+        if (present_wait_ext && latest != 0u && latest == last_present_id) {
+            PBA_PROFILE_ZONE("vkWaitForPresentKHR");
+            const auto begin = std::chrono::steady_clock::now();
+            const VkResult r = wait_for_present(device, swapchain, latest, k_present_wait_timeout_ns);
+            // A timeout (e.g. minimized window) or a stale swapchain just skips the sample.
+            if (r != VK_TIMEOUT && r != VK_SUBOPTIMAL_KHR && r != VK_ERROR_OUT_OF_DATE_KHR) {
+                vk_check(r, "vkWaitForPresentKHR");
+            }
+            presented = (r == VK_SUCCESS);
+            const float waited =
+                std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - begin).count();
+            frame_wait_ms += waited;
+            pacing_wait_ms += waited;
+        }
+        // With one frame queued this waits for `latest` itself; after a present it returns at once.
+        pace_frame(frames[frame_index]);
+
+        const auto done = std::chrono::steady_clock::now();
+        if (latest != 0u) {
+            const auto sampled = input_sample_times[latest % input_sample_times.size()];
+            input_latency_ms.push(std::chrono::duration<float, std::milli>(done - sampled).count());
+            latency_to_present = presented;
         }
-        if (cube_pipeline_layout) {
-            vkDestroyPipelineLayout(device, cube_pipeline_layout, nullptr);
-            cube_pipeline_layout = VK_NULL_HANDLE;
+
+        latency_sleep_ms = 0.0f;
+        if (latency_sleep && latency_target_hz > 0.0f) {
+            const float predicted = cpu_work_ms.percentile(0.9f) +
+                                    (timestamp_pool ? gpu_frame_ms.percentile(0.9f) : 0.0f) + k_latency_slack_ms;
+            const float budget = 1000.0f / latency_target_hz - predicted;
+            if (budget > 0.0f) {
+                PBA_PROFILE_ZONE("latency sleep");
+                latency_sleep_ms = budget;
+                std::this_thread::sleep_for(std::chrono::duration<float, std::milli>(budget));
+            }
         }
     }
 
-    void record_offscreen(VkCommandBuffer cb, const OffscreenFrame &f) {
-        VkClearValue clears[2]{};
-        clears[0].color = VkClearColorValue{{0.18f, 0.18f, 0.18f, 1.0f}};
-        clears[1].depthStencil = VkClearDepthStencilValue{1.0f, 0};
+    // Records the slot's primary command buffer. `image_index` is empty when headless, in which
+    // case the swapchain timestamps are written back to back so the GPU frame time still reads
+    // as offscreen work only.
+    void record_frame(Frame &fr, std::optional<std::uint32_t> image_index) {
+        PBA_PROFILE_ZONE("record_frame");
+        vk_check(vkResetCommandPool(device, fr.cmd_pool, 0), "vkResetCommandPool");
+        for (Recorder &r : fr.recorders) {
+            vk_check(vkResetCommandPool(device, r.pool, 0), "vkResetCommandPool(recorder)");
+        }
 
-        VkRenderPassBeginInfo rp{};
-        rp.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        rp.pNext = nullptr;
-        rp.renderPass = offscreen_render_pass;
-        rp.framebuffer = f.framebuffer;
-        rp.renderArea.offset = VkOffset2D{0, 0};
-        rp.renderArea.extent = VkExtent2D{f.width, f.height};
-        rp.clearValueCount = 2;
-        rp.pClearValues = clears;
+        VkCommandBufferBeginInfo bi{};
+        bi.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        bi.pNext = nullptr;
+        bi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        bi.pInheritanceInfo = nullptr;
+        vk_check(vkBeginCommandBuffer(fr.cmd, &bi), "vkBeginCommandBuffer");
 
-        vkCmdBeginRenderPass(cb, &rp, VK_SUBPASS_CONTENTS_INLINE);
+        if (timestamp_pool) {
+            vkCmdResetQueryPool(fr.cmd, timestamp_pool, frame_index * k_timestamps_per_frame, k_timestamps_per_frame);
+        }
 
-        VkViewport vp{};
-        vp.x = 0.0f;
-        vp.y = 0.0f;
-        vp.width = static_cast<float>(f.width);
-        vp.height = static_cast<float>(f.height);
-        vp.minDepth = 0.0f;
-        vp.maxDepth = 1.0f;
-        vkCmdSetViewport(cb, 0, 1, &vp);
+        // Anything uploaded since the last frame must land before this frame reads it. The
+        // queue family acquires stay outside the graph, which only tracks this queue.
+        submit_uploads();
+        record_upload_acquires(fr.cmd);
+
+        fr.offscreen_rendered = render_offscreen;
+        if (render_offscreen) {
+            // Sampled as late as possible, right before the instances are written, so what is
+            // drawn is as close as it can be to when it reaches the screen. Every viewport that
+            // renders draws the same instances.
+            const float t = scene_time();
+            update_instances(instance_buffers[frame_index], t);
+
+            for (std::uint32_t v = 0; v < viewport_count; ++v) {
+                Viewport &vp = viewports[v];
+                if (vp.render) {
+                    vp.shown = frame_index;
+                    vp.shown_valid = true;
+                    vp.shown_content =
+                        OffscreenContent{scene_revision, t, offscreen_view_proj(vp.camera, vp.frames[frame_index])};
+                }
+            }
+        } else {
+            ++reused_offscreen_frames;
+        }
 
-        VkRect2D sc{};
-        sc.offset = VkOffset2D{0, 0};
-        sc.extent = VkExtent2D{f.width, f.height};
-        vkCmdSetScissor(cb, 0, 1, &sc);
+        RenderGraph &g = render_graphs[frame_index];
+        {
+            PBA_PROFILE_ZONE("render graph compile");
+            build_frame_graph(g, fr, image_index);
+            g.compile();
+        }
 
-        vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, cube_pipeline);
+        if (render_offscreen) {
+            for (std::uint32_t v = 0; v < view_draw_count; ++v) {
+                ViewDraw &view = view_draws[v];
+                ensure_offscreen_framebuffer(*view.frame,
+                                             view.msaa_color.valid() ? g.image_view(view.msaa_color) : VK_NULL_HANDLE,
+                                             g.image_view(view.depth), g.transient_generation());
+            }
+            record_offscreen(fr);
+        }
+        // Covers the cull dispatch and inline offscreen draws; only the ImGui pass binds another layout.
+        bind_bindless_heap(fr.cmd, true);
+        g.execute(fr.cmd);
 
-        VkDeviceSize off = 0;
-        vkCmdBindVertexBuffers(cb, 0, 1, &cube_vbo, &off);
+        vk_check(vkEndCommandBuffer(fr.cmd), "vkEndCommandBuffer");
+    }
 
-        const auto now = std::chrono::steady_clock::now();
-        const float t = std::chrono::duration<float>(now - start_time).count();
+    // Declares the frame: instance copy -> per-viewport cull -> per-viewport offscreen -> capture
+    // -> ImGui/swapchain. Every barrier and layout transition between them is derived by the
+    // graph. A viewport that is not rendered this frame only has the image it rendered last
+    // sampled.
+    void build_frame_graph(RenderGraph &g, Frame &fr, std::optional<std::uint32_t> image_index) {
+        g.reset();
+        view_draw_count = 0;
+
+        const bool presenting = image_index.has_value();
+        // A windowed frame always leaves its color images in SHADER_READ_ONLY for the ImGui pass.
+        // Later frames from other slots may sample them again, so the next write has to wait for
+        // those reads as well, not only for this slot's previous frame.
+        const RgState displayed{VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        std::array<RgResource, k_max_viewports> shown{};
+        for (std::uint32_t v = 0; v < viewport_count; ++v) {
+            const Viewport &vp = viewports[v];
+            const OffscreenFrame &shown_frame = vp.frames[vp.render ? frame_index : vp.shown];
+            shown[v] = g.import_image("offscreen color", shown_frame.color_image, VK_IMAGE_ASPECT_COLOR_BIT,
+                                      presenting ? displayed : RgState{});
+        }
 
-        const glm::mat4 M =
-            glm::rotate(glm::mat4(1.0f), t, glm::vec3(0.0f, 0.0f, 1.0f)) *
-            glm::rotate(glm::mat4(1.0f), 0.6f * t, glm::vec3(0.0f, 1.0f, 0.0f));
+        g.add_pass("timestamp offscreen begin", {}, [this](VkCommandBuffer cb) {
+            write_timestamp(cb, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, k_ts_offscreen_begin);
+        });
 
-        const glm::vec3 eye = glm::vec3(2.4f, -3.2f, 1.8f);
-        const glm::vec3 at = glm::vec3(0.0f, 0.0f, 0.0f);
-        const glm::vec3 up = glm::vec3(0.0f, 0.0f, 1.0f);
+        if (render_offscreen) {
+            add_offscreen_passes(g, fr, shown);
+        }
 
-        const glm::mat4 V = glm::lookAt(eye, at, up);
+        g.add_pass("timestamp offscreen end", {}, [this, presenting](VkCommandBuffer cb) {
+            write_timestamp(cb, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, k_ts_offscreen_end);
+            write_timestamp(cb, presenting ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                            k_ts_swapchain_begin);
+        });
+
+        if (presenting) {
+            const std::uint32_t idx = *image_index;
+            // The submit waits for the acquire at COLOR_ATTACHMENT_OUTPUT; the image is presented
+            // from PRESENT_SRC and nothing after the pass touches it.
+            const RgResource backbuffer = g.import_image(
+                "swapchain", swapchain_images.at(idx), VK_IMAGE_ASPECT_COLOR_BIT,
+                {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED},
+                {VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR});
+            std::array<RgUse, k_max_viewports + 1u> imgui_uses{};
+            for (std::uint32_t v = 0; v < viewport_count; ++v) {
+                imgui_uses[v] = RgUse{shown[v], RgUsage::sampled_fragment};
+            }
+            imgui_uses[viewport_count] = RgUse{backbuffer, RgUsage::color_attachment, true};
+            g.add_pass("imgui", std::span<const RgUse>{imgui_uses.data(), viewport_count + 1u},
+                       [this, idx](VkCommandBuffer cb) { record_swapchain(cb, swapchain_framebuffers.at(idx)); });
+        }
 
-        const float aspect = (f.height > 0u)
-                                 ? (static_cast<float>(f.width) / static_cast<float>(f.height))
-                                 : 1.0f;
-        glm::mat4 P = glm::perspectiveRH_ZO(glm::radians(60.0f), aspect, 0.1f, 100.0f);
+        g.add_pass("timestamp swapchain end", {}, [this](VkCommandBuffer cb) {
+            write_timestamp(cb, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, k_ts_swapchain_end);
+        });
+    }
 
-        // Vulkan NDC Y is inverted relative to typical camera expectations.
-        P[1][1] *= -1.0f;
+    // Renders every viewport marked for rendering into its entry of `colors` and fills
+    // view_draws; only called when at least one is. The instances are copied once and shared;
+    // all cull passes run before the first render pass so the viewports do not serialize on
+    // compute -> graphics barriers.
+    void add_offscreen_passes(RenderGraph &g, Frame &fr, const std::array<RgResource, k_max_viewports> &colors) {
+        InstanceBuffer &ib = instance_buffers[frame_index];
+
+        // Everything below starts after this slot's timeline wait, so the slot's own resources
+        // carry no hazards in from earlier frames.
+        const RgResource instances = g.import_buffer("instances", ib.buffer);
+        if (ib.staging) {
+            const RgResource staging = g.import_buffer("instance staging", ib.staging);
+            g.add_pass("instance copy",
+                       {{staging, RgUsage::transfer_read}, {instances, RgUsage::transfer_write}},
+                       [this, &ib](VkCommandBuffer cb) { record_instance_copy(cb, ib); });
+        }
 
-        const glm::mat4 MVP = P * V * M;
+        std::array<std::uint32_t, k_max_viewports> view_viewport{};
+        for (std::uint32_t v = 0; v < viewport_count; ++v) {
+            Viewport &vp = viewports[v];
+            if (!vp.render) {
+                continue;
+            }
+            OffscreenFrame &off = vp.frames[frame_index];
+            view_viewport[view_draw_count] = v;
+            ViewDraw &view = view_draws[view_draw_count++];
+            view = ViewDraw{};
+            view.frame = &off;
+            view.cull = &ib.culls[v];
+            view.view_proj = offscreen_view_proj(vp.camera, off);
+            view.eye = offscreen_eye(vp.camera);
+            // Each viewport's attachments only live within its own pass, so the graph aliases
+            // them with the other viewports' instead of allocating them per viewport.
+            view.depth = g.create_image("offscreen depth", offscreen_depth_desc(off));
+            // Without MSAA the pass draws straight into color; with it, color is the resolve target.
+            view.msaa_color = (offscreen_samples != VK_SAMPLE_COUNT_1_BIT)
+                                  ? g.create_image("offscreen msaa color", offscreen_msaa_color_desc(off))
+                                  : RgResource{};
+        }
 
-        vkCmdPushConstants(cb, cube_pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT, 0,
-                           static_cast<std::uint32_t>(sizeof(glm::mat4)), &MVP);
+        // The mesh path culls per meshlet in cube.task, so only the vertex path has a cull pass.
+        const bool mesh = use_mesh_shaders();
+        const bool cull_pass = gpu_culling && !mesh;
+        std::array<RgResource, k_max_viewports> visible{};
+        std::array<RgResource, k_max_viewports> draw_args{};
+        if (cull_pass) {
+            for (std::uint32_t i = 0; i < view_draw_count; ++i) {
+                const CullOutput &c = *view_draws[i].cull;
+                visible[i] = g.import_buffer("visible", c.visible);
+                draw_args[i] = g.import_buffer("draw args", c.draw_args);
+                g.add_pass("cull reset", {{draw_args[i], RgUsage::transfer_write}},
+                           [this, &c](VkCommandBuffer cb) { record_cull_reset(cb, c); });
+            }
+            for (std::uint32_t i = 0; i < view_draw_count; ++i) {
+                const ViewDraw &view = view_draws[i];
+                g.add_pass("cull",
+                           {{instances, RgUsage::storage_read_compute},
+                            {visible[i], RgUsage::storage_write_compute},
+                            {draw_args[i], RgUsage::storage_write_compute}},
+                           [this, &ib, &view](VkCommandBuffer cb) { record_cull(cb, ib, *view.cull, view.view_proj); });
+            }
+        }
 
-        vkCmdDraw(cb, static_cast<std::uint32_t>(k_cube_vertices.size()), 1, 0, 0);
+        for (std::uint32_t i = 0; i < view_draw_count; ++i) {
+            const ViewDraw &view = view_draws[i];
+            const std::uint32_t v = view_viewport[i];
+
+            // The render pass clears or resolves over every attachment, so their previous
+            // contents are discarded.
+            std::array<RgUse, 6> offscreen_uses{};
+            std::size_t offscreen_use_count = 0;
+            const auto use = [&](RgResource r, RgUsage usage, bool discard) {
+                offscreen_uses[offscreen_use_count++] = RgUse{r, usage, discard};
+            };
+            use(instances, mesh ? RgUsage::storage_read_mesh : RgUsage::storage_read_vertex, false);
+            if (cull_pass) {
+                use(visible[i], RgUsage::storage_read_vertex, false);
+                use(draw_args[i], RgUsage::indirect_read, false);
+            }
+            use(colors[v], RgUsage::color_attachment, true);
+            if (view.msaa_color.valid()) {
+                use(view.msaa_color, RgUsage::color_attachment, true);
+            }
+            use(view.depth, RgUsage::depth_attachment, true);
+            g.add_pass(k_viewport_passes[v], std::span<const RgUse>{offscreen_uses.data(), offscreen_use_count},
+                       [this, &fr, &view, i](VkCommandBuffer) { execute_offscreen(fr, view, i); });
+        }
 
-        vkCmdEndRenderPass(cb);
+        // Captures record the first viewport, which always renders while capturing.
+        if (capturing && viewports[0].render) {
+            const OffscreenFrame &off = viewports[0].frames[frame_index];
+            // offscreen_color_format is RGBA8, so rows are tightly packed at 4 bytes per texel.
+            ensure_readback_capacity(fr, VkDeviceSize{off.width} * off.height * 4u);
+            const RgResource readback = g.import_buffer("readback", fr.readback, {},
+                                                        {VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT,
+                                                         VK_IMAGE_LAYOUT_UNDEFINED});
+            g.add_pass("capture", {{colors[0], RgUsage::transfer_read}, {readback, RgUsage::transfer_write}},
+                       [this, &fr, &off](VkCommandBuffer cb) { record_capture(fr, cb, off); });
+        }
     }
 
-    void record_swapchain(VkCommandBuffer cb, VkFramebuffer fb) {
-        VkClearValue clear{};
-        clear.color = VkClearColorValue{{0.10f, 0.10f, 0.10f, 1.0f}};
+    // With `presenting`, waits for the acquired image and signals render_complete for present.
+    void submit_frame(Frame &fr, bool presenting) {
+        const bool wait_uploads = upload_timeline_value > upload_value_waited;
+
+        std::array<VkSemaphore, 2> wait_sems{};
+        std::array<VkPipelineStageFlags, 2> wait_stages{};
+        std::array<std::uint64_t, 2> wait_values{};
+        std::uint32_t wait_count = 0;
+        if (presenting) {
+            wait_sems[wait_count] = fr.image_acquired;
+            wait_stages[wait_count] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            wait_values[wait_count] = 0; // binary; ignored
+            ++wait_count;
+        }
+        if (wait_uploads) {
+            wait_sems[wait_count] = upload_timeline;
+            wait_stages[wait_count] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            wait_values[wait_count] = upload_timeline_value;
+            ++wait_count;
+        }
 
-        VkRenderPassBeginInfo rp{};
-        rp.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        rp.pNext = nullptr;
-        rp.renderPass = swapchain_render_pass;
-        rp.framebuffer = fb;
-        rp.renderArea.offset = VkOffset2D{0, 0};
-        rp.renderArea.extent = swapchain_extent;
-        rp.clearValueCount = 1;
-        rp.pClearValues = &clear;
+        // The frame timeline is always signaled; render_complete only when presenting.
+        const std::uint64_t serial = frame_pacer.next_signal();
+        const std::array<VkSemaphore, 2> signal_sems = {frame_pacer.semaphore(), fr.render_complete};
+        const std::array<std::uint64_t, 2> signal_values = {serial, 0}; // render_complete is binary
+        const std::uint32_t signal_count = presenting ? 2u : 1u;
 
-        vkCmdBeginRenderPass(cb, &rp, VK_SUBPASS_CONTENTS_INLINE);
+        VkTimelineSemaphoreSubmitInfo ts{};
+        ts.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        ts.pNext = nullptr;
+        ts.waitSemaphoreValueCount = wait_count;
+        ts.pWaitSemaphoreValues = wait_values.data();
+        ts.signalSemaphoreValueCount = signal_count;
+        ts.pSignalSemaphoreValues = signal_values.data();
 
-        ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cb);
+        VkSubmitInfo si{};
+        si.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        si.pNext = &ts;
+        si.waitSemaphoreCount = wait_count;
+        si.pWaitSemaphores = wait_sems.data();
+        si.pWaitDstStageMask = wait_stages.data();
+        si.commandBufferCount = 1;
+        si.pCommandBuffers = &fr.cmd;
+        si.signalSemaphoreCount = signal_count;
+        si.pSignalSemaphores = signal_sems.data();
 
-        vkCmdEndRenderPass(cb);
+        fr.submit_ns = profiler::now_ns();
+        {
+            PBA_PROFILE_ZONE("vkQueueSubmit");
+            vk_check(vkQueueSubmit(graphics_queue, 1, &si, VK_NULL_HANDLE), "vkQueueSubmit");
+        }
+        fr.serial = serial;
+        upload_value_waited = upload_timeline_value;
+        fr.timestamps_pending = (timestamp_pool != VK_NULL_HANDLE);
     }
 
     void draw_frame() {
+        PBA_PROFILE_ZONE("draw_frame");
         Frame &fr = frames[frame_index];
 
-        vk_check(vkWaitForFences(device, 1, &fr.in_flight, VK_TRUE, UINT64_MAX),
-                 "vkWaitForFences");
-        vk_check(vkResetFences(device, 1, &fr.in_flight), "vkResetFences");
+        begin_frame(fr);
 
+        const auto acquire_begin = std::chrono::steady_clock::now();
         std::uint32_t image_index = 0;
-        VkResult acquire = vkAcquireNextImageKHR(
-            device, swapchain, UINT64_MAX, fr.image_acquired, VK_NULL_HANDLE, &image_index);
+        VkResult acquire{VK_SUCCESS};
+        {
+            PBA_PROFILE_ZONE("vkAcquireNextImageKHR");
+            acquire = vkAcquireNextImageKHR(device, swapchain, UINT64_MAX, fr.image_acquired, VK_NULL_HANDLE,
+                                            &image_index);
+        }
+        frame_wait_ms +=
+            std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - acquire_begin).count();
 
         if (acquire == VK_ERROR_OUT_OF_DATE_KHR) {
             recreate_swapchain();
@@ -1658,39 +4675,19 @@ struct VulkanMvp::Impl final {
             vk_check(acquire, "vkAcquireNextImageKHR");
         }
 
-        vk_check(vkResetCommandBuffer(fr.cmd, 0), "vkResetCommandBuffer");
-
-        VkCommandBufferBeginInfo bi{};
-        bi.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        bi.pNext = nullptr;
-        bi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-        bi.pInheritanceInfo = nullptr;
-        vk_check(vkBeginCommandBuffer(fr.cmd, &bi), "vkBeginCommandBuffer");
-
-        record_offscreen(fr.cmd, offscreen[frame_index]);
-        record_swapchain(fr.cmd, swapchain_framebuffers.at(image_index));
-
-        vk_check(vkEndCommandBuffer(fr.cmd), "vkEndCommandBuffer");
-
-        VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-
-        VkSubmitInfo si{};
-        si.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        si.pNext = nullptr;
-        si.waitSemaphoreCount = 1;
-        si.pWaitSemaphores = &fr.image_acquired;
-        si.pWaitDstStageMask = &wait_stage;
-        si.commandBufferCount = 1;
-        si.pCommandBuffers = &fr.cmd;
-        si.signalSemaphoreCount = 1;
-        si.pSignalSemaphores = &fr.render_complete;
-
-        vk_check(vkQueueSubmit(graphics_queue, 1, &si, fr.in_flight),
-                 "vkQueueSubmit");
+        record_frame(fr, image_index);
+        submit_frame(fr, true);
 
         VkPresentInfoKHR pi{};
+        // Frame serials only grow, so they double as present ids for vkWaitForPresentKHR.
+        VkPresentIdKHR present_id{};
+        present_id.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+        present_id.pNext = nullptr;
+        present_id.swapchainCount = 1;
+        present_id.pPresentIds = &fr.serial;
+
         pi.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-        pi.pNext = nullptr;
+        pi.pNext = present_wait_ext ? &present_id : nullptr;
         pi.waitSemaphoreCount = 1;
         pi.pWaitSemaphores = &fr.render_complete;
         pi.swapchainCount = 1;
@@ -1698,20 +4695,63 @@ struct VulkanMvp::Impl final {
         pi.pImageIndices = &image_index;
         pi.pResults = nullptr;
 
-        VkResult present = vkQueuePresentKHR(graphics_queue, &pi);
-        if (present == VK_ERROR_OUT_OF_DATE_KHR || present == VK_SUBOPTIMAL_KHR || framebuffer_resized) {
+        VkResult present{VK_SUCCESS};
+        {
+            PBA_PROFILE_ZONE("vkQueuePresentKHR");
+            present = vkQueuePresentKHR(graphics_queue, &pi);
+        }
+        if (present_wait_ext) {
+            last_present_id = fr.serial;
+        }
+        if (present == VK_ERROR_OUT_OF_DATE_KHR || present == VK_SUBOPTIMAL_KHR || framebuffer_resized ||
+            present_policy_changed) {
+            present_policy_changed = false;
             recreate_swapchain();
         } else {
             vk_check(present, "vkQueuePresentKHR");
         }
 
-        frame_index = (frame_index + 1u) % k_frames_in_flight;
+        if (!first_frame_logged) {
+            first_frame_logged = true;
+            const double first_frame_ms =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - launch_time).count();
+            std::fprintf(stderr, "[Vulkan] First frame presented %.1f ms after launch (init %.1f ms)\n",
+                         first_frame_ms, init_ms);
+        }
+
+        frame_index = (frame_index + 1u) % frames_in_flight;
     }
 
-    void build_ui() {
-        ImGui::DockSpaceOverViewport(0, ImGui::GetMainViewport(), ImGuiDockNodeFlags_PassthruCentralNode);
+    void draw_headless_frame() {
+        PBA_PROFILE_ZONE("draw_headless_frame");
+        Frame &fr = frames[frame_index];
+        frame_wait_ms = 0.0f;
+        begin_frame(fr);
+        for (std::uint32_t v = 0; v < viewport_count; ++v) {
+            latch_render_size(viewports[v].frames[frame_index]);
+            viewports[v].render = true;
+        }
+        render_offscreen = true;
+        record_frame(fr, std::nullopt);
+        submit_frame(fr, false);
+        frame_index = (frame_index + 1u) % frames_in_flight;
+    }
+
+    static void draw_timing_plot(const char *label, const RollingStats &stats) {
+        char overlay[96];
+        std::snprintf(overlay, sizeof(overlay), "min %.2f  avg %.2f  p99 %.2f ms",
+                      static_cast<double>(stats.min()), static_cast<double>(stats.avg()),
+                      static_cast<double>(stats.percentile(0.99f)));
+        ImGui::PlotLines(label, stats.data(), stats.plot_count(), stats.plot_offset(), overlay,
+                         0.0f, FLT_MAX, ImVec2(0.0f, 48.0f));
+    }
 
-        ImGui::Begin("Viewport", nullptr,
+    // One viewport window: resizes the viewport's images to it, decides whether the viewport
+    // renders this frame and shows its image. Dragging inside it orbits the camera, the wheel
+    // zooms.
+    void build_viewport_ui(std::uint32_t index) {
+        Viewport &vp = viewports[index];
+        ImGui::Begin(k_viewport_windows[index], nullptr,
                      ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse);
 
         ImGuiIO &io = ImGui::GetIO();
@@ -1724,51 +4764,371 @@ struct VulkanMvp::Impl final {
         const std::uint32_t px_w = static_cast<std::uint32_t>(std::lround(px_w_f));
         const std::uint32_t px_h = static_cast<std::uint32_t>(std::lround(px_h_f));
 
-        OffscreenFrame &cur = offscreen[frame_index];
+        OffscreenFrame &cur = vp.frames[frame_index];
+
+        if (lazy_offscreen_resize) {
+            // Until this slot catches up, the stale image is simply stretched to the window.
+            if (offscreen_size_settled(vp, px_w, px_h) && (px_w != cur.width || px_h != cur.height)) {
+                resize_offscreen_frame(vp, frame_index, px_w, px_h);
+            }
+        } else if (px_w != cur.width || px_h != cur.height) {
+            recreate_offscreen(vp, px_w, px_h);
+        }
 
-        if (px_w != cur.width || px_h != cur.height) {
-            recreate_offscreen(px_w, px_h);
+        // An invisible button over the image takes the mouse, so dragging orbits the camera
+        // instead of moving the window. Applied before the render decision, so the camera change
+        // shows up this frame.
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        if (avail.x >= 1.0f && avail.y >= 1.0f) {
+            ImGui::InvisibleButton("##camera", avail);
+            if (ImGui::IsItemActive() && (io.MouseDelta.x != 0.0f || io.MouseDelta.y != 0.0f)) {
+                vp.camera.yaw_deg = std::remainder(vp.camera.yaw_deg - io.MouseDelta.x * k_orbit_deg_per_px, 360.0f);
+                vp.camera.pitch_deg = std::clamp(vp.camera.pitch_deg + io.MouseDelta.y * k_orbit_deg_per_px,
+                                                 -k_max_pitch_deg, k_max_pitch_deg);
+            }
+            if (ImGui::IsItemHovered() && io.MouseWheel != 0.0f) {
+                vp.camera.distance =
+                    std::clamp(vp.camera.distance * std::pow(k_wheel_zoom_step, io.MouseWheel), 0.5f, 20.0f);
+            }
         }
 
-        if (cur.imgui_texture_set != VK_NULL_HANDLE) {
-            ImGui::Image(
-                to_imgui_texture_id(cur.imgui_texture_set),
-                avail);
+        latch_render_size(cur);
+        vp.render = offscreen_needs_render(vp);
+        const OffscreenFrame &shown = vp.frames[vp.render ? frame_index : vp.shown];
+        if (shown.imgui_texture_set != VK_NULL_HANDLE) {
+            // Only the rendered area is shown. When it is scaled down, the half-texel inset keeps
+            // the bilinear upsample from blending in the stale texels just outside it.
+            const auto uv_max = [](std::uint32_t rendered, std::uint32_t full) {
+                const float inset = rendered < full ? 0.5f : 0.0f;
+                return (static_cast<float>(rendered) - inset) / static_cast<float>(full);
+            };
+            ImGui::GetWindowDrawList()->AddImage(
+                to_imgui_texture_id(shown.imgui_texture_set), origin, ImVec2(origin.x + avail.x, origin.y + avail.y),
+                ImVec2(0.0f, 0.0f),
+                ImVec2(uv_max(shown.render_width, shown.width), uv_max(shown.render_height, shown.height)));
         }
         ImGui::End();
+    }
+
+    void build_ui() {
+        PBA_PROFILE_ZONE("build_ui");
+        ImGui::DockSpaceOverViewport(0, ImGui::GetMainViewport(), ImGuiDockNodeFlags_PassthruCentralNode);
+
+        render_offscreen = false;
+        for (std::uint32_t v = 0; v < viewport_count; ++v) {
+            build_viewport_ui(v);
+            render_offscreen = render_offscreen || viewports[v].render;
+        }
 
         ImGui::Begin("Info");
-        ImGui::Text("Frame-in-flight: %u / %u", frame_index, k_frames_in_flight);
+        ImGui::Text("Frame-in-flight: %u / %u", frame_index, frames_in_flight);
+        ImGui::Text("Present mode: %s", present_mode_name(present_mode));
+        if (offscreen_secondaries) {
+            ImGui::Text("Offscreen recording: %u viewports in parallel secondaries", view_draw_count);
+        } else if (record_threads > 1u) {
+            ImGui::Text("Offscreen recording: inline (one viewport; %u record threads unused)", record_threads);
+        } else {
+            ImGui::Text("Offscreen recording: inline");
+        }
+        ImGui::BeginDisabled(!mesh_shader_ext || streamed_mesh());
+        if (ImGui::Checkbox("Mesh shaders", &mesh_shaders)) {
+            ++scene_revision;
+        }
+        ImGui::EndDisabled();
+        ImGui::SameLine();
+        if (streamed_mesh()) {
+            ImGui::TextUnformatted("(not used for streamed meshes)");
+        } else if (mesh_shader_ext) {
+            ImGui::Text("(%u meshlet%s/instance)", meshlet_count, meshlet_count == 1u ? "" : "s");
+        } else {
+            ImGui::TextUnformatted("(VK_EXT_mesh_shader unsupported)");
+        }
+        ImGui::Checkbox("GPU frustum culling", &gpu_culling);
+        if (gpu_culling) {
+            ImGui::SameLine();
+            ImGui::TextUnformatted(use_mesh_shaders()     ? "(per meshlet, frustum + cone)"
+                                   : draw_indirect_count ? "(indirect count)"
+                                                         : "(indirect)");
+        }
+        ImGui::Text("Shaders: %s", spirv_is_embedded() ? "embedded" : (asset_root() / "shaders").string().c_str());
+        ImGui::Text("Queue families: gfx %u, transfer %u%s, compute %u%s", graphics_queue_family,
+                    transfer_queue_family, transfer_queue_family == graphics_queue_family ? " (shared)" : "",
+                    compute_queue_family, compute_queue_family == graphics_queue_family ? " (shared)" : "");
+        ImGui::Text("Vertex format: %s (%zu B/vertex)", compact_vertices ? "snorm16/unorm8" : "float32",
+                    compact_vertices ? sizeof(CompactVertex) : sizeof(Vertex));
+        if (streamed_mesh()) {
+            constexpr double k_mib = 1024.0 * 1024.0;
+            ImGui::Text("Mesh: %s, %u triangles (%.1f / %.1f MiB streamed)", mesh_path.c_str(),
+                        draw_index_count() / 3u, static_cast<double>(mesh_streamer.streamed_bytes()) / k_mib,
+                        static_cast<double>(mesh_streamer.total_bytes()) / k_mib);
+        }
+        ImGui::Text("Bindless heap: %u / %u buffers, %u / %u images", bindless.live_buffers(),
+                    bindless.buffer_capacity(), bindless.live_images(), bindless.image_capacity());
+
+        constexpr std::array<PresentPolicy, 4> k_policies = {
+            PresentPolicy::low_latency, PresentPolicy::vsync,
+            PresentPolicy::adaptive_vsync, PresentPolicy::uncapped};
+        if (ImGui::BeginCombo("Present policy", to_string(present_policy))) {
+            for (PresentPolicy p : k_policies) {
+                if (ImGui::Selectable(to_string(p), p == present_policy) && p != present_policy) {
+                    present_policy = p;
+                    present_policy_changed = true;
+                }
+            }
+            ImGui::EndCombo();
+        }
+
+        ImGui::Checkbox("Low-latency mode", &low_latency);
+        if (low_latency) {
+            ImGui::SameLine();
+            ImGui::TextUnformatted(present_wait_ext ? "(present wait)" : "(frame timeline)");
+            ImGui::Checkbox("Sleep to deadline", &latency_sleep);
+            if (latency_sleep) {
+                ImGui::SliderFloat("Target rate (Hz)", &latency_target_hz, 30.0f, 360.0f, "%.0f");
+                ImGui::Text("Deadline sleep: %.2f ms", static_cast<double>(latency_sleep_ms));
+            }
+        }
+
+        ImGui::BeginDisabled(low_latency);
+        constexpr std::array<FramePacing, 2> k_pacings = {FramePacing::late, FramePacing::early};
+        if (ImGui::BeginCombo("Frame pacing", to_string(frame_pacing))) {
+            for (FramePacing p : k_pacings) {
+                if (ImGui::Selectable(to_string(p), p == frame_pacing)) {
+                    frame_pacing = p;
+                }
+            }
+            ImGui::EndCombo();
+        }
+        int latency = static_cast<int>(max_frame_latency);
+        if (ImGui::SliderInt("Max frame latency", &latency, 1, static_cast<int>(frames_in_flight))) {
+            max_frame_latency = static_cast<std::uint32_t>(std::clamp(latency, 1, static_cast<int>(frames_in_flight)));
+        }
+        ImGui::EndDisabled();
+        ImGui::Text("Frame timeline: submitted %llu, completed %llu",
+                    static_cast<unsigned long long>(frame_pacer.submitted()),
+                    static_cast<unsigned long long>(completed_serial));
         ImGui::Text("Swapchain: %ux%u (images=%zu)",
                     swapchain_extent.width, swapchain_extent.height, swapchain_images.size());
-        ImGui::Text("Offscreen: %ux%u",
-                    offscreen[frame_index].width, offscreen[frame_index].height);
+        int views = static_cast<int>(viewport_count);
+        if (ImGui::SliderInt("Viewports", &views, 1, static_cast<int>(k_max_viewports))) {
+            set_viewport_count(static_cast<std::uint32_t>(views));
+        }
+        for (std::uint32_t v = 0; v < viewport_count; ++v) {
+            const OffscreenFrame &f = viewports[v].frames[frame_index];
+            ImGui::Text("%s: %ux%u, rendering %ux%u%s", k_viewport_windows[v], f.width, f.height, f.render_width,
+                        f.render_height, viewports[v].render ? "" : " (idle)");
+        }
+        const auto idle_pools = std::count_if(render_target_pools.begin(), render_target_pools.end(),
+                                              [](const RenderTargetPool &p) { return p.live == 0u; });
+        ImGui::Text("Render target pools: %zu (%zu idle, %u px buckets), attachments %s", render_target_pools.size(),
+                    static_cast<std::size_t>(idle_pools), k_render_target_bucket,
+                    lazy_attachments ? "lazily allocated" : "transient");
+
+        constexpr std::array<VkSampleCountFlagBits, 4> k_sample_counts = {
+            VK_SAMPLE_COUNT_1_BIT, VK_SAMPLE_COUNT_2_BIT, VK_SAMPLE_COUNT_4_BIT, VK_SAMPLE_COUNT_8_BIT};
+        if (ImGui::BeginCombo("MSAA", sample_count_name(offscreen_samples))) {
+            for (VkSampleCountFlagBits s : k_sample_counts) {
+                if ((supported_offscreen_samples & s) != 0u &&
+                    ImGui::Selectable(sample_count_name(s), s == offscreen_samples)) {
+                    set_offscreen_samples(s);
+                }
+            }
+            ImGui::EndCombo();
+        }
+
+        bool dynamic_res = dynamic_resolution.enabled();
+        if (ImGui::Checkbox("Dynamic resolution", &dynamic_res)) {
+            dynamic_resolution.set_target_ms(dynamic_res ? dynamic_resolution_target_ms : 0.0f);
+        }
+        if (dynamic_res) {
+            if (ImGui::SliderFloat("GPU budget (ms)", &dynamic_resolution_target_ms, 1.0f, 33.0f, "%.1f")) {
+                dynamic_resolution.set_target_ms(dynamic_resolution_target_ms);
+            }
+            ImGui::Text("Render scale: %.2f (offscreen GPU %.2f ms smoothed)",
+                        static_cast<double>(dynamic_resolution.scale()),
+                        static_cast<double>(dynamic_resolution.smoothed_ms()));
+        }
+        const RenderGraph &graph = render_graphs[frame_index];
+        // The generation only moves when the transients are rebuilt, so it stays put across
+        // idle and rendered frames at a fixed size.
+        ImGui::Text("Render graph: %u passes, %u barriers, %u transient blocks (generation %llu)",
+                    graph.pass_count(), graph.barrier_count(), graph.transient_memory_blocks(),
+                    static_cast<unsigned long long>(graph.transient_generation()));
+        ImGui::Checkbox("Lazy offscreen resize", &lazy_offscreen_resize);
+        if (ImGui::SliderInt("Instances", &instance_count, 1, static_cast<int>(k_max_instances), "%d",
+                             ImGuiSliderFlags_Logarithmic)) {
+            ++scene_revision;
+        }
+
+        bool paused = scene_paused;
+        if (ImGui::Checkbox("Pause animation", &paused)) {
+            set_scene_paused(paused);
+        }
+        ImGui::SameLine();
+        ImGui::Checkbox("On-demand rendering", &on_demand_render);
+        ImGui::Text("Offscreen pass: %s (%llu frames reused)", render_offscreen ? "rendering" : "idle, reusing last image",
+                    static_cast<unsigned long long>(reused_offscreen_frames));
+
+        ImGui::SeparatorText("Capture");
+        constexpr std::array<CaptureFormat, 3> k_capture_formats = {CaptureFormat::png, CaptureFormat::y4m,
+                                                                    CaptureFormat::raw};
+        ImGui::BeginDisabled(frame_capture.active());
+        if (ImGui::BeginCombo("Format", to_string(capture_format))) {
+            for (CaptureFormat fmt : k_capture_formats) {
+                if (ImGui::Selectable(to_string(fmt), fmt == capture_format)) {
+                    capture_format = fmt;
+                }
+            }
+            ImGui::EndCombo();
+        }
+        ImGui::EndDisabled();
+        if (!frame_capture.active()) {
+            if (ImGui::Button("Start capture")) {
+                start_capture();
+            }
+        } else if (capturing) {
+            if (ImGui::Button("Stop capture")) {
+                capturing = false;
+            }
+        } else {
+            ImGui::TextUnformatted("Finishing capture...");
+        }
+        if (frame_capture.active() || frame_capture.written() > 0u) {
+            ImGui::Text("%llu written, %llu dropped, %llu failed",
+                        static_cast<unsigned long long>(frame_capture.written()),
+                        static_cast<unsigned long long>(frame_capture.dropped()),
+                        static_cast<unsigned long long>(frame_capture.failed()));
+            ImGui::TextUnformatted(frame_capture.directory().string().c_str());
+        }
+        if (!capture_error.empty()) {
+            ImGui::TextUnformatted(capture_error.c_str());
+        }
+
+        ImGui::SeparatorText("Profiler");
+        if constexpr (profiler::k_enabled) {
+            if (ImGui::Button("Save trace")) {
+                const std::filesystem::path path = trace_file_path();
+                trace_status = write_trace(path) ? path.string() : "Failed to write " + path.string();
+            }
+            ImGui::SameLine();
+            ImGui::TextUnformatted(get_calibrated_timestamps ? "(GPU clock calibrated)" : "(GPU anchored at submit)");
+            if (!trace_status.empty()) {
+                ImGui::TextUnformatted(trace_status.c_str());
+            }
+        } else {
+            ImGui::TextUnformatted("Built without PBA_PROFILER");
+        }
+        ImGui::Text("Debug labels: %s", cmd_begin_label ? "on" : "unavailable");
+
+        ImGui::SeparatorText("Memory");
+        draw_memory_panel();
+
+        ImGui::SeparatorText("Timing");
+        draw_timing_plot("CPU frame", cpu_frame_ms);
+        draw_timing_plot("CPU work", cpu_work_ms);
+        draw_timing_plot("CPU wait", cpu_wait_ms);
+        if (low_latency) {
+            draw_timing_plot(latency_to_present ? "Input->present" : "Input->GPU done", input_latency_ms);
+        }
+        if (timestamp_pool) {
+            draw_timing_plot("GPU frame", gpu_frame_ms);
+            draw_timing_plot("GPU offscreen", gpu_offscreen_ms);
+            draw_timing_plot("GPU ImGui", gpu_swapchain_ms);
+        } else {
+            ImGui::TextUnformatted("GPU timestamps unavailable");
+        }
         ImGui::End();
     }
 
-    void init_all() {
-        init_window();
+    void init_all(std::uint32_t offscreen_width = 1280u, std::uint32_t offscreen_height = 720u) {
+        profiler::set_thread_name("render");
+        PBA_PROFILE_ZONE("init_all");
+        if (!headless) {
+            init_window();
+        }
         create_instance();
-        create_surface();
+        if (!headless) {
+            create_surface();
+        }
         create_device();
         create_allocator();
-        create_command_pool();
-        create_swapchain();
+        for (RenderGraph &g : render_graphs) {
+            g.init(device, allocator);
+            g.set_debug_labels(cmd_begin_label, cmd_end_label);
+        }
+        create_pipeline_cache();
+        // Everything the startup pipelines are built against.
+        create_offscreen_render_pass_and_sampler();
+        create_bindless_heap();
+
+        std::vector<std::future<void>> startup_jobs = start_startup_jobs();
+
+        create_upload_context();
+        if (!headless) {
+            create_swapchain();
+        }
 
         create_sync_and_cmd_buffers();
+        create_timestamp_pool();
 
-        create_imgui_descriptor_pool();
-        init_imgui();
+        if (!headless) {
+            create_imgui_descriptor_pool();
+            init_imgui();
+        }
 
-        create_offscreen_render_pass_and_sampler();
-        for (OffscreenFrame &f : offscreen) {
-            create_offscreen_frame_resources(f, 1280u, 720u);
+        for (std::uint32_t v = 0; v < viewport_count; ++v) {
+            for (std::uint32_t i = 0; i < frames_in_flight; ++i) {
+                create_offscreen_frame_resources(viewports[v].frames[i], offscreen_width, offscreen_height);
+            }
         }
 
-        create_cube_pipeline();
-        create_cube_vertex_buffer();
+        // The first failed job rethrows here; the remaining futures block in their destructors
+        // until their jobs are done, so shutdown never races a job.
+        for (std::future<void> &job : startup_jobs) {
+            job.get();
+        }
+        if (!pipeline_cache_warm) {
+            pipeline_cache_writer = std::async(std::launch::async, [this]() { save_pipeline_cache(); });
+        }
+
+        create_cube_mesh_buffers();
+        if (mesh_shader_ext) {
+            create_meshlet_buffers(startup_meshlets);
+            startup_meshlets = MeshletMesh{};
+        }
+
+        if (capture_on_start) {
+            start_capture();
+            if (!capture_error.empty()) {
+                throw std::runtime_error(capture_error);
+            }
+        }
 
         start_time = std::chrono::steady_clock::now();
+        paused_at = start_time;
+        init_ms = std::chrono::duration<double, std::milli>(start_time - launch_time).count();
+    }
+
+    // SPIR-V loading, pipeline compilation and CPU-side asset loading, started once the device
+    // exists and run on their own threads while the main thread builds the swapchain, ImGui and
+    // the frame resources. GLFW and ImGui stay on the main thread and the staging ring is not
+    // thread-safe, so nothing here uploads. Each job writes only its own members, and the
+    // pipeline cache is internally synchronized, so the compiles share and fill it.
+    [[nodiscard]] std::vector<std::future<void>> start_startup_jobs() {
+        std::vector<std::future<void>> jobs{};
+        jobs.reserve(5);
+        const auto launch = [&jobs](auto job) { jobs.push_back(std::async(std::launch::async, std::move(job))); };
+
+        launch([this]() { create_cube_pipeline(); });
+        launch([this]() { create_cull_pipeline(); });
+        if (mesh_shader_ext) {
+            launch([this]() { create_meshlet_pipeline(); });
+            launch([this]() { startup_meshlets = build_cube_meshlets(); });
+        }
+        if (streamed_mesh()) {
+            launch([this]() { open_streamed_mesh(); });
+        }
+        return jobs;
     }
 
     void shutdown_all() noexcept {
@@ -1777,9 +5137,40 @@ struct VulkanMvp::Impl final {
             vkDeviceWaitIdle(device);
         }
 
+        if (!trace_path.empty()) {
+            write_trace(trace_path);
+        }
+
+        if (device && allocator) {
+            deletion_queue.flush_all();
+        }
+
+        // The device is idle, so every outstanding readback is complete.
+        capturing = false;
+        if (device && allocator) {
+            for (std::uint32_t i = 0; i < frames_in_flight; ++i) {
+                try {
+                    consume_capture(frames[i]);
+                } catch (...) {
+                }
+            }
+        }
+        frame_capture.stop();
+
         if (device && allocator) {
-            destroy_cube_vertex_buffer();
-            destroy_cube_pipeline();
+            destroy_meshlet_buffers();
+            destroy_pipeline(meshlet_pipeline);
+            destroy_cube_mesh_buffers();
+            destroy_pipeline(cull_pipeline);
+            destroy_pipeline(cube_pipeline);
+            for (InstanceBuffer &ib : instance_buffers) {
+                destroy_instance_buffer(ib);
+            }
+            if (bindless_pipeline_layout) {
+                vkDestroyPipelineLayout(device, bindless_pipeline_layout, nullptr);
+                bindless_pipeline_layout = VK_NULL_HANDLE;
+            }
+            bindless.destroy();
         }
 
         if (device && allocator) {
@@ -1792,27 +5183,44 @@ struct VulkanMvp::Impl final {
 
         if (device) {
             for (Frame &f : frames) {
-                if (f.in_flight) {
-                    vkDestroyFence(device, f.in_flight, nullptr);
-                }
                 if (f.render_complete) {
                     vkDestroySemaphore(device, f.render_complete, nullptr);
                 }
                 if (f.image_acquired) {
                     vkDestroySemaphore(device, f.image_acquired, nullptr);
                 }
-                f.in_flight = VK_NULL_HANDLE;
+                for (Recorder &r : f.recorders) {
+                    if (r.pool) {
+                        vkDestroyCommandPool(device, r.pool, nullptr);
+                    }
+                }
+                if (f.cmd_pool) {
+                    vkDestroyCommandPool(device, f.cmd_pool, nullptr);
+                }
+                if (allocator) {
+                    destroy_readback(f);
+                }
                 f.render_complete = VK_NULL_HANDLE;
                 f.image_acquired = VK_NULL_HANDLE;
+                f.cmd_pool = VK_NULL_HANDLE;
                 f.cmd = VK_NULL_HANDLE;
+                f.recorders.clear();
             }
+            frame_pacer.destroy();
 
-            if (cmd_pool) {
-                vkDestroyCommandPool(device, cmd_pool, nullptr);
-                cmd_pool = VK_NULL_HANDLE;
+            for (RenderGraph &g : render_graphs) {
+                g.destroy();
             }
+            destroy_timestamp_pool();
+            destroy_upload_context();
 
             destroy_swapchain_resources();
+
+            if (pipeline_cache_writer.valid()) {
+                pipeline_cache_writer.wait();
+            }
+            save_pipeline_cache();
+            destroy_pipeline_cache();
         }
 
         if (allocator) {
@@ -1842,20 +5250,141 @@ struct VulkanMvp::Impl final {
             glfwDestroyWindow(window);
             window = nullptr;
         }
-        glfwTerminate();
+        if (!headless) {
+            glfwTerminate();
+        }
+    }
+
+    // Reports the outcome on stderr and never throws, so shutdown_all() can call it too.
+    bool write_trace(const std::filesystem::path &path) noexcept {
+        try {
+            const std::string name = path.string();
+            if (!profiler::k_enabled) {
+                std::fprintf(stderr, "[Vulkan] Not writing %s: built without PBA_PROFILER\n", name.c_str());
+                return false;
+            }
+            const bool written = profiler::write_chrome_trace(path);
+            std::fprintf(stderr, written ? "[Vulkan] Trace written to %s\n" : "[Vulkan] Failed to write trace %s\n",
+                         name.c_str());
+            return written;
+        } catch (...) {
+            return false;
+        }
+    }
+
+    BenchmarkResult run_benchmark(const BenchmarkConfig &config) {
+        if (config.frame_count == 0u && config.duration_s <= 0.0) {
+            throw std::runtime_error("Benchmark needs a frame count or a duration");
+        }
+        if (config.width == 0u || config.height == 0u) {
+            throw std::runtime_error("Benchmark resolution must be non-zero");
+        }
+
+        headless = true;
+        init_all(config.width, config.height);
+        // Measure the whole mesh, not however much of it has streamed in.
+        while (mesh_file.is_open()) {
+            stream_mesh();
+        }
+
+        instance_count = static_cast<int>(std::clamp(config.instance_count, 1u, k_max_instances));
+        gpu_culling = config.gpu_culling;
+
+        for (std::uint32_t i = 0; i < config.warmup_frames; ++i) {
+            draw_headless_frame();
+        }
+
+        // Drain the warm-up frames' timestamps so every logged GPU sample is a measured frame.
+        vk_check(vkDeviceWaitIdle(device), "vkDeviceWaitIdle");
+        for (std::uint32_t i = 0; i < frames_in_flight; ++i) {
+            read_timestamps(frames[i], i);
+        }
+
+        BenchmarkResult result{};
+        result.device_name = device_name;
+        result.viewports = viewport_count;
+        result.parallel_recording = records_in_parallel(viewport_count);
+        result.mesh_shaders = use_mesh_shaders();
+        const std::size_t expected = config.frame_count != 0u ? config.frame_count : 1024u;
+        result.cpu_frame_ms.reserve(expected);
+        result.gpu_frame_ms.reserve(expected);
+        result.cpu_wait_ms.reserve(expected);
+        gpu_frame_log = &result.gpu_frame_ms;
+        cpu_wait_log = &result.cpu_wait_ms;
+
+        const auto begin = std::chrono::steady_clock::now();
+        auto last = begin;
+        for (;;) {
+            draw_headless_frame();
+            ++result.frames;
+
+            const auto now = std::chrono::steady_clock::now();
+            result.cpu_frame_ms.push_back(std::chrono::duration<float, std::milli>(now - last).count());
+            last = now;
+
+            const double elapsed = std::chrono::duration<double>(now - begin).count();
+            if ((config.frame_count != 0u && result.frames >= config.frame_count) ||
+                (config.duration_s > 0.0 && elapsed >= config.duration_s)) {
+                break;
+            }
+        }
+
+        vk_check(vkDeviceWaitIdle(device), "vkDeviceWaitIdle");
+        result.elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        for (std::uint32_t i = 0; i < frames_in_flight; ++i) {
+            read_timestamps(frames[i], i);
+        }
+        gpu_frame_log = nullptr;
+        cpu_wait_log = nullptr;
+
+        return result;
     }
 
     void run_loop() {
+        last_frame_begin = std::chrono::steady_clock::now();
         while (window && glfwWindowShouldClose(window) == GLFW_FALSE) {
+            PBA_PROFILE_ZONE("run_loop");
+            const auto frame_begin = std::chrono::steady_clock::now();
+            const float interval_ms = std::chrono::duration<float, std::milli>(frame_begin - last_frame_begin).count();
+            last_frame_begin = frame_begin;
+            cpu_frame_ms.push(interval_ms);
+            // frame_wait_ms still holds the previous frame's pacing/acquire wait here.
+            cpu_work_ms.push(std::max(0.0f, interval_ms - frame_wait_ms));
+            frame_wait_ms = 0.0f;
+
+            // Early pacing blocks before input is sampled, so the UI reacts to the freshest
+            // input at the cost of CPU/GPU overlap; late pacing blocks in begin_frame().
+            if (low_latency) {
+                wait_for_latest_frame();
+            } else if (frame_pacing == FramePacing::early) {
+                pace_frame(frames[frame_index]);
+            }
+
+            // With nothing to render, sleep until input arrives; the timeout keeps the UI's
+            // own readouts ticking.
+            if (offscreen_idle) {
+                PBA_PROFILE_ZONE("wait for input");
+                const auto idle_begin = std::chrono::steady_clock::now();
+                glfwWaitEventsTimeout(k_idle_event_timeout_s);
+                frame_wait_ms +=
+                    std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - idle_begin).count();
+            }
+            input_sample_times[(frame_pacer.submitted() + 1u) % input_sample_times.size()] =
+                std::chrono::steady_clock::now();
             glfwPollEvents();
 
             ImGui_ImplVulkan_NewFrame();
             ImGui_ImplGlfw_NewFrame();
             ImGui::NewFrame();
 
+            stream_mesh();
             build_ui();
+            offscreen_idle = !render_offscreen;
 
-            ImGui::Render();
+            {
+                PBA_PROFILE_ZONE("ImGui::Render");
+                ImGui::Render();
+            }
 
             draw_frame();
         }
@@ -1866,7 +5395,7 @@ struct VulkanMvp::Impl final {
     }
 };
 
-VulkanMvp::VulkanMvp() : impl_{std::make_unique<Impl>()} {
+VulkanMvp::VulkanMvp(const VulkanMvpOptions &options) : impl_{std::make_unique<Impl>(options)} {
 }
 
 VulkanMvp::~VulkanMvp() {
@@ -1880,4 +5409,8 @@ void VulkanMvp::run() {
     impl_->run_loop();
 }
 
+BenchmarkResult VulkanMvp::run_benchmark(const BenchmarkConfig &config) {
+    return impl_->run_benchmark(config);
+}
+
 } // namespace ds_pba
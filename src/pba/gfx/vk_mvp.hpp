@@ -1,12 +1,116 @@
 #pragma once
 
+#include "pba/gfx/frame_capture.hpp"
+
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace ds_pba {
 
+// How create_swapchain() picks a VkPresentModeKHR. Each policy walks its own preference list
+// and ends on FIFO, which every implementation must support.
+enum class PresentPolicy : std::uint8_t {
+    low_latency,    // MAILBOX -> IMMEDIATE -> FIFO
+    vsync,          // FIFO
+    adaptive_vsync, // FIFO_RELAXED -> FIFO
+    uncapped,       // IMMEDIATE -> MAILBOX -> FIFO_RELAXED -> FIFO
+};
+
+[[nodiscard]] const char *to_string(PresentPolicy policy) noexcept;
+
+// Where the CPU blocks on the GPU's frame timeline each frame.
+enum class FramePacing : std::uint8_t {
+    late,  // after input, UI and simulation, right before the slot's GPU resources are reused
+    early, // before input is polled: fresher input, less CPU/GPU overlap
+};
+
+[[nodiscard]] const char *to_string(FramePacing pacing) noexcept;
+
+struct VulkanMvpOptions {
+    static constexpr std::uint32_t k_max_frames_in_flight = 3;
+    static constexpr std::uint32_t k_max_viewports = 6;
+
+    // 1 = lowest latency (CPU and GPU serialize), 3 = highest throughput.
+    std::uint32_t frames_in_flight{2};
+    PresentPolicy present_policy{PresentPolicy::low_latency};
+    FramePacing frame_pacing{FramePacing::late};
+    // Frames the GPU may have queued, in [1, frames_in_flight]; 0 = frames_in_flight.
+    std::uint32_t max_frame_latency{0};
+    // Waits for the newest frame's present (VK_KHR_present_wait) before polling input and keeps a
+    // single frame queued; overrides frame_pacing and max_frame_latency while on.
+    bool low_latency{false};
+
+    // snorm16 positions + unorm8 colors (12 B/vertex) instead of float3 + float3 (24 B/vertex).
+    bool compact_vertices{false};
+    // A .pbamesh (see mesh_import) drawn instead of the built-in cube. It is memory-mapped and
+    // streamed in over the first frames, so startup does not wait for it; forces float32 vertices
+    // and the vertex pipeline.
+    std::string mesh_path{};
+    // Draw through task/mesh shaders (VK_EXT_mesh_shader) with per-meshlet culling where the
+    // device supports them; otherwise, or when false, the vertex pipeline is used.
+    bool mesh_shaders{true};
+
+    // Skip the offscreen pass while nothing it draws has changed and wait for input instead of
+    // spinning; the animation keeps the scene changing unless it is paused.
+    bool on_demand_render{true};
+    bool start_paused{false};
+
+    // Offscreen MSAA sample count (1 = off); rounded down to what the device supports.
+    std::uint32_t msaa_samples{1};
+    // GPU budget for the offscreen pass in ms: above it the viewport renders at a reduced internal
+    // resolution and is scaled back up. 0 = always native resolution.
+    float dynamic_resolution_ms{0.0f};
+
+    // Threads recording the viewports' offscreen passes, one secondary command buffer per
+    // viewport (including the render thread); 1 records every pass inline. 0 = one per core.
+    // Only used with several viewports: a single viewport's pass is always recorded inline.
+    std::uint32_t record_threads{0};
+
+    // Independent camera views at startup, in [1, k_max_viewports]; the UI can add and remove
+    // them. They share the pipelines, meshes and instance data and are culled and drawn one after
+    // another in the same command buffer. A benchmark renders every view at its resolution.
+    std::uint32_t viewports{1};
+
+    // Start capturing the offscreen image from the first frame; the UI can also toggle it.
+    bool capture{false};
+    CaptureFormat capture_format{CaptureFormat::png};
+
+    // Chrome trace JSON of the profiler's CPU and GPU zones, written at exit; needs a build with
+    // PBA_PROFILER. The UI can also save one at any time.
+    std::string trace_path{};
+};
+
+// Headless run: no window, surface, swapchain or UI; only the offscreen pass is rendered.
+struct BenchmarkConfig {
+    std::uint32_t width{1920};
+    std::uint32_t height{1080};
+    std::uint32_t instance_count{100'000};
+    bool gpu_culling{true};
+
+    // Not measured; lets clocks, caches and the pipeline cache settle.
+    std::uint32_t warmup_frames{60};
+    // Measurement stops at whichever limit is hit first; 0 disables that limit.
+    std::uint32_t frame_count{1000};
+    double duration_s{0.0};
+};
+
+struct BenchmarkResult {
+    std::string device_name{};
+    bool mesh_shaders{false}; // drawn through the task/mesh shader path
+    std::uint32_t viewports{1};
+    bool parallel_recording{false}; // viewports recorded into secondaries on worker threads
+    std::uint32_t frames{0};
+    double elapsed_s{0.0};
+    std::vector<float> cpu_frame_ms{}; // time between consecutive frame starts
+    std::vector<float> gpu_frame_ms{}; // GPU timestamps around the offscreen work
+    std::vector<float> cpu_wait_ms{};  // time blocked on the frame timeline
+};
+
 class VulkanMvp final {
 public:
-    VulkanMvp();
+    explicit VulkanMvp(const VulkanMvpOptions &options = {});
     ~VulkanMvp();
 
     VulkanMvp(const VulkanMvp &) = delete;
@@ -14,6 +118,9 @@ public:
 
     void run();
 
+    // Mutually exclusive with run(); call at most one of them per instance.
+    [[nodiscard]] BenchmarkResult run_benchmark(const BenchmarkConfig &config);
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;